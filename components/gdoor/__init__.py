@@ -1,8 +1,11 @@
 import re
 import esphome.codegen as cg
 import esphome.config_validation as cv
-from esphome import pins
-from esphome.const import CONF_ID
+import esphome.final_validate as fv
+from esphome import automation, pins
+from esphome.automation import maybe_simple_id
+from esphome.const import CONF_ID, CONF_TRIGGER_ID
+from esphome.core import CORE, ID, TimePeriod
 from esphome.components.esp32 import include_builtin_idf_component
 
 # ---------------------------------------------------------------------------
@@ -53,6 +56,22 @@ def validate_gdoor_busdata(value):
 
 GDOOR_BUSDATA_VALIDATOR = validate_gdoor_busdata
 
+
+def frame_table(id_, entries):
+    """
+    Emit (hex frame, tag) pairs as one flash-resident static const byte array
+    in the GDoorFrameTable layout: {len, tag, bytes...} per entry, closed by 0.
+    Returns the expression to hand to the C++ setter.
+    """
+    table = []
+    for hex_string, tag in entries:
+        data = bytes.fromhex(hex_string)
+        if len(data) > 0xFF or not 0 <= tag <= 0xFF:
+            raise cv.Invalid(f"busdata '{hex_string}' does not fit the frame table")
+        table += [len(data), tag, *data]
+    table.append(0)
+    return cg.static_const_array(ID(id_, is_declaration=True, type=cg.uint8), table)
+
 CODEOWNERS = ["@dtill"]
 DOMAIN = "gdoor"
 DEPENDENCIES = []
@@ -61,18 +80,156 @@ MULTI_CONF = True
 gdoor_esphome_ns = cg.esphome_ns.namespace("gdoor_esphome")
 
 GdoorComponent = gdoor_esphome_ns.class_("GdoorComponent", cg.Component)
+GDoorFrame = gdoor_esphome_ns.struct("GDoorFrame")
+GDoorFrameTrigger = gdoor_esphome_ns.class_(
+    "GDoorFrameTrigger", automation.Trigger.template(GDoorFrame.operator("ref").operator("const"))
+)
+GDoorDumpDevicesAction = gdoor_esphome_ns.class_("GDoorDumpDevicesAction", automation.Action)
 
 CONF_TX_PIN = "tx_pin"
 CONF_TX_EN_PIN = "tx_en_pin"
 CONF_RX_PIN = "rx_pin"
 CONF_RX_THRESH_PIN = "rx_thresh_pin"
 CONF_RX_SENS = "rx_sens"
+CONF_DEDUPE_WINDOW = "dedupe_window"
+CONF_LEDC_CHANNEL = "ledc_channel"
+CONF_LEDC_TIMER = "ledc_timer"
+CONF_PROFILE_ISR = "profile_isr"
+CONF_TRACE_LATENCY = "trace_latency"
+CONF_RAW_CAPTURE = "raw_capture"
+CONF_MAX_WORDS = "max_words"
+CONF_ON_FRAME = "on_frame"
+CONF_FRAME_ACTION = "action"
+CONF_FRAME_TYPE = "type"
+CONF_FRAME_SOURCE = "source"
+CONF_FRAME_DESTINATION = "destination"
+CONF_FRAME_PARAMETERS = "parameters"
+CONF_FRAME_VALID = "valid"
+CONF_FRAME_NEW_DEVICE = "new_device"
+CONF_LEARN_DEVICES = "learn_devices"
+CONF_SESSION_TIMEOUT = "session_timeout"
+CONF_RULES = "rules"
+CONF_RULE_MATCH = "match"
+CONF_RULE_SEND = "send"
+CONF_RULE_DELAY = "delay"
+CONF_RULE_MAX_PER_MINUTE = "max_per_minute"
 
 DEFAULT_TX_PIN = 25
 DEFAULT_TX_EN_PIN = 27
 DEFAULT_RX_PIN = 22
 DEFAULT_RX_THRESH_PIN = 26
 
+# Every bus needs its own TX carrier LEDC channel/timer. LEDC_TIMER_0 stays
+# reserved for other components, so by default bus n gets channel n, timer n+1.
+LEDC_TIMERS = [1, 2, 3]
+
+# Frame capacity in bus words (data + CRC). Sizes every RX/TX/frame buffer;
+# the shortest known telegrams have 10 words.
+DEFAULT_MAX_WORDS = 25
+MIN_MAX_WORDS = 10
+MAX_MAX_WORDS = 128
+
+
+# Bus codes of the action (byte 2) and device type (byte 8) fields, same names
+# as GDOOR_DATA_ACTION / GDOOR_DATA_HWTYPE in gdoor_data.cpp
+FRAME_ACTIONS = {
+    "BUTTON": 0x42,
+    "BUTTON_LIGHT": 0x41,
+    "DOOR_OPEN": 0x31,
+    "VIDEO_REQUEST": 0x28,
+    "AUDIO_REQUEST": 0x21,
+    "AUDIO_VIDEO_END": 0x20,
+    "BUTTON_FLOOR": 0x13,
+    "CALL_INTERNAL": 0x12,
+    "BUTTON_RING": 0x11,
+    "CTRL_DOOROPENER_ACK": 0x0F,
+    "CTRL_RESET": 0x08,
+    "CTRL_DOORSTATION_ACK": 0x05,
+    "CTRL_BUTTONS_TRAINING_START": 0x04,
+    "CTRL_DOOROPENER_TRAINING_START": 0x03,
+    "CTRL_DOOROPENER_TRAINING_STOP": 0x02,
+    "CTRL_PROGRAMMING_START": 0x01,
+    "CTRL_PROGRAMMING_STOP": 0x00,
+}
+FRAME_TYPES = {
+    "OUTDOOR": 0xA0,
+    "INDOOR": 0xA1,
+    "INDOOR_RECEIVER": 0xA2,
+    "CONTROLLER": 0xA3,
+    "ACTUATOR": 0xA4,
+    "GATEWAY_TK": 0xA5,
+    "CHIME": 0xA6,
+    "BUTTON_IF": 0xA7,
+    "GATEWAY_IP": 0xA8,
+}
+
+
+def frame_code(names):
+    """Field filter: a name from the table or a raw byte value."""
+    def validator(value):
+        if isinstance(value, int):
+            return cv.hex_uint8_t(value)
+        value = cv.string_strict(value).upper()
+        if value not in names:
+            raise cv.Invalid(f"Unknown value '{value}', expected a byte or one of {', '.join(names)}")
+        return names[value]
+    return validator
+
+
+def frame_hex(digits):
+    """Field filter: hex string as in the JSON message (e.g. 'A286FD') or an int."""
+    def validator(value):
+        if not isinstance(value, int):
+            value = cv.string_strict(value)
+            if len(value) != digits or not _HEX_RE.match(value):
+                raise cv.Invalid(f"Expected {digits} hex digits, got '{value}'")
+            value = int(value, 16)
+        return cv.int_range(min=0, max=(1 << (4 * digits)) - 1)(value)
+    return validator
+
+
+FRAME_TRIGGER_SCHEMA = automation.validate_automation({
+    cv.GenerateID(CONF_TRIGGER_ID): cv.declare_id(GDoorFrameTrigger),
+    cv.Optional(CONF_FRAME_ACTION): frame_code(FRAME_ACTIONS),
+    cv.Optional(CONF_FRAME_TYPE): frame_code(FRAME_TYPES),
+    cv.Optional(CONF_FRAME_SOURCE): frame_hex(6),
+    cv.Optional(CONF_FRAME_DESTINATION): frame_hex(6),
+    cv.Optional(CONF_FRAME_PARAMETERS): frame_hex(4),
+    cv.Optional(CONF_FRAME_VALID): cv.boolean,
+    cv.Optional(CONF_FRAME_NEW_DEVICE): cv.boolean,
+})
+
+
+# Local rules: reply to a telegram on the device itself, see GDoorRuleEngine.
+# Rule index is the frame table tag, so at most 255 fit; keep it reasonable.
+MAX_RULES = 32
+RULE_SCHEMA = cv.Schema({
+    cv.Required(CONF_RULE_MATCH): GDOOR_BUSDATA_VALIDATOR,
+    cv.Required(CONF_RULE_SEND): GDOOR_BUSDATA_VALIDATOR,
+    cv.Optional(CONF_RULE_DELAY, default="0us"): cv.All(
+        cv.positive_time_period_microseconds, cv.Range(max=TimePeriod(seconds=10))
+    ),
+    cv.Optional(CONF_RULE_MAX_PER_MINUTE, default=1): cv.int_range(min=1, max=60),
+})
+
+
+def validate_learn_devices(cfg):
+    """The new_device filter needs the device registry."""
+    if not cfg[CONF_LEARN_DEVICES] and any(CONF_FRAME_NEW_DEVICE in conf for conf in cfg.get(CONF_ON_FRAME, [])):
+        raise cv.Invalid(f"on_frame '{CONF_FRAME_NEW_DEVICE}' needs '{CONF_LEARN_DEVICES}: true'")
+    return cfg
+
+
+def validate_rules(cfg):
+    """Reply telegrams must fit the TX buffer of this bus."""
+    for rule in cfg.get(CONF_RULES, []):
+        # The TX engine appends a CRC word, so a reply needs one slot less
+        if len(rule[CONF_RULE_SEND]) // 2 >= cfg[CONF_MAX_WORDS]:
+            raise cv.Invalid(
+                f"Rule reply '{rule[CONF_RULE_SEND]}' must be shorter than {CONF_MAX_WORDS} ({cfg[CONF_MAX_WORDS]})"
+            )
+    return cfg
+
 
 RX_SENS_MODES = {
     "low": 1.3,
@@ -80,12 +237,15 @@ RX_SENS_MODES = {
     "high": 1.65,
 }
 DEFAULT_RX_SENS_MODE = "high"
+# Closed-loop threshold calibration instead of a fixed preset (rx_pin 22 only)
+RX_SENS_AUTO = "auto"
 
 
 def validate_rx_sens_and_pin(cfg):
     """
     Enforces:
       - If the raw rx_pin is not 22, then if rx_sens is provided, it must be "high".
+        ("auto" is rejected there as well, the threshold is not adjustable.)
     """
     rx_pin_cfg = cfg.get(CONF_RX_PIN, DEFAULT_RX_PIN)
     if isinstance(rx_pin_cfg, dict):
@@ -106,11 +266,56 @@ CONFIG_SCHEMA = cv.All(
         cv.Optional(CONF_TX_EN_PIN, default=DEFAULT_TX_EN_PIN): pins.internal_gpio_output_pin_schema,
         cv.Optional(CONF_RX_PIN, default=DEFAULT_RX_PIN): pins.internal_gpio_input_pin_schema,
         cv.Optional(CONF_RX_THRESH_PIN, default=DEFAULT_RX_THRESH_PIN): pins.internal_gpio_output_pin_schema,
-        cv.Optional(CONF_RX_SENS, default=DEFAULT_RX_SENS_MODE): cv.enum(RX_SENS_MODES, upper=False),
+        cv.Optional(CONF_RX_SENS, default=DEFAULT_RX_SENS_MODE): cv.Any(
+            cv.one_of(RX_SENS_AUTO, lower=True), cv.enum(RX_SENS_MODES, upper=False)
+        ),
+        cv.Optional(CONF_DEDUPE_WINDOW, default="0ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_LEDC_CHANNEL): cv.int_range(min=0, max=7),
+        cv.Optional(CONF_LEDC_TIMER): cv.one_of(*LEDC_TIMERS, int=True),
+        cv.Optional(CONF_PROFILE_ISR, default=False): cv.boolean,
+        cv.Optional(CONF_TRACE_LATENCY, default=False): cv.boolean,
+        cv.Optional(CONF_RAW_CAPTURE, default=True): cv.boolean,
+        cv.Optional(CONF_MAX_WORDS, default=DEFAULT_MAX_WORDS): cv.int_range(min=MIN_MAX_WORDS, max=MAX_MAX_WORDS),
+        cv.Optional(CONF_ON_FRAME): FRAME_TRIGGER_SCHEMA,
+        cv.Optional(CONF_RULES): cv.All(cv.ensure_list(RULE_SCHEMA), cv.Length(min=1, max=MAX_RULES)),
+        cv.Optional(CONF_LEARN_DEVICES, default=False): cv.boolean,
+        cv.Optional(CONF_SESSION_TIMEOUT, default="120s"): cv.positive_time_period_milliseconds,
     }).extend(cv.COMPONENT_SCHEMA),
-    validate_rx_sens_and_pin
+    validate_rx_sens_and_pin,
+    validate_rules,
+    validate_learn_devices,
 )
 
+def ledc_for_bus(config, index):
+    """Per-bus LEDC channel/timer: explicit values win, otherwise by bus index."""
+    channel = config.get(CONF_LEDC_CHANNEL, index)
+    timer = config.get(CONF_LEDC_TIMER, LEDC_TIMERS[index % len(LEDC_TIMERS)])
+    return channel, timer
+
+
+def validate_bus_resources(config):
+    """Across all gdoor: blocks, no two buses may share an LEDC channel or timer,
+    and compile-time sizes must agree."""
+    buses = fv.full_config.get()[DOMAIN]
+    channels, timers = set(), set()
+    for index, bus in enumerate(buses):
+        channel, timer = ledc_for_bus(bus, index)
+        if channel in channels or timer in timers:
+            raise cv.Invalid(
+                f"gdoor bus #{index + 1} shares LEDC channel {channel} or timer {timer} "
+                f"with another bus, set '{CONF_LEDC_CHANNEL}'/'{CONF_LEDC_TIMER}' explicitly"
+            )
+        channels.add(channel)
+        timers.add(timer)
+    # Frame capacity is a compile-time size shared by all buses
+    if len({bus[CONF_MAX_WORDS] for bus in buses}) > 1:
+        raise cv.Invalid(f"All gdoor buses must use the same '{CONF_MAX_WORDS}'")
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = validate_bus_resources
+
+
 async def to_code(config):
     include_builtin_idf_component("esp_driver_dac")
     var = cg.new_Pvariable(config[CONF_ID])
@@ -123,5 +328,58 @@ async def to_code(config):
     cg.add(var.set_rx_pin(rx_pin))
     rx_thresh_pin = await cg.gpio_pin_expression(config[CONF_RX_THRESH_PIN])
     cg.add(var.set_rx_thresh_pin(rx_thresh_pin))
-    if CONF_RX_SENS in config:
+    if config.get(CONF_RX_SENS) == RX_SENS_AUTO:
+        cg.add(var.set_rx_auto_calibrate(True))
+    elif CONF_RX_SENS in config:
         cg.add(var.set_rx_sens(config[CONF_RX_SENS]))
+    cg.add(var.set_dedupe_window(config[CONF_DEDUPE_WINDOW]))
+    index = CORE.data.setdefault(DOMAIN, {}).get("bus_count", 0)
+    CORE.data[DOMAIN]["bus_count"] = index + 1
+    ledc_channel, ledc_timer = ledc_for_bus(config, index)
+    cg.add(var.set_ledc(ledc_channel, ledc_timer))
+    if config[CONF_PROFILE_ISR]:
+        cg.add_define("USE_GDOOR_ISR_PROFILING")
+    if config[CONF_TRACE_LATENCY]:
+        cg.add_define("USE_GDOOR_LATENCY_TRACE")
+    # Raw pulse counts are a compile-time member of every frame; kept if any bus wants them
+    if config[CONF_RAW_CAPTURE]:
+        cg.add_define("USE_GDOOR_RAW_CAPTURE")
+    if config[CONF_MAX_WORDS] != DEFAULT_MAX_WORDS:
+        cg.add_define("GDOOR_MAX_WORDLEN", config[CONF_MAX_WORDS])
+    if config[CONF_LEARN_DEVICES]:
+        cg.add(var.set_learn_devices(True))
+    cg.add(var.set_session_timeout(config[CONF_SESSION_TIMEOUT]))
+    rules = config.get(CONF_RULES, [])
+    if rules:
+        # Compiled into flash tables, tagged and indexed by rule number
+        prefix = f"{config[CONF_ID].id}_rule"
+        match = frame_table(f"{prefix}_match", [(rule[CONF_RULE_MATCH], i) for i, rule in enumerate(rules)])
+        send = frame_table(f"{prefix}_send", [(rule[CONF_RULE_SEND], i) for i, rule in enumerate(rules)])
+        delays = cg.static_const_array(
+            ID(f"{prefix}_delay_us", is_declaration=True, type=cg.uint32),
+            [rule[CONF_RULE_DELAY].total_microseconds for rule in rules],
+        )
+        limits = cg.static_const_array(
+            ID(f"{prefix}_max_per_minute", is_declaration=True, type=cg.uint8),
+            [rule[CONF_RULE_MAX_PER_MINUTE] for rule in rules],
+        )
+        cg.add(var.set_rules(match, send, delays, limits, len(rules)))
+    for conf in config.get(CONF_ON_FRAME, []):
+        trigger = cg.new_Pvariable(conf[CONF_TRIGGER_ID], var)
+        # Filters become member values, checked in C++ before the automation runs
+        for key in (CONF_FRAME_ACTION, CONF_FRAME_TYPE, CONF_FRAME_SOURCE, CONF_FRAME_DESTINATION,
+                    CONF_FRAME_PARAMETERS, CONF_FRAME_VALID, CONF_FRAME_NEW_DEVICE):
+            if key in conf:
+                cg.add(getattr(trigger, f"set_{key}")(conf[key]))
+        await automation.build_automation(trigger, [(GDoorFrame.operator("ref").operator("const"), "x")], conf)
+
+
+@automation.register_action(
+    "gdoor.dump_devices",
+    GDoorDumpDevicesAction,
+    maybe_simple_id({cv.GenerateID(): cv.use_id(GdoorComponent)}),
+)
+async def gdoor_dump_devices_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    return var
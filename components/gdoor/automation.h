@@ -0,0 +1,143 @@
+#pragma once
+#include <cstdint>
+#include "esphome/core/automation.h"
+#include "gdoor_component.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+/// Decoded view on a dispatched frame, passed to on_frame automations as `x`.
+/// Built on the stack per frame; data points into the RX buffer and is only
+/// valid while the automation runs, copy what has to outlive it.
+struct GDoorFrame {
+  const char *action;    // e.g. "BUTTON_RING", "ACTION_UNKOWN" if not decoded
+  const char *type;      // device type of the sender, e.g. "OUTDOOR"
+  uint32_t source;       // 3-byte address, 0 if not decoded
+  uint32_t destination;  // 3-byte address, 0 if absent
+  uint16_t parameters;
+  bool valid;
+  const uint8_t *data;  // frame bytes incl. CRC
+  uint16_t len;
+  int64_t start_us;  // bus time of the first / last carrier edge
+  int64_t end_us;
+  bool new_device;  // source learned from this frame (learn_devices)
+
+  // Action, type, addresses and parameters are only taken from a frame that
+  // is valid and long enough (same rule as the JSON message)
+  bool decoded() const { return this->valid && this->len >= 9; }
+  uint8_t action_code() const { return this->data[2]; }
+  uint8_t type_code() const { return this->data[8]; }
+
+  static GDoorFrame from(const GDOOR_DATA_VIEW &view) {
+    return GDoorFrame{
+        view.action(),
+        view.type(),
+        view.source(),
+        view.destination(),
+        view.parameters(),
+        view.valid(),
+        view.data(),
+        view.len(),
+        view.start_us(),
+        view.end_us(),
+        false,
+    };
+  }
+};
+
+/// on_frame trigger of the gdoor component. The field filters are set from
+/// the YAML by the codegen and checked on the decoded bytes, before the
+/// automation is entered.
+class GDoorFrameTrigger : public Trigger<const GDoorFrame &> {
+ public:
+  explicit GDoorFrameTrigger(GdoorComponent *parent) : parent_(parent) { parent->register_frame_trigger(this); }
+
+  void set_action(uint8_t action) {
+    this->action_ = action;
+    this->filters_ |= FILTER_ACTION;
+  }
+  void set_type(uint8_t type) {
+    this->type_ = type;
+    this->filters_ |= FILTER_TYPE;
+  }
+  void set_source(uint32_t source) {
+    this->source_ = source;
+    this->filters_ |= FILTER_SOURCE;
+  }
+  void set_destination(uint32_t destination) {
+    this->destination_ = destination;
+    this->filters_ |= FILTER_DESTINATION;
+  }
+  void set_parameters(uint16_t parameters) {
+    this->parameters_ = parameters;
+    this->filters_ |= FILTER_PARAMETERS;
+  }
+  void set_valid(bool valid) {
+    this->valid_ = valid;
+    this->filters_ |= FILTER_VALID;
+  }
+  void set_new_device(bool new_device) {
+    this->new_device_ = new_device;
+    this->filters_ |= FILTER_NEW_DEVICE;
+  }
+
+  // Called by GdoorComponent::loop() for every dispatched frame
+  void process(const GDoorFrame &frame) {
+    if (!this->matches_(frame)) {
+      return;
+    }
+    this->trigger(frame);
+    this->parent_->trace_publish();
+  }
+
+ protected:
+  enum Filter : uint8_t {
+    FILTER_ACTION = 1 << 0,
+    FILTER_TYPE = 1 << 1,
+    FILTER_SOURCE = 1 << 2,
+    FILTER_DESTINATION = 1 << 3,
+    FILTER_PARAMETERS = 1 << 4,
+    FILTER_VALID = 1 << 5,
+    FILTER_NEW_DEVICE = 1 << 6,
+    // Filters that need the decoded fields
+    FILTERS_DECODED = FILTER_ACTION | FILTER_TYPE | FILTER_SOURCE | FILTER_DESTINATION | FILTER_PARAMETERS,
+  };
+
+  bool matches_(const GDoorFrame &frame) const {
+    if ((this->filters_ & FILTER_VALID) && frame.valid != this->valid_) {
+      return false;
+    }
+    if ((this->filters_ & FILTER_NEW_DEVICE) && frame.new_device != this->new_device_) {
+      return false;
+    }
+    if (!(this->filters_ & FILTERS_DECODED)) {
+      return true;
+    }
+    if (!frame.decoded()) {
+      return false;
+    }
+    return !((this->filters_ & FILTER_ACTION) && frame.action_code() != this->action_) &&
+           !((this->filters_ & FILTER_TYPE) && frame.type_code() != this->type_) &&
+           !((this->filters_ & FILTER_SOURCE) && frame.source != this->source_) &&
+           !((this->filters_ & FILTER_DESTINATION) && frame.destination != this->destination_) &&
+           !((this->filters_ & FILTER_PARAMETERS) && frame.parameters != this->parameters_);
+  }
+
+  GdoorComponent *parent_;
+  uint8_t filters_{0};
+  uint8_t action_{0};
+  uint8_t type_{0};
+  bool valid_{true};
+  bool new_device_{false};
+  uint16_t parameters_{0};
+  uint32_t source_{0};
+  uint32_t destination_{0};
+};
+
+template<typename... Ts> class GDoorDumpDevicesAction : public Action<Ts...>, public Parented<GdoorComponent> {
+ public:
+  void play(Ts... x) override { this->parent_->dump_devices(); }
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
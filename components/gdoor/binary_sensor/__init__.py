@@ -2,11 +2,13 @@ import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import binary_sensor
 from esphome.const import CONF_NAME
-from .. import DOMAIN, GdoorComponent, gdoor_esphome_ns, GDOOR_BUSDATA_VALIDATOR
+from .. import DOMAIN, GdoorComponent, gdoor_esphome_ns, GDOOR_BUSDATA_VALIDATOR, frame_table
 
 CODEOWNERS = ["@dtill"]
 DEPENDENCIES = [DOMAIN]
 
+CONF_RESET_DELAY = "reset_delay"
+
 # Define the text sensor class for gdoor
 GDoorActionSensor = gdoor_esphome_ns.class_("GDoorActionSensor", binary_sensor.BinarySensor, cg.Component)
 
@@ -14,6 +16,7 @@ CONFIG_SCHEMA = binary_sensor.binary_sensor_schema(GDoorActionSensor).extend({
     cv.Required(CONF_NAME): cv.string,
     cv.Required("gdoor_id"): cv.use_id(GdoorComponent),
     cv.Optional("busdata", default=[]): cv.ensure_list(GDOOR_BUSDATA_VALIDATOR),
+    cv.Optional(CONF_RESET_DELAY, default="500ms"): cv.positive_time_period_milliseconds,
 }).extend(cv.COMPONENT_SCHEMA)
 
 async def to_code(config):
@@ -22,5 +25,7 @@ async def to_code(config):
     await cg.register_component(var, config)
     await binary_sensor.register_binary_sensor(var, config)
     cg.add(var.set_parent(parent))
-    for busdata in config["busdata"]:
-        cg.add(var.add_busdata(busdata))
+    cg.add(var.set_reset_delay(config[CONF_RESET_DELAY]))
+    if config["busdata"]:
+        table = frame_table(f"{config[cv.GenerateID()].id}_busdata", [(b, 0) for b in config["busdata"]])
+        cg.add(var.set_busdata(table))
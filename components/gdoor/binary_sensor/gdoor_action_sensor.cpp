@@ -10,6 +10,7 @@ static const char *TAG = "gdoor_esphome.action_sensor";
 void GDoorActionSensor::setup() {
   ESP_LOGCONFIG(TAG, "Setting up GDoorActionSensor...");
   this->publish_state(false);
+  this->reset_timer_.set_callback([this]() { this->publish_state(false); });
   if (this->parent_ != nullptr) {
     this->parent_->register_bus_listener(this);
   } else {
@@ -17,32 +18,23 @@ void GDoorActionSensor::setup() {
   }
 }
 
-void GDoorActionSensor::on_bus_message(const std::string &busdata_hex) {
-  // Direct string equality — no JSON search
-  for (const auto &busdata : this->busdata_list_) {
-    if (busdata == busdata_hex) {
-      ESP_LOGVV(TAG, "Matched busdata: %s", busdata.c_str());
-      this->publish_state(true);
-      this->last_trigger_time_ = millis();
-      this->pending_false_ = true;
-      return;
-    }
-  }
-}
-
-void GDoorActionSensor::loop() {
-  // Matching moved to on_bus_message(); loop() only handles the reset timer
-  if (this->pending_false_ && millis() - this->last_trigger_time_ >= 500) {
-    this->publish_state(false);
-    this->pending_false_ = false;
+void GDoorActionSensor::on_bus_frame(const GDOOR_DATA_VIEW &frame) {
+  if (this->busdata_.find(frame.data(), frame.len()) < 0) {
+    return;
   }
+  ESP_LOGVV(TAG, "Matched busdata");
+  this->publish_state(true);
+  this->parent_->trace_publish();
+  // Reset to false via the parent's shared timer wheel, no loop() needed
+  this->parent_->timer_wheel().schedule(&this->reset_timer_, millis(), this->reset_delay_);
 }
 
 void GDoorActionSensor::dump_config() {
   ESP_LOGCONFIG(TAG, "GDoor Action Sensor binary_sensor");
-  for (const auto &busdata : this->busdata_list_) {
-    ESP_LOGCONFIG(TAG, "  Busdata filter: %s", busdata.c_str());
-  }
+  ESP_LOGCONFIG(TAG, "  Reset delay: %" PRIu32 " ms", this->reset_delay_);
+  this->busdata_.for_each([](const uint8_t *data, uint8_t len, uint8_t) {
+    ESP_LOGCONFIG(TAG, "  Busdata filter: %s", GDoorFrameTable::to_hex(data, len).c_str());
+  });
 }
 
 }  // namespace gdoor_esphome
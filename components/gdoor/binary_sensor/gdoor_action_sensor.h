@@ -4,6 +4,7 @@
 #include "esphome/components/binary_sensor/binary_sensor.h"
 #include "../gdoor_component.h"
 #include "../gdoor_bus_listener.h"
+#include "../gdoor_frame_table.h"
 
 namespace esphome {
 namespace gdoor_esphome {
@@ -11,21 +12,21 @@ namespace gdoor_esphome {
 class GDoorActionSensor : public binary_sensor::BinarySensor, public Component, public GDoorBusListener {
  public:
   void setup() override;
-  void loop() override;
   void dump_config() override;
   void set_parent(GdoorComponent *parent) { this->parent_ = parent; }
-  void add_busdata(const std::string &busdata) { this->busdata_list_.push_back(busdata); }
-  void set_busdata_list(const std::vector<std::string> &busdata) { this->busdata_list_ = busdata; }
+  void set_reset_delay(uint32_t reset_delay) { this->reset_delay_ = reset_delay; }
+  // Frame patterns, a flash-resident GDoorFrameTable emitted by the Python codegen
+  void set_busdata(const uint8_t *table) { this->busdata_ = GDoorFrameTable(table); }
 
-  // Called by GdoorComponent::push_bus_data() — direct string compare, no JSON search
-  void on_bus_message(const std::string &busdata_hex);
+  // Called by GdoorComponent::push_bus_frame() — byte compare against the table
+  void on_bus_frame(const GDOOR_DATA_VIEW &frame) override;
 
  protected:
   GdoorComponent *parent_{nullptr};
-  std::vector<std::string> busdata_list_;
+  GDoorFrameTable busdata_;
   uint32_t last_bus_update_{0};
-  uint32_t last_trigger_time_ = 0;
-  bool pending_false_ = false;
+  uint32_t reset_delay_{500};
+  GDoorTimer reset_timer_;
 };
 
 }  // namespace gdoor_esphome
@@ -19,7 +19,14 @@
 
 // GDoor
 #define GDOOR_VERSION "dev"
+// Frame capacity in bus words incl. CRC; GDOOR_MAX_WORDLEN comes from
+// the max_words option of the ESPHome component
+#include "esphome/core/defines.h"
+#ifdef GDOOR_MAX_WORDLEN
+#define MAX_WORDLEN GDOOR_MAX_WORDLEN
+#else
 #define MAX_WORDLEN 25
+#endif
 
 // RX Statemachine
 #define FLAG_RX_ACTIVE           0x01
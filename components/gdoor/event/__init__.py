@@ -2,13 +2,39 @@ import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import event
 from esphome.const import CONF_ID
-from .. import DOMAIN, GdoorComponent, gdoor_esphome_ns, GDOOR_BUSDATA_VALIDATOR
+from esphome.helpers import cpp_string_escape
+from .. import DOMAIN, GdoorComponent, gdoor_esphome_ns, GDOOR_BUSDATA_VALIDATOR, frame_table
 
 CODEOWNERS = ["@dtill"]
 DEPENDENCIES = [DOMAIN]
 
 GDoorBusEvent = gdoor_esphome_ns.class_("GDoorBusEvent", event.Event, cg.Component)
 
+CONF_GESTURES = "gestures"
+CONF_PRESS_GAP = "press_gap"
+CONF_DOUBLE_PRESS_WINDOW = "double_press_window"
+CONF_LONG_PRESS = "long_press"
+
+GESTURE_SCHEMA = cv.Schema({
+    # Max gap between resent frames that still belong to the same press
+    cv.Optional(CONF_PRESS_GAP, default="250ms"): cv.positive_time_period_milliseconds,
+    # Max pause between two presses reported as a double press (0 disables)
+    cv.Optional(CONF_DOUBLE_PRESS_WINDOW, default="400ms"): cv.positive_time_period_milliseconds,
+    # Min press duration reported as a long press (0 disables)
+    cv.Optional(CONF_LONG_PRESS, default="1s"): cv.positive_time_period_milliseconds,
+})
+
+
+def gesture_event_types(config):
+    """Event types emitted per busdata key when gesture detection is enabled."""
+    gestures = config[CONF_GESTURES]
+    suffixes = ["single"]
+    if gestures[CONF_DOUBLE_PRESS_WINDOW].total_milliseconds > 0:
+        suffixes.append("double")
+    if gestures[CONF_LONG_PRESS].total_milliseconds > 0:
+        suffixes.append("long")
+    return [f"{key}_{suffix}" for key in config["busdata"] for suffix in suffixes]
+
 
 def validate_event_config(config):
     """
@@ -17,10 +43,22 @@ def validate_event_config(config):
     - If event_types explicitly provided AND busdata also provided:
       every busdata key must appear in event_types.
     - If neither provided: error.
+    - With gestures, the same applies to the derived "<key>_single/_double/_long" types.
     """
     busdata = config.get("busdata", {})
     explicit_types = config.get("event_types", [])
 
+    if CONF_GESTURES in config:
+        if not busdata:
+            raise cv.Invalid("'gestures' requires 'busdata' to detect presses from")
+        for name in gesture_event_types(config):
+            if explicit_types and name not in explicit_types:
+                raise cv.Invalid(
+                    f"gesture event type '{name}' is not listed in event_types. "
+                    f"Add it, or remove event_types to auto-derive them."
+                )
+        return config
+
     if not busdata and not explicit_types:
         raise cv.Invalid(
             "Provide 'busdata' with at least one entry, or 'event_types' "
@@ -44,6 +82,7 @@ CONFIG_SCHEMA = cv.All(
             # event_type_name → list of validated hex frame strings
             cv.string_strict: cv.ensure_list(GDOOR_BUSDATA_VALIDATOR),
         }),
+        cv.Optional(CONF_GESTURES): GESTURE_SCHEMA,
     }).extend(cv.COMPONENT_SCHEMA),
     validate_event_config,
 )
@@ -55,7 +94,11 @@ async def to_code(config):
     await cg.register_component(var, config)
 
     # Derive event_types: explicit list takes priority; otherwise auto from busdata keys
-    event_types = config.get("event_types") or list(config["busdata"].keys())
+    # (or from the gesture types built on them)
+    if CONF_GESTURES in config:
+        event_types = config.get("event_types") or gesture_event_types(config)
+    else:
+        event_types = config.get("event_types") or list(config["busdata"].keys())
 
     # register_event handles: App.register_event, set_event_types, device_class,
     # on_event automations, MQTT, web_server — pass event_types as required kwarg
@@ -64,7 +107,26 @@ async def to_code(config):
     cg.add(var.set_parent(parent))
     cg.add(parent.register_bus_listener(var))
 
-    # Register each busdata hex string → event_type mapping
-    for event_type_name, payloads in config["busdata"].items():
-        for payload in payloads:
-            cg.add(var.add_busdata(payload, event_type_name))
+    # busdata hex string → event_type mapping as flash tables: the frame table
+    # tags each pattern with the index of its event_type in the names table
+    if config["busdata"]:
+        var_id = config[CONF_ID].id
+        type_names = list(config["busdata"].keys())
+        entries = [
+            (payload, index)
+            for index, name in enumerate(type_names)
+            for payload in config["busdata"][name]
+        ]
+        table = frame_table(f"{var_id}_busdata", entries)
+        names_id = f"{var_id}_busdata_types"
+        names = ", ".join(cpp_string_escape(name) for name in type_names)
+        cg.add_global(cg.RawStatement(f"static const char *const {names_id}[] = {{{names}}};"))
+        cg.add(var.set_busdata(table, cg.RawExpression(names_id), len(type_names)))
+
+    if CONF_GESTURES in config:
+        gestures = config[CONF_GESTURES]
+        cg.add(var.set_gestures(
+            gestures[CONF_PRESS_GAP],
+            gestures[CONF_DOUBLE_PRESS_WINDOW],
+            gestures[CONF_LONG_PRESS],
+        ))
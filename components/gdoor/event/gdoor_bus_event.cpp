@@ -17,6 +17,7 @@
 
 #include "gdoor_bus_event.h"
 #include "esphome/core/log.h"
+#include "esphome/core/hal.h"
 
 namespace esphome {
 namespace gdoor_esphome {
@@ -25,6 +26,82 @@ static const char *TAG = "gdoor_esphome.bus_event";
 
 void GDoorBusEvent::setup() {
   // Registration with parent is done via Python-generated code (register_bus_event)
+  if (!this->gestures_enabled_) {
+    return;
+  }
+  // Sized once, so element addresses stay stable for the timer callbacks
+  this->gesture_states_ = std::vector<GestureState>(this->busdata_type_count_);
+  for (uint8_t i = 0; i < this->busdata_type_count_; i++) {
+    GestureState *sp = &this->gesture_states_[i];
+    sp->type = i;
+    sp->timer.set_callback([this, sp]() { this->on_gesture_timer_(*sp); });
+  }
+}
+
+void GDoorBusEvent::on_bus_frame(const GDOOR_DATA_VIEW &frame) {
+  int type = this->busdata_.find(frame.data(), frame.len());   // first match wins
+  if (type < 0 || type >= this->busdata_type_count_) {
+    return;
+  }
+  if (this->gestures_enabled_) {
+    this->on_gesture_frame_(this->gesture_states_[type]);
+  } else {
+    this->trigger(this->busdata_types_[type]);
+    this->parent_->trace_publish();
+  }
+}
+
+// -------------------------------------------------------------------------
+// Gesture state machine
+//
+// A press is a train of matching frames with gaps shorter than press_gap.
+// When the train ends its duration decides between long and short; a short
+// press then waits double_press_window for a second press before it is
+// reported as single.
+// -------------------------------------------------------------------------
+void GDoorBusEvent::on_gesture_frame_(GestureState &state) {
+  const uint32_t now = millis();
+  if (state.step == GESTURE_IDLE) {
+    state.presses = 1;
+    state.press_start = now;
+  } else if (state.step == GESTURE_RELEASED) {
+    state.presses = 2;
+    state.press_start = now;
+  }
+  state.step = GESTURE_PRESSED;
+  state.last_frame = now;
+  // Re-armed on every frame: fires press_gap after the last repeat
+  this->parent_->timer_wheel().schedule(&state.timer, now, this->press_gap_);
+}
+
+void GDoorBusEvent::on_gesture_timer_(GestureState &state) {
+  if (state.step == GESTURE_PRESSED) {
+    this->on_press_end_(state);
+  } else if (state.step == GESTURE_RELEASED) {
+    this->fire_gesture_(state, "_single");
+  }
+}
+
+void GDoorBusEvent::on_press_end_(GestureState &state) {
+  uint32_t duration = state.last_frame - state.press_start;
+  if (this->long_press_ > 0 && duration >= this->long_press_) {
+    this->fire_gesture_(state, "_long");
+  } else if (state.presses >= 2) {
+    this->fire_gesture_(state, "_double");
+  } else if (this->double_press_window_ > 0) {
+    state.step = GESTURE_RELEASED;
+    this->parent_->timer_wheel().schedule(&state.timer, millis(), this->double_press_window_);
+  } else {
+    this->fire_gesture_(state, "_single");
+  }
+}
+
+void GDoorBusEvent::fire_gesture_(GestureState &state, const char *gesture) {
+  state.step = GESTURE_IDLE;
+  state.presses = 0;
+  const char *event_type = this->busdata_types_[state.type];
+  ESP_LOGV(TAG, "Gesture %s%s", event_type, gesture);
+  this->trigger(std::string(event_type) + gesture);
 }
 
 void GDoorBusEvent::dump_config() {
@@ -34,10 +111,14 @@ void GDoorBusEvent::dump_config() {
   if (busdata_.empty()) {
     ESP_LOGCONFIG(TAG, "  Busdata filters: none (TX-only event)");
   } else {
-    for (const auto &entry : busdata_) {
-      ESP_LOGCONFIG(TAG, "  Busdata '%s' → event_type '%s'",
-                    entry.first.c_str(), entry.second.c_str());
-    }
+    busdata_.for_each([this](const uint8_t *data, uint8_t len, uint8_t type) {
+      ESP_LOGCONFIG(TAG, "  Busdata '%s' → event_type '%s'", GDoorFrameTable::to_hex(data, len).c_str(),
+                    type < this->busdata_type_count_ ? this->busdata_types_[type] : "?");
+    });
+  }
+  if (this->gestures_enabled_) {
+    ESP_LOGCONFIG(TAG, "  Gestures: press gap %" PRIu32 " ms, double press %" PRIu32 " ms, long press %" PRIu32 " ms",
+                  this->press_gap_, this->double_press_window_, this->long_press_);
   }
 }
 
@@ -4,9 +4,9 @@
 #include "esphome/components/event/event.h"
 #include "../gdoor_component.h"
 #include "../gdoor_bus_listener.h"
+#include "../gdoor_frame_table.h"
 #include <string>
 #include <vector>
-#include <utility>   // std::pair
 
 namespace esphome {
 namespace gdoor_esphome {
@@ -15,21 +15,27 @@ class GDoorBusEvent : public event::Event, public Component, public GDoorBusList
  public:
   void set_parent(GdoorComponent *parent) { this->parent_ = parent; }
 
-  // Called once per configured busdata entry from Python-generated setup code
-  void add_busdata(const std::string &hex, const std::string &event_type) {
-    busdata_.emplace_back(hex, event_type);
+  // Flash-resident tables from the Python codegen: frame patterns tagged with
+  // the index of their event type in event_types (count entries)
+  void set_busdata(const uint8_t *table, const char *const *event_types, uint8_t count) {
+    this->busdata_ = GDoorFrameTable(table);
+    this->busdata_types_ = event_types;
+    this->busdata_type_count_ = count;
   }
 
-  // Called by GdoorComponent::push_bus_data() for every valid received frame
-  void on_bus_message(const std::string &busdata_hex) {
-    for (const auto &entry : busdata_) {
-      if (entry.first == busdata_hex) {
-        this->trigger(entry.second);
-        return;   // first match wins
-      }
-    }
+  // Gesture detection — when enabled, matching frames drive a per event_type
+  // state machine and fire "<event_type>_single/_double/_long" instead.
+  // A time of 0 disables the double or long gesture.
+  void set_gestures(uint32_t press_gap, uint32_t double_press_window, uint32_t long_press) {
+    this->gestures_enabled_ = true;
+    this->press_gap_ = press_gap;
+    this->double_press_window_ = double_press_window;
+    this->long_press_ = long_press;
   }
 
+  // Called by GdoorComponent::push_bus_frame() for every valid received frame
+  void on_bus_frame(const GDOOR_DATA_VIEW &frame) override;
+
   // Called by GDoorBusWrite::write_state() when a TX-linked output fires
   void handle_tx(const std::string &event_type) { this->trigger(event_type); }
 
@@ -37,9 +43,37 @@ class GDoorBusEvent : public event::Event, public Component, public GDoorBusList
   void dump_config() override;
 
  protected:
+  enum GestureStep : uint8_t {
+    GESTURE_IDLE,
+    GESTURE_PRESSED,   // frames arriving, press still held
+    GESTURE_RELEASED,  // first press over, waiting for a second one
+  };
+
+  struct GestureState {
+    uint8_t type{0};  // index into busdata_types_
+    GDoorTimer timer;
+    GestureStep step{GESTURE_IDLE};
+    uint8_t presses{0};
+    uint32_t press_start{0};
+    uint32_t last_frame{0};
+  };
+
+  void on_gesture_frame_(GestureState &state);
+  void on_gesture_timer_(GestureState &state);
+  void on_press_end_(GestureState &state);
+  void fire_gesture_(GestureState &state, const char *gesture);
+
   GdoorComponent *parent_{nullptr};
-  // Flat vector of (busdata_hex, event_type) pairs — small N, linear scan is fast
-  std::vector<std::pair<std::string, std::string>> busdata_;
+  // Frame patterns → event type index, small N, linear scan is fast
+  GDoorFrameTable busdata_;
+  const char *const *busdata_types_{nullptr};
+  uint8_t busdata_type_count_{0};
+  // One gesture state machine per event type, indexed like busdata_types_
+  std::vector<GestureState> gesture_states_;
+  bool gestures_enabled_{false};
+  uint32_t press_gap_{0};
+  uint32_t double_press_window_{0};
+  uint32_t long_press_{0};
 };
 
 }  // namespace gdoor_esphome
@@ -22,71 +22,88 @@ using esphome::esp_log_printf_;
 
 static const char *TAG = "gdoor_esphome.gdoor";
 
-namespace GDOOR {
-    /*
-    * Setup everything needed for GDoor.
-    * @param int txpin Pin number where PWM is created when sending out data
-    * @param int txenpin Pin number where output buffer is turned on/off
-    * @param int rxpin Pin number where pulses from bus are received
-    */
-    void setup(uint8_t txpin, uint8_t txenpin, uint8_t rxpin) {
-        GDOOR_RX::setup(rxpin);
-        GDOOR_TX::setup(txpin, txenpin);
+/*
+* Setup everything needed for one GDoor bus.
+* @param int txpin Pin number where PWM is created when sending out data
+* @param int txenpin Pin number where output buffer is turned on/off
+* @param int rxpin Pin number where pulses from bus are received
+* @param ledc_channel LEDC channel reserved for this bus' TX carrier
+* @param ledc_timer LEDC timer reserved for this bus' TX carrier
+* @return false if hardware resources could not be allocated
+*/
+bool GDOOR::setup(uint8_t txpin, uint8_t txenpin, uint8_t rxpin,
+                  ledc_channel_t ledc_channel, ledc_timer_t ledc_timer) {
+    if (!rx.setup(rxpin)) {
+        return false;
     }
+    return tx.setup(txpin, txenpin, &rx, ledc_channel, ledc_timer);
+}
 
-    /*
-    * RX loop, needs to be called in main loop()
-    * Needed for the decoding logic.
-    */
-    void loop() {
-        GDOOR_RX::loop();
-        GDOOR_TX::loop();
-    }
+/*
+* RX loop, needs to be called in main loop()
+* Needed for the decoding logic.
+*/
+void GDOOR::loop() {
+    rx.loop();
+    tx.loop();
+}
 
-    /**
-    * User function, called to see if new data is available.
-    * @return Data pointer as GDOOR_RX_DATA class or NULL if no data is available
-    */
-    GDOOR_DATA* read() {
-        return GDOOR_RX::read();
-    }
+/**
+* User function, called to see if new data is available.
+* @return Data pointer as GDOOR_RX_DATA class or NULL if no data is available
+*/
+GDOOR_DATA* GDOOR::read() {
+    return rx.read();
+}
 
-    /*
-    * Send out data.
-    * @param data buffer with bus data
-    * @param len length of buffer, can be max MAX_WORDLEN
-    */
-    void send(uint8_t *data, uint16_t len) {
-        GDOOR_TX::send(data, len);
-    }
+/*
+* Send out data.
+* @param data buffer with bus data
+* @param len length of buffer, can be max MAX_WORDLEN - 1 (CRC word is appended)
+* @return false if TX was busy or the data too long
+*/
+bool GDOOR::send(const uint8_t *data, uint16_t len) {
+    return tx.send(data, len);
+}
 
-    /*
-    * Send out data.
-    * @param hex string data without 0x prefix
-    */
-    void send(const char *str) {
-        GDOOR_TX::send(str);
-    }
+/*
+* Send out data.
+* @param hex string data without 0x prefix
+* @return false if TX was busy or the string invalid/too long
+*/
+bool GDOOR::send(const char *str) {
+    return tx.send(str);
+}
 
-    /*
-    * GDOOR activity status
-    * @return true: GDOOR RX or TX is active. False: no GDOOR activity.
-    */
-    bool active() {
-        return (GDOOR_TX::busy() || GDOOR_RX::rx_state != 0);
-    }
+/*
+* GDOOR activity status
+* @return true: GDOOR RX or TX is active. False: no GDOOR activity.
+*/
+bool GDOOR::active() {
+    return (tx.busy() || rx.rx_state != 0);
+}
+
+// One oneshot handle per DAC channel, created on first use and kept so the
+// threshold can be changed again at runtime (RX auto calibration)
+static dac_oneshot_handle_t dac_handles[2] = {nullptr, nullptr};
 
-    /** Set RX Threshold (Sensitivity) to a certain level,
-     * only working for IO22 rx input on v3.1 hardware
-    */
-   void setRxThreshold(uint8_t pin, float sensitivity) {
-        uint8_t value = (uint8_t)((sensitivity / 3.3f) * 255);
-        // GPIO25 = DAC_CHAN_0, GPIO26 = DAC_CHAN_1 (IDF v5 dac_oneshot API)
-        dac_channel_t chan = (pin == 25) ? DAC_CHAN_0 : DAC_CHAN_1;
-        dac_oneshot_handle_t handle;
+/** Set RX Threshold (Sensitivity) to a certain level,
+ * only working for IO22 rx input on v3.1 hardware.
+ * May be called again to move the threshold.
+*/
+void GDOOR::setRxThreshold(uint8_t pin, float sensitivity) {
+    uint8_t value = (uint8_t)((sensitivity / 3.3f) * 255);
+    // GPIO25 = DAC_CHAN_0, GPIO26 = DAC_CHAN_1 (IDF v5 dac_oneshot API)
+    dac_channel_t chan = (pin == 25) ? DAC_CHAN_0 : DAC_CHAN_1;
+    dac_oneshot_handle_t &handle = dac_handles[chan == DAC_CHAN_0 ? 0 : 1];
+    if (handle == nullptr) {
         dac_oneshot_config_t cfg = { .chan_id = chan };
-        dac_oneshot_new_channel(&cfg, &handle);
-        dac_oneshot_output_voltage(handle, value);
-        // handle intentionally not deleted — DAC output must remain active
-   }
-}
\ No newline at end of file
+        if (dac_oneshot_new_channel(&cfg, &handle) != ESP_OK) {
+            ESP_LOGE(TAG, "Could not claim DAC on GPIO %u", pin);
+            handle = nullptr;
+            return;
+        }
+    }
+    dac_oneshot_output_voltage(handle, value);
+    // handle intentionally not deleted — DAC output must remain active
+}
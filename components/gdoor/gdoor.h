@@ -23,14 +23,30 @@
 #include "gdoor_tx.h"
 #include "gdoor_data.h"
 
-namespace GDOOR { //Namespace as we can only use it once
-    void setup(uint8_t txpin, uint8_t txenpin, uint8_t rxpin);
-    void loop();
-    GDOOR_DATA* read();
-    void send(uint8_t *data, uint16_t len);
-    void send(const char *str);
-    bool active();
-    void setRxThreshold(uint8_t pin, float sensitivity);
+class GDOOR { // One instance per bus, owns its RX and TX engines
+    public:
+        bool setup(uint8_t txpin, uint8_t txenpin, uint8_t rxpin,
+                   ledc_channel_t ledc_channel, ledc_timer_t ledc_timer);
+        void loop();
+        GDOOR_DATA* read();
+        bool send(const uint8_t *data, uint16_t len);
+        bool send(const char *str);
+        bool send_at(const uint8_t *data, uint16_t len, int64_t reference_us, uint32_t offset_us) {
+            return tx.send_at(data, len, reference_us, offset_us);
+        }
+        bool active();
+        // Current time on the clock of end_us, the one send_at() counts on
+        int64_t now_us() const { return rx.now_us(); }
+        const GDOOR_RX_STATS &rx_stats() const { return rx.stats(); }
+        void set_train_callback(GDOOR_RX::train_callback_t callback, void *arg) {
+            rx.set_train_callback(callback, arg);
+        }
+        const GDOOR_TX_STATS &tx_stats() const { return tx.stats(); }
+        static void setRxThreshold(uint8_t pin, float sensitivity);
+
+    private:
+        GDOOR_RX rx;
+        GDOOR_TX tx;
 };
 
 #endif
\ No newline at end of file
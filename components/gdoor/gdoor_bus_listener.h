@@ -1,17 +1,58 @@
 #pragma once
+#include <cstdint>
 #include <string>
+#include "gdoor_data.h"
+#include "gdoor_call_session.h"
 
 namespace esphome {
 namespace gdoor_esphome {
 
 /// Common interface for components that receive Gira bus frame notifications.
 /// Implemented by GDoorActionSensor (binary_sensor) and GDoorBusEvent (event).
+/// frame.data() holds the raw frame bytes including the CRC byte; decoded
+/// fields cost nothing unless asked for.
 class GDoorBusListener {
  public:
-  virtual void on_bus_message(const std::string &busdata_hex) = 0;
+  virtual void on_bus_frame(const GDOOR_DATA_VIEW &frame) = 0;
   virtual ~GDoorBusListener() = default;
 };
 
+/// Interface for components that want every decoded frame as rendered JSON,
+/// including invalid ones. Implemented by GDoorBusMessage (text_sensor).
+class GDoorMessageListener {
+ public:
+  virtual void on_bus_json(const std::string &json) = 0;
+  virtual ~GDoorMessageListener() = default;
+};
+
+/// Interface for consumers of every decoded frame before dedupe, valid or not,
+/// with validity, bus timestamps (start_us/end_us) and (if raw_capture is on)
+/// the raw pulse counts.
+/// Implemented by GDoorStreamServer (gdoor_stream) and GDoorFrameLogger (gdoor_log).
+class GDoorFrameListener {
+ public:
+  virtual void on_frame(const GDOOR_DATA &frame) = 0;
+  virtual ~GDoorFrameListener() = default;
+};
+
+/// Interface for consumers of every pulse train that reached frame end, also
+/// the ones that did not decode to a single word (len 0). Called from the RX
+/// engine before dedupe and before the frame listeners; with raw_capture the
+/// counts are in train.raw. Implemented by GDoorSniffer (gdoor_sniffer).
+class GDoorTrainListener {
+ public:
+  virtual void on_train(const GDOOR_DATA &train, bool parsed) = 0;
+  virtual ~GDoorTrainListener() = default;
+};
+
+/// Interface for consumers of call session changes (ring, answer, door open,
+/// end). Implemented by GDoorCallSessionSensor (text_sensor, type: session).
+class GDoorSessionListener {
+ public:
+  virtual void on_session(const GDoorCallSession &session) = 0;
+  virtual ~GDoorSessionListener() = default;
+};
+
 /// Interface for event entities that can be triggered from the TX (output) side.
 /// Implemented by GDoorBusEvent (event). Used by GDoorBusWrite (output) to fire
 /// a linked event when a payload is sent, without a direct dependency on the event header.
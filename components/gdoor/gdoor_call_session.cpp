@@ -0,0 +1,142 @@
+#include "gdoor_call_session.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+// Bus codes, see GDOOR_DATA_ACTION in gdoor_data.cpp
+static const uint8_t ACTION_BUTTON_RING = 0x11;
+static const uint8_t ACTION_AUDIO_REQUEST = 0x21;
+static const uint8_t ACTION_VIDEO_REQUEST = 0x28;
+static const uint8_t ACTION_DOOR_OPEN = 0x31;
+static const uint8_t ACTION_AUDIO_VIDEO_END = 0x20;
+
+const char *GDoorCallSession::state_name(State state) {
+  switch (state) {
+    case RINGING:
+      return "ringing";
+    case CONNECTED:
+      return "connected";
+    case DOOR_OPENED:
+      return "door_opened";
+    case ENDED:
+      return "ended";
+    default:
+      return "idle";
+  }
+}
+
+GDoorCallSession *GDoorCallSessionTracker::find_(uint32_t station) {
+  for (uint8_t i = 0, slot = slot_(station); i < SLOTS; i++, slot = (slot + 1) & (SLOTS - 1)) {
+    GDoorCallSession &session = this->slots_[slot];
+    if (session.state == GDoorCallSession::IDLE) {
+      return nullptr;  // probe chains never span a free slot
+    }
+    if (session.station == station) {
+      return &session;
+    }
+  }
+  return nullptr;
+}
+
+GDoorCallSession *GDoorCallSessionTracker::claim_(uint32_t station) {
+  GDoorCallSession *session = this->find_(station);
+  if (session != nullptr) {
+    return session;
+  }
+  GDoorCallSession *victim = nullptr;
+  for (uint8_t i = 0, slot = slot_(station); i < SLOTS; i++, slot = (slot + 1) & (SLOTS - 1)) {
+    GDoorCallSession &candidate = this->slots_[slot];
+    if (candidate.state == GDoorCallSession::IDLE) {
+      return &candidate;
+    }
+    // Ended calls go first, then the one quiet for longest
+    bool candidate_ended = candidate.state == GDoorCallSession::ENDED;
+    bool victim_ended = victim != nullptr && victim->state == GDoorCallSession::ENDED;
+    if (victim == nullptr || (candidate_ended && !victim_ended) ||
+        (candidate_ended == victim_ended && candidate.last_seen < victim->last_seen)) {
+      victim = &candidate;
+    }
+  }
+  // Reusing a slot keeps the probe chain intact, no tombstones needed
+  return victim;
+}
+
+bool GDoorCallSessionTracker::next_expiry(uint32_t now, uint32_t timeout, uint32_t *delay) const {
+  bool running = false;
+  uint32_t earliest = timeout;
+  for (const auto &session : this->slots_) {
+    if (session.state == GDoorCallSession::IDLE || session.state == GDoorCallSession::ENDED) {
+      continue;
+    }
+    uint32_t quiet = now - session.last_seen;
+    uint32_t left = quiet < timeout ? timeout - quiet : 0;
+    if (left < earliest) {
+      earliest = left;
+    }
+    running = true;
+  }
+  *delay = earliest;
+  return running;
+}
+
+GDoorCallSession *GDoorCallSessionTracker::on_frame(const GDOOR_DATA_VIEW &frame, uint32_t now) {
+  if (!frame.decoded()) {
+    return nullptr;
+  }
+  uint8_t action = frame.action_code();
+  uint32_t source = frame.source();
+  uint32_t destination = frame.destination();
+
+  if (action == ACTION_BUTTON_RING) {
+    GDoorCallSession *session = this->claim_(source);
+    bool running = session->station == source && session->state != GDoorCallSession::IDLE &&
+                   session->state != GDoorCallSession::ENDED;
+    if (running) {
+      session->last_seen = now;  // rung again during the call
+      return nullptr;
+    }
+    *session = GDoorCallSession{source, 0, now, now, GDoorCallSession::RINGING, false, false, false};
+    return session;
+  }
+
+  if (action != ACTION_AUDIO_REQUEST && action != ACTION_VIDEO_REQUEST && action != ACTION_DOOR_OPEN &&
+      action != ACTION_AUDIO_VIDEO_END) {
+    return nullptr;
+  }
+  // Indoor stations address the door station; the door station itself may
+  // also end the call, so fall back to the sender
+  GDoorCallSession *session = destination != 0 ? this->find_(destination) : nullptr;
+  if (session == nullptr) {
+    session = this->find_(source);
+  }
+  if (session == nullptr || session->state == GDoorCallSession::ENDED) {
+    return nullptr;
+  }
+  session->last_seen = now;
+  GDoorCallSession before = *session;
+  switch (action) {
+    case ACTION_AUDIO_REQUEST:
+    case ACTION_VIDEO_REQUEST:
+      if (session->state == GDoorCallSession::RINGING) {
+        session->state = GDoorCallSession::CONNECTED;
+      }
+      if (session->answered_by == 0 && source != session->station) {
+        session->answered_by = source;
+      }
+      session->video |= action == ACTION_VIDEO_REQUEST;
+      break;
+    case ACTION_DOOR_OPEN:
+      session->state = GDoorCallSession::DOOR_OPENED;
+      session->door_opened = true;
+      break;
+    default:  // ACTION_AUDIO_VIDEO_END
+      session->state = GDoorCallSession::ENDED;
+      break;
+  }
+  bool changed = session->state != before.state || session->video != before.video ||
+                 session->answered_by != before.answered_by;
+  return changed ? session : nullptr;
+}
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
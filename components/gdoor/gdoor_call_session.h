@@ -0,0 +1,72 @@
+#pragma once
+#include <cstdint>
+#include "gdoor_data.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+/// One call at a door station, from BUTTON_RING to AUDIO_VIDEO_END.
+struct GDoorCallSession {
+  enum State : uint8_t {
+    IDLE = 0,     // slot unused
+    RINGING,      // BUTTON_RING seen, not answered yet
+    CONNECTED,    // an indoor station requested audio/video
+    DOOR_OPENED,  // DOOR_OPEN during the call
+    ENDED,        // AUDIO_VIDEO_END or timeout; slot may be reused
+  };
+
+  uint32_t station;      // 3-byte address of the ringing station
+  uint32_t answered_by;  // indoor station that requested audio/video, 0 if none
+  uint32_t started;      // millis() of the ring
+  uint32_t last_seen;    // millis() of the latest frame of the call
+  State state;
+  bool video;
+  bool door_opened;
+  bool timed_out;  // ENDED without AUDIO_VIDEO_END
+
+  uint32_t duration_ms() const { return this->last_seen - this->started; }
+  static const char *state_name(State state);
+};
+
+/// Per-station call state in a small fixed table. Slots are found by hashing
+/// the station address with a bounded linear probe, so every frame costs a
+/// constant number of compares and nothing is allocated. Only state changes
+/// are reported; repeats and frames that do not move a call are absorbed.
+class GDoorCallSessionTracker {
+ public:
+  static const uint8_t SLOTS = 8;  // concurrent calls, power of two
+
+  // Every valid, deduped frame; returns the session it changed or nullptr
+  GDoorCallSession *on_frame(const GDOOR_DATA_VIEW &frame, uint32_t now);
+  // Ends calls without a frame for timeout ms, calls f for each
+  template<typename F> void expire(uint32_t now, uint32_t timeout, F &&f) {
+    for (auto &session : this->slots_) {
+      if (session.state == GDoorCallSession::IDLE || session.state == GDoorCallSession::ENDED) {
+        continue;
+      }
+      if (now - session.last_seen < timeout) {
+        continue;
+      }
+      session.state = GDoorCallSession::ENDED;
+      session.timed_out = true;
+      f(session);
+    }
+  }
+  // ms from now until the least recently seen running call times out (0 if
+  // overdue); false while no call is running
+  bool next_expiry(uint32_t now, uint32_t timeout, uint32_t *delay) const;
+
+ protected:
+  // Home slot: top 3 bits of a Fibonacci hash, one per slot
+  static uint8_t slot_(uint32_t station) { return (uint8_t) ((station * 2654435761u) >> 29); }
+  // Running or ended call of station, nullptr if none
+  GDoorCallSession *find_(uint32_t station);
+  // Slot for a new call: the station's own, a free one, else the oldest ended
+  // or (table full of running calls) the least recently seen one
+  GDoorCallSession *claim_(uint32_t station);
+
+  GDoorCallSession slots_[SLOTS]{};
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
@@ -0,0 +1,43 @@
+/*
+ * This file is part of the GDoor distribution (https://github.com/gdoor-org).
+ * Copyright (c) 2024 GDoor authors.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GDOOR_CAPACITY_H
+#define GDOOR_CAPACITY_H
+#include <stdint.h>
+#include <type_traits>
+
+/*
+* Compile-time sizes of one bus frame with room for WORDS bus words
+* (data words plus the trailing CRC word, 9 bits each on the wire,
+* behind one start bit).
+* Frame and engine types are templates on WORDS; the index types
+* below grow with the capacity so no counter can wrap before the
+* buffers are full.
+*/
+template<uint16_t WORDS> struct GDOOR_CAPACITY {
+    static_assert(WORDS >= 2, "A frame needs at least one data word and the CRC word");
+    static_assert((uint32_t)WORDS * 9 + 1 < 0xFFFF, "Burst count of a frame must fit 16 bits");
+
+    static const uint16_t words = WORDS;
+    static const uint16_t bits   = WORDS * 9;      // data bits of a full frame, without start bit
+    static const uint16_t counts = WORDS * 9 + 1;  // pulse bursts of a full frame, start bit included
+
+    // Indexes 0..WORDS and 0..counts inclusive, counters are compared against the size
+    typedef typename std::conditional<(WORDS < 0xFF), uint8_t, uint16_t>::type word_index_t;
+    typedef typename std::conditional<(WORDS * 9 + 1 < 0xFF), uint8_t, uint16_t>::type bit_index_t;
+};
+
+#endif
@@ -1,6 +1,11 @@
 #include "gdoor_component.h"
+#include "automation.h"
 #include "esphome/core/log.h"
 #include "esphome/core/hal.h"
+#include <cmath>
+#ifdef USE_GDOOR_ISR_PROFILING
+#include "esp_rom_sys.h"
+#endif
 
 namespace esphome {
 namespace gdoor_esphome {
@@ -33,10 +38,15 @@ void GdoorComponent::set_last_rx_data(GDOOR_DATA *data) {
 
 void GdoorComponent::send_bus_message(const std::string &payload) {
   ESP_LOGVV(TAG, "Writing bus data: %s", payload.c_str());
-  GDOOR::send(payload.c_str());
+  this->gdoor_.send(payload.c_str());
+}
+
+bool GdoorComponent::send_bus_frame(const uint8_t *data, uint16_t len) {
+  return this->gdoor_.send(data, len);
 }
 
 void GdoorComponent::setup() {
+    this->session_timer_.set_callback([this]() { this->expire_sessions_(); });
     if (this->tx_pin_ == nullptr || this->tx_en_pin_ == nullptr || this->rx_pin_ == nullptr) {
         ESP_LOGE(TAG, "One or more pins are not configured properly!");
         return;
@@ -53,49 +63,204 @@ void GdoorComponent::setup() {
     uint8_t rx_pin_number = rx_internal_pin->get_pin();
     uint8_t rx_thresh_pin_number = rx_thresh_internal_pin != nullptr ? rx_thresh_internal_pin->get_pin() : 0;
 
-    GDOOR::setup(tx_pin_number, tx_en_pin_number, rx_pin_number);
+    if (!this->gdoor_.setup(tx_pin_number, tx_en_pin_number, rx_pin_number,
+                            (ledc_channel_t)this->ledc_channel_, (ledc_timer_t)this->ledc_timer_)) {
+        ESP_LOGE(TAG, "Could not allocate RX/TX timers for this bus");
+        this->mark_failed();
+        return;
+    }
+
+    if (this->learn_devices_) {
+        this->devices_.setup(rx_pin_number);
+    }
 
     // Configure RX threshold if conditions are met
-    if (rx_pin_number == 22 && this->rx_sens_ != 1.65) {
+    this->rx_threshold_adjustable_ = rx_pin_number == 22;
+    if (this->rx_threshold_adjustable_ && this->rx_auto_calibrate_) {
+        this->rx_calibrator_.setup(rx_thresh_pin_number, RX_SENS_HIGH_NUM);
+    } else if (this->rx_threshold_adjustable_ && this->rx_sens_ != 1.65) {
         GDOOR::setRxThreshold(rx_thresh_pin_number, this->rx_sens_);
     }
+    if (this->rx_auto_calibrate_ && !this->rx_threshold_adjustable_) {
+        ESP_LOGW(TAG, "rx_sens: auto needs rx_pin 22, calibration disabled");
+        this->rx_auto_calibrate_ = false;
+    }
+}
+
+float GdoorComponent::rx_threshold() const {
+  if (!this->rx_threshold_adjustable_) {
+    return NAN;
+  }
+  return this->rx_auto_calibrate_ ? this->rx_calibrator_.threshold() : this->rx_sens_;
 }
 
 
-// Build uppercase hex string from raw frame bytes — O(n), called once per frame
-static std::string build_busdata_hex(const GDOOR_DATA *data) {
-  static const char HC[] = "0123456789ABCDEF";
-  std::string s;
-  s.reserve((size_t)data->len * 2);
-  for (uint16_t i = 0; i < data->len; i++) {
-    s += HC[(data->data[i] >> 4) & 0xF];
-    s += HC[ data->data[i]       & 0xF];
+void GdoorComponent::register_train_listener(GDoorTrainListener *l) {
+  if (this->train_listeners_.empty()) {
+    this->gdoor_.set_train_callback(
+        [](const GDOOR_DATA &train, bool parsed, void *arg) {
+          for (auto *l : static_cast<GdoorComponent *>(arg)->train_listeners_) l->on_train(train, parsed);
+        },
+        this);
   }
-  return s;
+  this->train_listeners_.push_back(l);
+}
+
+void GdoorComponent::push_bus_frame(const GDOOR_DATA_VIEW &frame) {
+  for (auto *l : bus_listeners_) l->on_bus_frame(frame);
 }
 
-void GdoorComponent::push_bus_data(const std::string &busdata_hex) {
-  for (auto *l : bus_listeners_) l->on_bus_message(busdata_hex);
+/*
+ * Dedupe stage: true if the same valid frame was already dispatched
+ * less than dedupe_window_ ms ago. Every copy refreshes the entry, so a
+ * train of resends counts as one press. Misses evict the oldest entry.
+ */
+bool GdoorComponent::is_repeat_(const GDOOR_DATA *data, uint32_t now) {
+  if (this->dedupe_window_ == 0 || !data->valid) {
+    return false;
+  }
+  uint32_t hash = GDOOR_UTILS::hash(data->data, data->len);
+  RecentFrame *oldest = &this->recent_frames_[0];
+  for (auto &entry : this->recent_frames_) {
+    if (entry.len == data->len && entry.hash == hash) {
+      bool repeat = now - entry.last_seen < this->dedupe_window_;
+      entry.last_seen = now;
+      return repeat;
+    }
+    if (now - entry.last_seen > now - oldest->last_seen) {
+      oldest = &entry;
+    }
+  }
+  oldest->hash = hash;
+  oldest->len = data->len;
+  oldest->last_seen = now;
+  return false;
 }
 
 void GdoorComponent::loop() {
-  GDOOR::loop();
-  GDOOR_DATA* rx_data = GDOOR::read();
+  this->gdoor_.loop();
+  this->timer_wheel_.advance(millis());
+  GDOOR_DATA* rx_data = this->gdoor_.read();
+  // One view for every consumer; fields are decoded when someone asks
+  GDOOR_DATA_VIEW frame(rx_data);
+  if (!this->rules_.empty()) {
+    // Rules react first, a zero-delay reply goes out in this same loop
+    if (rx_data != nullptr) {
+      this->rules_.on_frame(frame, millis());
+    }
+    this->rules_.loop(this->gdoor_);
+  }
+  if (this->rx_auto_calibrate_) {
+    // Repeats are welcome samples, so calibrate before dedupe
+    if (rx_data != nullptr) {
+      this->rx_calibrator_.on_frame(rx_data, this->rx_stats(), millis());
+    } else {
+      this->rx_calibrator_.loop(this->rx_stats(), millis());
+    }
+  }
+  bool new_device = false;
+  if (rx_data != nullptr && rx_data->valid && this->devices_.enabled()) {
+    // Repeats still count as heard
+    new_device = this->devices_.on_frame(frame, millis());
+  }
+  if (rx_data != nullptr) {
+    // Frame consumers see every telegram, including repeats and broken ones
+    ESP_LOGVV(TAG, "Frame end to dispatch: %" PRId64 "us", this->gdoor_.now_us() - rx_data->end_us);
+    for (auto *l : this->frame_listeners_) l->on_frame(*rx_data);
+  }
+  if (rx_data != nullptr && this->is_repeat_(rx_data, millis())) {
+    this->suppressed_repeats_++;
+    ESP_LOGV(TAG, "Suppressed repeated telegram (%" PRIu32 " so far)", this->suppressed_repeats_);
+    rx_data = nullptr;
+  }
   if (rx_data != nullptr) {
-    GDOOR_DATA_PROTOCOL busmessage = GDOOR_DATA_PROTOCOL(rx_data);
-    std::string action = busmessage.action;
+    uint32_t stage_start = micros();
+    uint32_t event_id = GDOOR_DATA_VIEW::next_event_id();
     this->set_last_rx_data(rx_data);
-    char buffer[256];
-    PrintToBuffer ptb(buffer, sizeof(buffer));
-    busmessage.printTo(ptb);
-    this->last_rx_str_ = "{" + std::string(buffer) + "}";
+    // Size the JSON once, then render it straight into the string storage
+    size_t json_len = frame.json_length(event_id);
+    this->last_rx_str_.resize(json_len + 2);
+    char *out = &this->last_rx_str_[0];
+    *out++ = '{';
+    out = frame.write_json(out, event_id);
+    *out = '}';
+    this->render_timing_.add(micros() - stage_start);
+#ifdef USE_GDOOR_LATENCY_TRACE
+    rx_data->trace.mark(TRACE_DECODED, this->trace_now_());
+#endif
     this->set_last_bus_update( millis() );
-    ESP_LOGD(TAG, "Received data from GDoor bus: %s", buffer);
+    ESP_LOGD(TAG, "Received data from GDoor bus: %.*s", (int)json_len, this->last_rx_str_.c_str() + 1);
 
-    // Push busdata_hex to all registered sensors and events (valid frames only)
+    stage_start = micros();
+#ifdef USE_GDOOR_LATENCY_TRACE
+    rx_data->trace.mark(TRACE_DISPATCHED, this->trace_now_());
+    this->dispatch_trace_ = &rx_data->trace;
+#endif
+    for (auto *l : message_listeners_) l->on_bus_json(this->last_rx_str_);
+
+    // Push the frame to all registered sensors and events (valid frames only)
     if (rx_data->valid) {
-      push_bus_data(build_busdata_hex(rx_data));
+      push_bus_frame(frame);
+    }
+    if (rx_data->valid && !this->session_listeners_.empty()) {
+      this->track_session_(frame);
+    }
+    if (!this->frame_triggers_.empty()) {
+      // Decoded fields straight from the view, no JSON round trip
+      GDoorFrame trigger_frame = GDoorFrame::from(frame);
+      trigger_frame.new_device = new_device;
+      for (auto *t : this->frame_triggers_) t->process(trigger_frame);
     }
+    this->dispatch_timing_.add(micros() - stage_start);
+#ifdef USE_GDOOR_LATENCY_TRACE
+    this->dispatch_trace_ = nullptr;
+    this->latency_trace_.push(rx_data->trace);
+#endif
+  }
+}
+
+#ifdef USE_GDOOR_ISR_PROFILING
+static void dump_isr_histogram(const char *name, const GDOOR_ISR_HISTOGRAM &hist) {
+  if (hist.count == 0) {
+    ESP_LOGCONFIG(TAG, "    %-10s: no samples", name);
+    return;
+  }
+  const float mhz = (float) esp_rom_get_cpu_ticks_per_us();
+  ESP_LOGCONFIG(TAG, "    %-10s: n=%" PRIu32 " min=%.2f p50=%.2f p90=%.2f p99=%.2f max=%.2f µs", name, hist.count,
+                hist.min_cycles / mhz, hist.percentile(50) / mhz, hist.percentile(90) / mhz,
+                hist.percentile(99) / mhz, hist.max_cycles / mhz);
+}
+#endif
+
+void GdoorComponent::track_session_(const GDOOR_DATA_VIEW &frame) {
+  uint32_t now = millis();
+  const GDoorCallSession *session = this->call_sessions_.on_frame(frame, now);
+  if (session == nullptr) {
+    return;
+  }
+  ESP_LOGD(TAG, "Call at %06" PRIX32 ": %s after %" PRIu32 " ms", session->station,
+           GDoorCallSession::state_name(session->state), session->duration_ms());
+  for (auto *l : this->session_listeners_) l->on_session(*session);
+  this->schedule_session_expiry_(now);
+}
+
+void GdoorComponent::expire_sessions_() {
+  uint32_t now = millis();
+  this->call_sessions_.expire(now, this->session_timeout_, [this](const GDoorCallSession &session) {
+    ESP_LOGD(TAG, "Call at %06" PRIX32 " timed out after %" PRIu32 " ms", session.station, session.duration_ms());
+    for (auto *l : this->session_listeners_) l->on_session(session);
+  });
+  this->schedule_session_expiry_(now);
+}
+
+void GdoorComponent::schedule_session_expiry_(uint32_t now) {
+  // Due when the quietest call times out; frames of other calls only push
+  // their own deadline, so they never hold this one back
+  uint32_t delay;
+  if (this->call_sessions_.next_expiry(now, this->session_timeout_, &delay)) {
+    this->timer_wheel_.schedule(&this->session_timer_, now, delay);
+  } else {
+    this->timer_wheel_.cancel(&this->session_timer_);
   }
 }
 
@@ -130,7 +295,56 @@ void GdoorComponent::dump_config() {
     ESP_LOGCONFIG(TAG, "  RX_THRESH Pin: Not set");
   }
 
-  ESP_LOGCONFIG(TAG, "  RX Sensitivity: %f", this->rx_sens());
+  if (this->rx_auto_calibrate_) {
+    this->rx_calibrator_.dump_config();
+  } else {
+    ESP_LOGCONFIG(TAG, "  RX Sensitivity: %f", this->rx_sens());
+  }
+  ESP_LOGCONFIG(TAG, "  LEDC channel/timer: %u/%u", this->ledc_channel_, this->ledc_timer_);
+  if (!this->rules_.empty()) {
+    this->rules_.dump_config();
+  }
+  if (this->devices_.enabled()) {
+    this->devices_.dump_config();
+  }
+  ESP_LOGCONFIG(TAG, "  RX clock: within %" PRIu32 " us of esp_timer, %" PRIu32 " re-anchors",
+                this->rx_stats().clock_skew_us, this->rx_stats().clock_resyncs);
+  const GDOOR_TIMING &timed_error = this->tx_stats().timed_error;
+  if (timed_error.samples > 0) {
+    ESP_LOGCONFIG(TAG, "  Timed TX: %" PRIu32 " sent, last offset %" PRId32 "/%" PRId32 " us (achieved/requested)",
+                  timed_error.samples, this->tx_stats().timed_achieved_us, this->tx_stats().timed_requested_us);
+    ESP_LOGCONFIG(TAG, "  Timed TX error: avg %.1f us, max %" PRIu32 " us",
+                  (float) timed_error.total_us / timed_error.samples, timed_error.max_us);
+  }
+  if (this->dedupe_window_ > 0) {
+    ESP_LOGCONFIG(TAG, "  Dedupe window: %" PRIu32 " ms", this->dedupe_window_);
+    ESP_LOGCONFIG(TAG, "  Suppressed repeats: %" PRIu32, this->suppressed_repeats_);
+  } else {
+    ESP_LOGCONFIG(TAG, "  Dedupe window: disabled");
+  }
+#ifdef USE_GDOOR_ISR_PROFILING
+  ESP_LOGCONFIG(TAG, "  ISR profile:");
+  dump_isr_histogram("rx_edge", this->rx_stats().isr_edge);
+  dump_isr_histogram("rx_bit", this->rx_stats().isr_bit);
+  dump_isr_histogram("rx_frame", this->rx_stats().isr_frame);
+  dump_isr_histogram("tx_tick", this->tx_stats().isr_tick);
+#endif
+#ifdef USE_GDOOR_LATENCY_TRACE
+  ESP_LOGCONFIG(TAG, "  Latency since first edge, last %u of %" PRIu32 " frames:", GDOOR_TRACE_RING::SIZE,
+                this->latency_trace_.count());
+  for (uint8_t stage = TRACE_LAST_EDGE; stage < TRACE_STAGES; stage++) {
+    uint32_t p50, p90, p99;
+    GDOOR_TRACE_STAGE s = (GDOOR_TRACE_STAGE) stage;
+    if (!this->latency_trace_.percentile(s, 50, &p50)) {
+      ESP_LOGCONFIG(TAG, "    %-10s: no samples", GDOOR_TRACE_RING::stage_name(s));
+      continue;
+    }
+    this->latency_trace_.percentile(s, 90, &p90);
+    this->latency_trace_.percentile(s, 99, &p99);
+    ESP_LOGCONFIG(TAG, "    %-10s: p50=%" PRIu32 " p90=%" PRIu32 " p99=%" PRIu32 " µs", GDOOR_TRACE_RING::stage_name(s),
+                  p50, p90, p99);
+  }
+#endif
 }
 
 }  // namespace gdoor_esphome
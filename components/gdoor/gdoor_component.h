@@ -1,14 +1,22 @@
 #pragma once
 #include "esphome/core/component.h"
 #include "esphome/core/gpio.h"
+#include "esphome/core/hal.h"
+#include <cstring>
 #include <string>
 #include <vector>
 #include "gdoor.h"
 #include "gdoor_bus_listener.h"
+#include "gdoor_timer_wheel.h"
+#include "gdoor_rx_calibration.h"
+#include "gdoor_rule_engine.h"
+#include "gdoor_device_registry.h"
 
 namespace esphome {
 namespace gdoor_esphome {
 
+class GDoorFrameTrigger;
+
 class GdoorComponent : public Component {
  public:
   // Methods for setting the pins and sensitivity.
@@ -17,18 +25,67 @@ class GdoorComponent : public Component {
   void set_rx_pin(GPIOPin *rx_pin);
   void set_rx_thresh_pin(GPIOPin *rx_thresh_pin);
   void set_rx_sens(float rx_sens);
+  // rx_sens: auto, threshold found by GDoorRxCalibrator instead of a preset
+  void set_rx_auto_calibrate(bool auto_calibrate) { this->rx_auto_calibrate_ = auto_calibrate; }
+  void set_dedupe_window(uint32_t dedupe_window) { this->dedupe_window_ = dedupe_window; }
+  // LEDC resources for the TX carrier, allocated per bus by the Python codegen
+  void set_ledc(uint8_t channel, uint8_t timer) {
+    this->ledc_channel_ = channel;
+    this->ledc_timer_ = timer;
+  }
+  // Local rules, flash tables emitted by the codegen; see GDoorRuleEngine
+  void set_rules(const uint8_t *match_table, const uint8_t *send_table, const uint32_t *delays_us,
+                 const uint8_t *max_per_minute, uint8_t count) {
+    this->rules_.set_rules(match_table, send_table, delays_us, max_per_minute, count);
+  }
   float get_setup_priority() const override { return esphome::setup_priority::LATE; }
   void setup() override;
   void loop() override;
   void dump_config() override;
 
   void send_bus_message(const std::string &payload);
+  // Send raw frame bytes, e.g. a flash-resident payload table
+  // Returns false if the frame was dropped (TX busy or too long)
+  bool send_bus_frame(const uint8_t *data, uint16_t len);
+  // Send raw frame bytes offset_us after the end_us (last carrier edge) of a
+  // received frame, or any other time on that clock (GDOOR::now_us()). The
+  // TX timer enforces the offset, the result is in tx_stats(). False if TX
+  // is busy, the frame too long or the send time more than
+  // GDOOR_TX::SEND_AT_AHEAD_MAX_US away.
+  bool send_bus_frame_after(int64_t frame_end_us, uint32_t offset_us, const uint8_t *data, uint16_t len) {
+    return this->gdoor_.send_at(data, len, frame_end_us, offset_us);
+  }
 
   // Push-model registration — called from each sub-component's setup() or Python codegen
   void register_bus_listener(GDoorBusListener *l) { bus_listeners_.push_back(l); }
 
-  // Push busdata_hex to all registered listeners (binary sensors and event entities)
-  void push_bus_data(const std::string &busdata_hex);
+  // Push a valid frame to all registered listeners (binary sensors and event entities)
+  void push_bus_frame(const GDOOR_DATA_VIEW &frame);
+
+  // Push-model registration for consumers of the rendered JSON (text sensor)
+  void register_message_listener(GDoorMessageListener *l) { message_listeners_.push_back(l); }
+
+  // Push-model registration for consumers of every decoded frame (stream server)
+  void register_frame_listener(GDoorFrameListener *l) { frame_listeners_.push_back(l); }
+
+  // Push-model registration for every pulse train, decoded or not (sniffer);
+  // the RX engine only calls out while someone is registered
+  void register_train_listener(GDoorTrainListener *l);
+
+  // Push-model registration for call session changes; the session tracker
+  // only runs while someone is registered
+  void register_session_listener(GDoorSessionListener *l) { session_listeners_.push_back(l); }
+  // A call without any frame for this long is ended as timed out
+  void set_session_timeout(uint32_t session_timeout) { this->session_timeout_ = session_timeout; }
+
+  // Learn every bus address with its HW type, persisted; see GDoorDeviceRegistry
+  void set_learn_devices(bool learn_devices) { this->learn_devices_ = learn_devices; }
+  // Lookup by address for filters and lambdas; empty unless learn_devices is on
+  const GDoorDeviceRegistry &device_registry() const { return this->devices_; }
+  void dump_devices() const { this->devices_.dump(millis()); }
+
+  // on_frame automations, called with the decoded frame after dedupe
+  void register_frame_trigger(GDoorFrameTrigger *t) { frame_triggers_.push_back(t); }
 
   void set_last_rx_data(GDOOR_DATA *data);
 
@@ -43,17 +100,89 @@ class GdoorComponent : public Component {
   GPIOPin* rx_pin() const { return rx_pin_; }
   GPIOPin* rx_thresh_pin() const { return rx_thresh_pin_; }
   float rx_sens() const { return rx_sens_; };
+  // Threshold voltage currently applied, NAN if the comparator is not adjustable
+  float rx_threshold() const;
+
+  // Shared timer wheel for deferred entity state changes (binary sensor reset,
+  // BUS_IDLE, gestures), advanced once per loop instead of per-entity loop()
+  GDoorTimerWheel &timer_wheel() { return this->timer_wheel_; }
+
+  // Number of telegram repeats dropped by the dedupe stage since boot
+  uint32_t get_suppressed_repeats() const { return this->suppressed_repeats_; }
+
+  // Decoder health counters and per-stage timing
+  const GDOOR_RX_STATS &rx_stats() const { return this->gdoor_.rx_stats(); }
+  const GDOOR_TX_STATS &tx_stats() const { return this->gdoor_.tx_stats(); }
+  const GDOOR_TIMING &render_timing() const { return this->render_timing_; }
+  const GDOOR_TIMING &dispatch_timing() const { return this->dispatch_timing_; }
+
+  // Entities call this right after publish_state()/trigger() for a frame;
+  // only the first call per frame counts. No-op unless latency tracing is on.
+  void trace_publish() {
+#ifdef USE_GDOOR_LATENCY_TRACE
+    if (this->dispatch_trace_ != nullptr && !this->dispatch_trace_->reached(TRACE_PUBLISHED)) {
+      this->dispatch_trace_->mark(TRACE_PUBLISHED, this->trace_now_());
+    }
+#endif
+  }
+#ifdef USE_GDOOR_LATENCY_TRACE
+  // Stage times of the most recent dispatched frames
+  const GDOOR_TRACE_RING &latency_trace() const { return this->latency_trace_; }
+#endif
 
  protected:
+#ifdef USE_GDOOR_LATENCY_TRACE
+  // Every stage is stamped on the RX clock the edge stamps come from
+  uint32_t trace_now_() const { return (uint32_t) this->gdoor_.now_us(); }
+#endif
+  // Small cache of recently dispatched frames, keyed by frame hash
+  static const uint8_t DEDUPE_CACHE_SIZE = 8;
+  struct RecentFrame {
+    uint32_t hash;
+    uint32_t last_seen;
+    uint16_t len;
+  };
+  bool is_repeat_(const GDOOR_DATA *data, uint32_t now);
+  void track_session_(const GDOOR_DATA_VIEW &frame);
+  void expire_sessions_();
+  void schedule_session_expiry_(uint32_t now);
+
+  GDOOR gdoor_;  // RX/TX engines of this bus
+  uint8_t ledc_channel_{0};
+  uint8_t ledc_timer_{1};
   GPIOPin *tx_pin_{nullptr};
   GPIOPin *tx_en_pin_{nullptr};
   GPIOPin *rx_pin_{nullptr};
   GPIOPin *rx_thresh_pin_{nullptr};
   float rx_sens_{-1};
+  bool rx_auto_calibrate_{false};
+  bool rx_threshold_adjustable_{false};
+  GDoorRxCalibrator rx_calibrator_;
+  GDoorRuleEngine rules_;
+  bool learn_devices_{false};
+  GDoorDeviceRegistry devices_;
   GDOOR_DATA* last_rx_data_{nullptr};
   std::string last_rx_str_;
   uint32_t last_bus_update_{0};
   std::vector<GDoorBusListener *> bus_listeners_;
+  std::vector<GDoorMessageListener *> message_listeners_;
+  std::vector<GDoorFrameListener *> frame_listeners_;
+  std::vector<GDoorTrainListener *> train_listeners_;
+  std::vector<GDoorFrameTrigger *> frame_triggers_;
+  std::vector<GDoorSessionListener *> session_listeners_;
+  GDoorCallSessionTracker call_sessions_;
+  GDoorTimer session_timer_;
+  uint32_t session_timeout_{120000};
+  GDoorTimerWheel timer_wheel_;
+  uint32_t dedupe_window_{0};
+  uint32_t suppressed_repeats_{0};
+  GDOOR_TIMING render_timing_;
+  GDOOR_TIMING dispatch_timing_;
+#ifdef USE_GDOOR_LATENCY_TRACE
+  GDOOR_TRACE *dispatch_trace_{nullptr};  // trace of the frame being dispatched
+  GDOOR_TRACE_RING latency_trace_;
+#endif
+  RecentFrame recent_frames_[DEDUPE_CACHE_SIZE]{};
 };
 
 class PrintToBuffer : public Print {
@@ -64,14 +193,29 @@ class PrintToBuffer : public Print {
       buffer_[0] = '\0';
     }
   }
+  using Print::write;
   virtual size_t write(uint8_t c) override {
-    if (index_ < buffer_size_ - 1) {
+    if (index_ + 1 < buffer_size_) {
       buffer_[index_++] = c;
-      buffer_[index_] = '\0';
       return 1;
     }
     return 0;  // Buffer full.
   }
+  virtual size_t write(const uint8_t *buffer, size_t size) override {
+    if (index_ + 1 >= buffer_size_) return 0;  // Buffer full.
+    size_t room = buffer_size_ - 1 - index_;
+    if (size > room) size = room;
+    memcpy(buffer_ + index_, buffer, size);
+    index_ += size;
+    return size;
+  }
+  // Terminate once when the content is read instead of after every byte
+  const char *c_str() {
+    if (buffer_size_ > 0) {
+      buffer_[index_] = '\0';
+    }
+    return buffer_;
+  }
   size_t size() const { return index_; }
  private:
   char *buffer_;
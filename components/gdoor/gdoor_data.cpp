@@ -15,6 +15,7 @@
  * along with this program. If not, see <http://www.gnu.org/licenses/>.
  */
 #include <map>
+#include <string.h>
 #include "defines.h"
 #include "gdoor_data.h"
 #include "gdoor_utils.h"
@@ -53,16 +54,79 @@ std::map<int, const char*>GDOOR_DATA_ACTION = {
     { 0x00, "CTRL_PROGRAMMING_STOP"}
 };
 
+
+// JSON fragments shared by json_length() and write_json()
+#define JSON_LEN(s) (sizeof(s) - 1)
+static const char J_BUSDATA[]     = "\"busdata\": \"";
+static const char J_RAW[]         = "\", \"raw\": [";
+static const char J_RAW_ITEM[]    = "\"0x";
+static const char J_SEP[]         = ", ";
+static const char J_VALID[]       = "], \"valid\": ";
+static const char J_TRUE[]        = "true";
+static const char J_FALSE[]       = "false";
+static const char J_ACTION[]      = "\"action\": \"";
+static const char J_PARAMETERS[]  = "\", \"parameters\": \"";
+static const char J_SOURCE[]      = "\", \"source\": \"";
+static const char J_DESTINATION[] = "\", \"destination\": \"";
+static const char J_TYPE[]        = "\", \"type\": \"";
+static const char J_BUSDATA_NEXT[] = "\", \"busdata\": \"";
+static const char J_EVENT_ID[]    = "\", \"event_id\": \"";
+static const char J_END[]         = "\"";
+
+static uint32_t event_counter = 0;
+
+static const uint8_t NO_FIELD[3] = {0x00, 0x00, 0x00};
+
+// Protocol JSON shared by GDOOR_DATA_PROTOCOL and GDOOR_DATA_VIEW; parameters
+// are 2 bytes, addresses 3, raw may be NULL (no busdata field)
+static size_t protocol_json_length(const char *action, const char *type, const GDOOR_DATA *raw,
+                                   uint32_t event_id) {
+    size_t n = JSON_LEN(J_ACTION) + strlen(action)
+             + JSON_LEN(J_PARAMETERS) + 2 * 2
+             + JSON_LEN(J_SOURCE) + 2 * 3
+             + JSON_LEN(J_DESTINATION) + 2 * 3
+             + JSON_LEN(J_TYPE) + strlen(type);
+    if (raw != NULL) {
+        n += JSON_LEN(J_BUSDATA_NEXT) + 2 * (size_t)raw->len;
+    }
+    n += JSON_LEN(J_EVENT_ID) + GDOOR_UTILS::dec_len(event_id) + JSON_LEN(J_END);
+    return n;
+}
+
+static char *protocol_write_json(char *out, const char *action, const uint8_t *parameters, const uint8_t *source,
+                                 const uint8_t *destination, const char *type, const GDOOR_DATA *raw,
+                                 uint32_t event_id) {
+    out = GDOOR_UTILS::put_lit(out, J_ACTION);
+    out = GDOOR_UTILS::put_str(out, action, strlen(action));
+    out = GDOOR_UTILS::put_lit(out, J_PARAMETERS);
+    out = GDOOR_UTILS::put_hexbytes(out, parameters, 2);
+    out = GDOOR_UTILS::put_lit(out, J_SOURCE);
+    out = GDOOR_UTILS::put_hexbytes(out, source, 3);
+    out = GDOOR_UTILS::put_lit(out, J_DESTINATION);
+    out = GDOOR_UTILS::put_hexbytes(out, destination, 3);
+    out = GDOOR_UTILS::put_lit(out, J_TYPE);
+    out = GDOOR_UTILS::put_str(out, type, strlen(type));
+    if (raw != NULL) {
+        out = GDOOR_UTILS::put_lit(out, J_BUSDATA_NEXT);
+        out = GDOOR_UTILS::put_hexbytes(out, raw->data, raw->len);
+    }
+    out = GDOOR_UTILS::put_lit(out, J_EVENT_ID);
+    out = GDOOR_UTILS::put_dec(out, event_id);
+    out = GDOOR_UTILS::put_lit(out, J_END);
+    return out;
+}
+
 /**
  * Parse function, reading in the raw timer count values,
  * populating the GDOOR_DATA class elements.
  *
- * @param counts Array with pulse counts of bits
+ * @param counts Array with pulse counts of bits, saturated at 255
  * @param len Number of elements in array
  * @return true if parsing was successful
 */
-bool GDOOR_DATA::parse(uint16_t *counts, uint16_t len) {
-    uint8_t wordcounter = 0; //Current word index
+template<uint16_t WORDS>
+bool GDOOR_DATA_T<WORDS>::parse(const uint8_t *counts, uint16_t len) {
+    typename CAPACITY::word_index_t wordcounter = 0; //Current word index
     uint8_t current_pulsetrain_valid = 1; //If parity or crc fails, this is set to 0
     uint16_t bit_one_thres = 0; //Dynamic Bit 1/0 threshold, based on length of startpulse
 
@@ -70,19 +134,36 @@ bool GDOOR_DATA::parse(uint16_t *counts, uint16_t len) {
     uint8_t bitindex = 0; //Current bit index inside current word, loops from 0 to 8 (9bits per word)
 
     bool success=false;
+    uint16_t min_margin = 100;
+
+    this->parity_errors = 0;
+    this->crc_error = 0;
+    this->filtered_pulses = 0;
+    this->startbits_rejected = 0;
 
-    for (uint8_t i=0; i<len; i++) {
+    if (len > CAPACITY::counts) {
+        len = CAPACITY::counts;
+    }
+#ifdef USE_GDOOR_RAW_CAPTURE
+    this->raw_len = len;
+#endif
+
+    for (typename CAPACITY::bit_index_t i=0; i<len; i++) {
         uint16_t cnt = counts[i];
         uint8_t bit = 0;
-        this->raw[i] = cnt;
+#ifdef USE_GDOOR_RAW_CAPTURE
+        this->raw[i] = counts[i];
+#endif
 
         // Filter out smaller pulses, just ignore them
         if (cnt < BIT_MIN_LEN) {
+            this->filtered_pulses++;
             continue;
         }
 
         // Check that first start bit is at least roughly in our expected range
         if(is_startbit && cnt < STARTBIT_MIN_LEN) {
+            this->startbits_rejected++;
             continue;
         }
 
@@ -103,11 +184,21 @@ bool GDOOR_DATA::parse(uint16_t *counts, uint16_t len) {
                 bit = 1;
             }
 
+            // How clearly this bit was decided, for RX threshold calibration
+            if (bit_one_thres > 0) {
+                uint16_t dist = (cnt < bit_one_thres) ? bit_one_thres - cnt : cnt - bit_one_thres;
+                uint16_t bit_margin = (uint16_t)(((uint32_t)dist * 100) / bit_one_thres);
+                if (bit_margin < min_margin) {
+                    min_margin = bit_margin;
+                }
+            }
+
             // Parity Bit
             if (bitindex == 8) {
                 // Check if parity bit is as expected
                 if (GDOOR_UTILS::parity_odd(this->data[wordcounter]) != bit) {
                     current_pulsetrain_valid = 0;
+                    this->parity_errors++;
                 }
                 bitindex = 0;
                 wordcounter = wordcounter + 1;
@@ -123,9 +214,11 @@ bool GDOOR_DATA::parse(uint16_t *counts, uint16_t len) {
         //Check last word for crc value
         if (GDOOR_UTILS::crc(this->data, wordcounter-1) != this->data[wordcounter-1]) {
             current_pulsetrain_valid = 0;
+            this->crc_error = 1;
         }
         this->len = wordcounter;
         this->valid = current_pulsetrain_valid;
+        this->margin = (uint8_t)min_margin;
         success = true;
     }
     return success;
@@ -149,6 +242,7 @@ GDOOR_DATA_PROTOCOL::GDOOR_DATA_PROTOCOL(GDOOR_DATA* data, bool idle) {
         this->action = "ACTION_UNKOWN";
     }
     this->raw = data;
+    this->event_id = event_counter++;
 
     this->source[0] = 0x00;
     this->source[1] = 0x00;
@@ -182,4 +276,162 @@ GDOOR_DATA_PROTOCOL::GDOOR_DATA_PROTOCOL(GDOOR_DATA* data, bool idle) {
             this->destination[2] = data->data[11];
         }
     }
-}
\ No newline at end of file
+}
+
+/**
+ * Exact number of chars write_json() produces (no terminator).
+ */
+template<uint16_t WORDS>
+size_t GDOOR_DATA_T<WORDS>::json_length() const {
+    size_t n = JSON_LEN(J_BUSDATA) + 2 * (size_t)this->len + JSON_LEN(J_RAW);
+#ifdef USE_GDOOR_RAW_CAPTURE
+    uint16_t raw_len = this->len * 9;
+    for (uint16_t i = 0; i < raw_len; i++) {
+        n += JSON_LEN(J_RAW_ITEM) + GDOOR_UTILS::hex_len(this->raw[i]) + JSON_LEN(J_END);
+    }
+    if (raw_len > 0) {
+        n += (raw_len - 1) * JSON_LEN(J_SEP);
+    }
+#endif
+    n += JSON_LEN(J_VALID) + (this->valid ? JSON_LEN(J_TRUE) : JSON_LEN(J_FALSE));
+    return n;
+}
+
+/**
+ * Render JSON compatible output into out, which must hold json_length() chars.
+ * @return Pointer behind the last written char
+ */
+template<uint16_t WORDS>
+char *GDOOR_DATA_T<WORDS>::write_json(char *out) const {
+    out = GDOOR_UTILS::put_lit(out, J_BUSDATA);
+    out = GDOOR_UTILS::put_hexbytes(out, this->data, this->len);
+    out = GDOOR_UTILS::put_lit(out, J_RAW);
+#ifdef USE_GDOOR_RAW_CAPTURE
+    uint16_t raw_len = this->len * 9;
+    for (uint16_t i = 0; i < raw_len; i++) {
+        if (i != 0) {
+            out = GDOOR_UTILS::put_lit(out, J_SEP);
+        }
+        out = GDOOR_UTILS::put_lit(out, J_RAW_ITEM);
+        out = GDOOR_UTILS::put_hex(out, this->raw[i]);
+        out = GDOOR_UTILS::put_lit(out, J_END);
+    }
+#endif
+    out = GDOOR_UTILS::put_lit(out, J_VALID);
+    if (this->valid) {
+        out = GDOOR_UTILS::put_lit(out, J_TRUE);
+    } else {
+        out = GDOOR_UTILS::put_lit(out, J_FALSE);
+    }
+    return out;
+}
+
+/**
+ * Print JSON compatible output. The raw array can be large,
+ * so it is streamed per element instead of rendered in one buffer.
+ */
+template<uint16_t WORDS>
+size_t GDOOR_DATA_T<WORDS>::printTo(Print& p) const {
+    char buf[JSON_LEN(J_BUSDATA) + 2 * WORDS + JSON_LEN(J_RAW)];
+    size_t r = 0;
+
+    char *out = GDOOR_UTILS::put_lit(buf, J_BUSDATA);
+    out = GDOOR_UTILS::put_hexbytes(out, this->data, this->len);
+    out = GDOOR_UTILS::put_lit(out, J_RAW);
+    r+= p.write(buf, (size_t)(out - buf));
+
+#ifdef USE_GDOOR_RAW_CAPTURE
+    uint16_t raw_len = this->len * 9;
+    for (uint16_t i = 0; i < raw_len; i++) {
+        out = buf;
+        if (i != 0) {
+            out = GDOOR_UTILS::put_lit(out, J_SEP);
+        }
+        out = GDOOR_UTILS::put_lit(out, J_RAW_ITEM);
+        out = GDOOR_UTILS::put_hex(out, this->raw[i]);
+        out = GDOOR_UTILS::put_lit(out, J_END);
+        r+= p.write(buf, (size_t)(out - buf));
+    }
+#endif
+
+    out = GDOOR_UTILS::put_lit(buf, J_VALID);
+    if (this->valid) {
+        out = GDOOR_UTILS::put_lit(out, J_TRUE);
+    } else {
+        out = GDOOR_UTILS::put_lit(out, J_FALSE);
+    }
+    r+= p.write(buf, (size_t)(out - buf));
+    return r;
+}
+
+/**
+ * Exact number of chars write_json() produces (no terminator).
+ */
+size_t GDOOR_DATA_PROTOCOL::json_length() const {
+    return protocol_json_length(this->action, this->type, this->raw, this->event_id);
+}
+
+/**
+ * Render JSON compatible output into out, which must hold json_length() chars.
+ * @return Pointer behind the last written char
+ */
+char *GDOOR_DATA_PROTOCOL::write_json(char *out) const {
+    return protocol_write_json(out, this->action, this->parameters, this->source, this->destination, this->type,
+                               this->raw, this->event_id);
+}
+
+/**
+ * Print JSON compatible output with a single bulk write.
+ * type and action always come from the lookup tables above,
+ * so the rendered object is bounded.
+ */
+size_t GDOOR_DATA_PROTOCOL::printTo(Print& p) const {
+    char buf[192 + 2 * MAX_WORDLEN];
+    if (this->json_length() > sizeof(buf)) {
+        return 0;
+    }
+    char *out = this->write_json(buf);
+    return p.write(buf, (size_t)(out - buf));
+}
+
+uint32_t GDOOR_DATA_VIEW::next_event_id() {
+    return event_counter++;
+}
+
+const char *GDOOR_DATA_VIEW::action() const {
+    if (this->action_name == nullptr) {
+        auto it = decoded() ? GDOOR_DATA_ACTION.find(action_code()) : GDOOR_DATA_ACTION.end();
+        this->action_name = it != GDOOR_DATA_ACTION.end() ? it->second : "ACTION_UNKOWN";
+    }
+    return this->action_name;
+}
+
+const char *GDOOR_DATA_VIEW::type() const {
+    if (this->type_name == nullptr) {
+        auto it = decoded() ? GDOOR_DATA_HWTYPE.find(type_code()) : GDOOR_DATA_HWTYPE.end();
+        this->type_name = it != GDOOR_DATA_HWTYPE.end() ? it->second : "TYPE_UNKOWN";
+    }
+    return this->type_name;
+}
+
+/**
+ * Exact number of chars write_json() produces (no terminator).
+ */
+size_t GDOOR_DATA_VIEW::json_length(uint32_t event_id) const {
+    return protocol_json_length(this->action(), this->type(), this->frame, event_id);
+}
+
+/**
+ * Render the protocol JSON straight from the frame bytes, into out, which
+ * must hold json_length() chars.
+ * @return Pointer behind the last written char
+ */
+char *GDOOR_DATA_VIEW::write_json(char *out, uint32_t event_id) const {
+    const uint8_t *d = this->frame->data;
+    bool fields = decoded();
+    return protocol_write_json(out, this->action(), fields ? d + 6 : NO_FIELD, fields ? d + 3 : NO_FIELD,
+                               has_destination() ? d + 9 : NO_FIELD, this->type(), this->frame, event_id);
+}
+
+// Frame type used by the RX/TX engines of this build
+template class GDOOR_DATA_T<MAX_WORDLEN>;
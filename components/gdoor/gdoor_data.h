@@ -19,35 +19,109 @@
 
 #define GDOOR_DATA_H
 #include <map>
+#include "esphome/core/defines.h" // USE_GDOOR_RAW_CAPTURE, must match in every TU
 #include "gdoor_print.h"
 #include "defines.h"
+#include "gdoor_capacity.h"
+#include "gdoor_latency_trace.h"
 #include "gdoor_utils.h"
 
-class GDOOR_DATA : public Printable { // Class/Struct to collect bus related infos
+template<uint16_t WORDS>
+class GDOOR_DATA_T : public Printable { // Class/Struct to collect bus related infos, room for WORDS words
     public:
+        typedef GDOOR_CAPACITY<WORDS> CAPACITY;
+
         uint16_t len;
-        uint8_t data[MAX_WORDLEN];
-        uint16_t raw[MAX_WORDLEN*9];
+        uint8_t data[WORDS];
+#ifdef USE_GDOOR_RAW_CAPTURE
+        uint8_t raw[CAPACITY::counts]; // pulse counts as received, saturated at 255
+        uint16_t raw_len;            // number of counts in raw
+#endif
         uint8_t valid;
 
-        bool parse(uint16_t *counts, uint16_t len);
+        // Decode diagnostics of the last parse()
+        uint8_t parity_errors;
+        uint8_t crc_error;
+        uint16_t filtered_pulses;
+        uint16_t startbits_rejected;
+        uint8_t margin; // smallest distance of a data bit to the 1/0 threshold, % of threshold (0-100)
+
+        // Bus time of the first and last carrier edge, captured by the RX ISRs
+        // on the esp_timer_get_time() timebase (low 32 bits = micros()),
+        // 1/TIMER_FREQ_RX resolution. Set by GDOOR_RX, not by parse().
+        int64_t start_us;
+        int64_t end_us;
+#ifdef USE_GDOOR_LATENCY_TRACE
+        GDOOR_TRACE trace; // stage times, see gdoor_latency_trace.h
+#endif
+
+        bool parse(const uint8_t *counts, uint16_t len);
+
+        // Direct JSON serializer: exact length up front, then one pass
+        size_t json_length() const;
+        char *write_json(char *out) const;
+
+        virtual size_t printTo(Print& p) const;
+};
+
+// Bus codes of the HW type and action fields to names, in gdoor_data.cpp
+extern std::map<int, const char*> GDOOR_DATA_HWTYPE;
+extern std::map<int, const char*> GDOOR_DATA_ACTION;
 
-        virtual size_t printTo(Print& p) const {
-            size_t r = 0;
+// Frame type of the build, MAX_WORDLEN is set by the gdoor max_words option
+typedef GDOOR_DATA_T<MAX_WORDLEN> GDOOR_DATA;
+
+// Non-owning view on a parsed frame: the bytes as received plus accessors
+// that decode protocol fields only when called. Nothing is copied; the view
+// is valid as long as the GDOOR_DATA behind it. Like GDOOR_DATA_PROTOCOL,
+// fields are only decoded from valid frames of at least 9 bytes and read as
+// 0 / "..._UNKOWN" otherwise.
+class GDOOR_DATA_VIEW {
+    public:
+        explicit GDOOR_DATA_VIEW(const GDOOR_DATA *frame) : frame(frame) {}
 
-            // Json compatible output
-            r+= GDOOR_UTILS::print_json_hexstring<uint8_t>(p, "busdata", data, len);
-            r+= p.print(", ");
+        const GDOOR_DATA *frame;
 
-            r+= GDOOR_UTILS::print_json_hexarray<uint16_t>(p, "raw", raw, len*9);
-            r+= p.print(", ");
+        // Raw frame, incl. CRC
+        const uint8_t *data() const { return frame->data; }
+        uint16_t len() const { return frame->len; }
+        bool valid() const { return frame->valid != 0; }
+        int64_t start_us() const { return frame->start_us; }
+        int64_t end_us() const { return frame->end_us; }
 
-            r+= GDOOR_UTILS::print_json_bool<uint8_t>(p, "valid", valid);
+        bool decoded() const { return frame->valid && frame->len >= 9; }
+        bool has_destination() const { return decoded() && frame->len >= 12; }
+
+        // Bus codes, only meaningful if decoded()
+        uint8_t action_code() const { return frame->data[2]; }
+        uint8_t type_code() const { return frame->data[8]; }
+
+        uint32_t source() const { return decoded() ? address_at(3) : 0; }
+        uint32_t destination() const { return has_destination() ? address_at(9) : 0; }
+        uint16_t parameters() const {
+            return decoded() ? (uint16_t)(frame->data[6] << 8 | frame->data[7]) : 0;
+        }
+        // Names as in the JSON message; looked up on first use, then cached
+        const char *action() const;
+        const char *type() const;
+
+        // Same JSON as GDOOR_DATA_PROTOCOL, event_id from next_event_id()
+        size_t json_length(uint32_t event_id) const;
+        char *write_json(char *out, uint32_t event_id) const;
+        // Shared with GDOOR_DATA_PROTOCOL, one id per rendered message
+        static uint32_t next_event_id();
+
+    private:
+        uint32_t address_at(uint8_t i) const {
+            return (uint32_t)frame->data[i] << 16 | frame->data[i + 1] << 8 | frame->data[i + 2];
+        }
 
-            return r;
-       }
+        mutable const char *action_name = nullptr;
+        mutable const char *type_name = nullptr;
 };
 
+// Eagerly decoded copy of the protocol fields. Kept for the BUS_IDLE message
+// and printTo(); per-frame consumers use GDOOR_DATA_VIEW instead.
 class GDOOR_DATA_PROTOCOL : public Printable { // Class/Struct to collect bus high level protocol data
     public:
         GDOOR_DATA *raw;
@@ -57,37 +131,15 @@ class GDOOR_DATA_PROTOCOL : public Printable { // Class/Struct to collect bus hi
         uint8_t source[3];
         uint8_t destination[3];
 
-        GDOOR_DATA_PROTOCOL(GDOOR_DATA* data, bool idle = false);
-
-        virtual size_t printTo(Print& p) const {
-            size_t r = 0;
-            static uint32_t cnt = 0;
-
-            // Json compatible output
-            r+= GDOOR_UTILS::print_json_string(p, "action", action);
-            r+= p.print(", ");
-
-            r+= GDOOR_UTILS::print_json_hexstring<uint8_t>(p, "parameters", parameters, 2);
-            r+= p.print(", ");
-
-            r+= GDOOR_UTILS::print_json_hexstring<uint8_t>(p, "source", source, 3);
-            r+= p.print(", ");
+        uint32_t event_id;
 
-            r+= GDOOR_UTILS::print_json_hexstring<uint8_t>(p, "destination", destination, 3);
-            r+= p.print(", ");
-
-            r+= GDOOR_UTILS::print_json_string(p, "type", type);
-            r+= p.print(", ");
-
-            if (this->raw != NULL) {
-                r+= GDOOR_UTILS::print_json_hexstring<uint8_t>(p, "busdata", this->raw->data, this->raw->len);
-                r+= p.print(", ");
-            }
+        GDOOR_DATA_PROTOCOL(GDOOR_DATA* data, bool idle = false);
 
-            r+= GDOOR_UTILS::print_json_value<uint32_t>(p, "event_id", cnt++);
+        // Direct JSON serializer: exact length up front, then one pass
+        size_t json_length() const;
+        char *write_json(char *out) const;
 
-            return r;
-        }
+        virtual size_t printTo(Print& p) const;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,281 @@
+/* 
+ * This file is part of the GDoor distribution (https://github.com/gdoor-org).
+ * Copyright (c) 2024 GDoor authors.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include "defines.h"
+#include "gdoor_data_batch.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define GDOOR_BATCH_SSE2
+#endif
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define GDOOR_BATCH_AVX2
+#endif
+
+/*
+ * Vector kernel, one 16-bit lane per frame. All lane values stay below
+ * 0x8000 (counts <= 255, positions <= CAPACITY::counts), so the signed SSE2
+ * compares and min/max are exact for them.
+ */
+#ifdef GDOOR_BATCH_SSE2
+struct GDOOR_BATCH_SSE2_OPS {
+    typedef __m128i V;
+    static const uint16_t LANES = 8;
+
+    static V counts(const uint8_t *p) {
+        return _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)p), _mm_setzero_si128());
+    }
+    static V load(const uint16_t *p) { return _mm_loadu_si128((const __m128i *)p); }
+    static void store(uint16_t *p, V v) { _mm_storeu_si128((__m128i *)p, v); }
+    static V set1(uint16_t x) { return _mm_set1_epi16((short)x); }
+    static V add(V a, V b) { return _mm_add_epi16(a, b); }
+    static V sub(V a, V b) { return _mm_sub_epi16(a, b); }
+    static V and_(V a, V b) { return _mm_and_si128(a, b); }
+    static V andnot(V a, V b) { return _mm_andnot_si128(a, b); } // ~a & b
+    static V or_(V a, V b) { return _mm_or_si128(a, b); }
+    static V xor_(V a, V b) { return _mm_xor_si128(a, b); }
+    static V lt(V a, V b) { return _mm_cmplt_epi16(a, b); }
+    static V eq(V a, V b) { return _mm_cmpeq_epi16(a, b); }
+    static V min(V a, V b) { return _mm_min_epi16(a, b); }
+    static V max(V a, V b) { return _mm_max_epi16(a, b); }
+    static V mulhi(V a, V b) { return _mm_mulhi_epu16(a, b); }
+    static V shr2(V a) { return _mm_srli_epi16(a, 2); }
+    static uint32_t mask(V m) { return (uint32_t)_mm_movemask_epi8(m) & 0x5555; } // bit 2 * lane
+};
+#endif
+
+#ifdef GDOOR_BATCH_AVX2
+struct GDOOR_BATCH_AVX2_OPS {
+    typedef __m256i V;
+    static const uint16_t LANES = 16;
+
+    static V counts(const uint8_t *p) { return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)p)); }
+    static V load(const uint16_t *p) { return _mm256_loadu_si256((const __m256i *)p); }
+    static void store(uint16_t *p, V v) { _mm256_storeu_si256((__m256i *)p, v); }
+    static V set1(uint16_t x) { return _mm256_set1_epi16((short)x); }
+    static V add(V a, V b) { return _mm256_add_epi16(a, b); }
+    static V sub(V a, V b) { return _mm256_sub_epi16(a, b); }
+    static V and_(V a, V b) { return _mm256_and_si256(a, b); }
+    static V andnot(V a, V b) { return _mm256_andnot_si256(a, b); }
+    static V or_(V a, V b) { return _mm256_or_si256(a, b); }
+    static V xor_(V a, V b) { return _mm256_xor_si256(a, b); }
+    static V lt(V a, V b) { return _mm256_cmpgt_epi16(b, a); }
+    static V eq(V a, V b) { return _mm256_cmpeq_epi16(a, b); }
+    static V min(V a, V b) { return _mm256_min_epi16(a, b); }
+    static V max(V a, V b) { return _mm256_max_epi16(a, b); }
+    static V mulhi(V a, V b) { return _mm256_mulhi_epu16(a, b); }
+    static V shr2(V a) { return _mm256_srli_epi16(a, 2); }
+    static uint32_t mask(V m) { return (uint32_t)_mm256_movemask_epi8(m) & 0x55555555; }
+};
+#endif
+
+#if defined(GDOOR_BATCH_SSE2) || defined(GDOOR_BATCH_AVX2)
+/*
+ * Decode OPS::LANES frames starting at out. Mirrors GDOOR_DATA_T::parse()
+ * step for step; lanes past their own length are masked off.
+ */
+template<class OPS, uint16_t WORDS>
+static void decode_block(const uint8_t *counts, size_t stride, const uint16_t *lens,
+                         GDOOR_DATA_T<WORDS> *out, bool *parsed) {
+    typedef typename OPS::V V;
+    const uint16_t N = OPS::LANES;
+    uint16_t len[N], maxlen = 0;
+    for (uint16_t f = 0; f < N; f++) {
+        len[f] = lens[f] > GDOOR_CAPACITY<WORDS>::counts ? GDOOR_CAPACITY<WORDS>::counts : lens[f];
+        maxlen = len[f] > maxlen ? len[f] : maxlen;
+    }
+    const V zero = OPS::set1(0);
+    const V one = OPS::set1(1);
+    const V vlen = OPS::load(len);
+
+    V start    = OPS::eq(zero, zero); // still waiting for the start bit
+    V thres    = zero;                // bit 1/0 threshold from the start bit
+    V bitindex = zero;
+    V bitvalue = one;                 // 1 << bitindex
+    V word     = zero;                // word being received
+    V parity   = zero;                // odd parity of its data bits so far
+    V sum      = zero;                // of all completed words
+    V last     = zero;                // last completed word
+    V words    = zero;
+    V parity_errors = zero, filtered = zero, rejected = zero;
+    V min_dist = OPS::set1(0x7FFF);   // closest bit to the threshold
+    V broken   = zero;                // parity error seen
+
+    uint16_t lane_word[N], lane_words[N];
+    for (uint16_t i = 0; i < maxlen; i++) {
+        V cnt = OPS::counts(counts + (size_t)i * stride);
+        V active = OPS::lt(OPS::set1(i), vlen);
+
+        // Filter out smaller pulses, just ignore them
+        V short_pulse = OPS::and_(active, OPS::lt(cnt, OPS::set1(BIT_MIN_LEN)));
+        filtered = OPS::sub(filtered, short_pulse);
+        V kept = OPS::andnot(short_pulse, active);
+
+        // Start bit in range sets the threshold (cnt / BIT_ONE_DIV == 2 * cnt / 5)
+        V at_start = OPS::and_(kept, start);
+        V reject = OPS::and_(at_start, OPS::lt(cnt, OPS::set1(STARTBIT_MIN_LEN)));
+        rejected = OPS::sub(rejected, reject);
+        V new_start = OPS::andnot(reject, at_start);
+        V t = OPS::shr2(OPS::mulhi(OPS::add(cnt, cnt), OPS::set1(0xCCCD)));
+        thres = OPS::or_(OPS::and_(new_start, t), OPS::andnot(new_start, thres));
+        V normal = OPS::andnot(start, kept);
+        start = OPS::andnot(new_start, start);
+
+        // Normal bit: 1 if shorter than the threshold
+        V is_one = OPS::lt(cnt, thres);
+        V dist = OPS::sub(OPS::max(cnt, thres), OPS::min(cnt, thres));
+        min_dist = OPS::or_(OPS::and_(normal, OPS::min(min_dist, dist)), OPS::andnot(normal, min_dist));
+
+        V at_parity = OPS::and_(normal, OPS::eq(bitindex, OPS::set1(8)));
+        V at_data = OPS::andnot(at_parity, normal);
+        V data_one = OPS::and_(at_data, is_one);
+        word = OPS::or_(word, OPS::and_(data_one, bitvalue));
+        parity = OPS::xor_(parity, OPS::and_(data_one, one));
+        bitindex = OPS::sub(bitindex, at_data);
+        bitvalue = OPS::add(bitvalue, OPS::and_(at_data, bitvalue));
+
+        // Parity bit closes the word
+        uint32_t closing = OPS::mask(at_parity);
+        if (closing == 0) {
+            continue;
+        }
+        V error = OPS::andnot(OPS::eq(parity, OPS::and_(is_one, one)), at_parity);
+        parity_errors = OPS::sub(parity_errors, error);
+        broken = OPS::or_(broken, error);
+        OPS::store(lane_word, word);
+        OPS::store(lane_words, words);
+        for (; closing != 0; closing &= closing - 1) {
+            uint16_t f = (uint16_t)(__builtin_ctz(closing) / 2);
+            out[f].data[lane_words[f]] = (uint8_t)lane_word[f];
+        }
+        sum = OPS::add(sum, OPS::and_(at_parity, word));
+        last = OPS::or_(OPS::and_(at_parity, word), OPS::andnot(at_parity, last));
+        words = OPS::sub(words, at_parity);
+        word = OPS::andnot(at_parity, word);
+        parity = OPS::andnot(at_parity, parity);
+        bitindex = OPS::andnot(at_parity, bitindex);
+        bitvalue = OPS::or_(OPS::and_(at_parity, one), OPS::andnot(at_parity, bitvalue));
+    }
+
+    uint16_t l_thres[N], l_bitindex[N], l_sum[N], l_last[N], l_perr[N], l_filtered[N], l_rejected[N],
+             l_min_dist[N], l_broken[N];
+    OPS::store(lane_word, word);
+    OPS::store(lane_words, words);
+    OPS::store(l_thres, thres);
+    OPS::store(l_bitindex, bitindex);
+    OPS::store(l_sum, sum);
+    OPS::store(l_last, last);
+    OPS::store(l_perr, parity_errors);
+    OPS::store(l_filtered, filtered);
+    OPS::store(l_rejected, rejected);
+    OPS::store(l_min_dist, min_dist);
+    OPS::store(l_broken, broken);
+    for (uint16_t f = 0; f < N; f++) {
+        GDOOR_DATA_T<WORDS> &d = out[f];
+        d.parity_errors = (uint8_t)l_perr[f];
+        d.crc_error = 0;
+        d.filtered_pulses = l_filtered[f];
+        d.startbits_rejected = l_rejected[f];
+#ifdef USE_GDOOR_RAW_CAPTURE
+        d.raw_len = len[f];
+        for (uint16_t i = 0; i < len[f]; i++) {
+            d.raw[i] = counts[(size_t)i * stride + f];
+        }
+#endif
+        // parse() builds the word in place, so a word cut short is in data too
+        if (l_bitindex[f] != 0) {
+            d.data[lane_words[f]] = (uint8_t)lane_word[f];
+        }
+        parsed[f] = lane_words[f] != 0;
+        if (!parsed[f]) {
+            continue;
+        }
+        uint8_t last_word = (uint8_t)l_last[f];
+        d.crc_error = (uint8_t)(l_sum[f] - last_word) != last_word;
+        d.len = lane_words[f];
+        d.valid = !l_broken[f] && !d.crc_error;
+        // floor() is monotonic, so the closest bit gives the smallest margin
+        uint32_t margin = (uint32_t)l_min_dist[f] * 100 / l_thres[f];
+        d.margin = (uint8_t)(margin < 100 ? margin : 100);
+    }
+}
+
+template<class OPS, uint16_t WORDS>
+static size_t decode_blocks(const uint8_t *counts, size_t stride, const uint16_t *lens, size_t first,
+                            size_t frames, GDOOR_DATA_T<WORDS> *out, bool *parsed) {
+    size_t f = first;
+    for (; f + OPS::LANES <= frames; f += OPS::LANES) {
+        decode_block<OPS, WORDS>(counts + f, stride, lens + f, out + f, parsed + f);
+    }
+    return f;
+}
+#endif
+
+template<uint16_t WORDS>
+typename GDOOR_DATA_BATCH_T<WORDS>::ISA GDOOR_DATA_BATCH_T<WORDS>::best_isa() {
+#if defined(GDOOR_BATCH_AVX2)
+    return ISA_AVX2;
+#elif defined(GDOOR_BATCH_SSE2)
+    return ISA_SSE2;
+#else
+    return ISA_SCALAR;
+#endif
+}
+
+template<uint16_t WORDS>
+bool GDOOR_DATA_BATCH_T<WORDS>::supported(ISA isa) {
+    return isa <= best_isa();
+}
+
+template<uint16_t WORDS>
+const char *GDOOR_DATA_BATCH_T<WORDS>::isa_name(ISA isa) {
+    switch (isa) {
+        case ISA_SSE2: return "SSE2";
+        case ISA_AVX2: return "AVX2";
+        default:       return "scalar";
+    }
+}
+
+template<uint16_t WORDS>
+void GDOOR_DATA_BATCH_T<WORDS>::parse(const uint8_t *counts, size_t stride, const uint16_t *lens, size_t frames,
+                                      GDOOR_DATA_T<WORDS> *out, bool *parsed, ISA isa) {
+    size_t f = 0;
+#ifdef GDOOR_BATCH_AVX2
+    if (isa >= ISA_AVX2) {
+        f = decode_blocks<GDOOR_BATCH_AVX2_OPS, WORDS>(counts, stride, lens, f, frames, out, parsed);
+    }
+#endif
+#ifdef GDOOR_BATCH_SSE2
+    if (isa >= ISA_SSE2) {
+        f = decode_blocks<GDOOR_BATCH_SSE2_OPS, WORDS>(counts, stride, lens, f, frames, out, parsed);
+    }
+#endif
+    // Rest (and everything without SIMD): the reference path
+    uint8_t train[CAPACITY::counts];
+    for (; f < frames; f++) {
+        uint16_t len = lens[f] > CAPACITY::counts ? CAPACITY::counts : lens[f];
+        for (uint16_t i = 0; i < len; i++) {
+            train[i] = counts[(size_t)i * stride + f];
+        }
+        parsed[f] = out[f].parse(train, len);
+    }
+}
+
+// Batch decoder of this build
+template class GDOOR_DATA_BATCH_T<MAX_WORDLEN>;
@@ -0,0 +1,74 @@
+/* 
+ * This file is part of the GDoor distribution (https://github.com/gdoor-org).
+ * Copyright (c) 2024 GDoor authors.
+ * 
+ * This program is free software: you can redistribute it and/or modify  
+ * it under the terms of the GNU General Public License as published by  
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but 
+ * WITHOUT ANY WARRANTY; without even the implied warranty of 
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License 
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Batch decoder for bulk processing on a host: offline analysis of captures
+ * and regression runs over millions of pulse trains.
+ *
+ * Every frame decodes to exactly what GDOOR_DATA_T::parse() makes of it, bit
+ * for bit (data, len, valid, diagnostics, raw copy; and like parse(), a train
+ * without a word leaves len, valid and margin alone). The per-count work -
+ * filtering, start bit threshold, 1/0 classification, parity and the CRC
+ * sum - runs across frames: one vector lane per frame, one step per count.
+ * The input is a structure of arrays so each step is one load:
+ *
+ *   count i of frame f at counts[i * stride + f], stride >= frames
+ *
+ * Each group of lanes runs for as many steps as its longest frame, and every
+ * step reads one row, so hand over blocks of a few hundred frames of similar
+ * length: gdoor_archive uses 256, which keeps the rows in cache.
+ *
+ * SSE2 is used on any x86 host, AVX2 when the compiler targets it (-mavx2 or
+ * -march=native). Elsewhere, e.g. on the ESP32, ISA_SCALAR runs parse() per
+ * frame, so callers need no special case.
+ */
+#ifndef GDOOR_DATA_BATCH_H
+#define GDOOR_DATA_BATCH_H
+#include <stddef.h>
+#include <stdint.h>
+#include "gdoor_data.h"
+
+template<uint16_t WORDS>
+class GDOOR_DATA_BATCH_T {
+    public:
+        typedef GDOOR_CAPACITY<WORDS> CAPACITY;
+
+        enum ISA : uint8_t {
+            ISA_SCALAR, // parse() per frame, the reference
+            ISA_SSE2,   // 8 frames per step
+            ISA_AVX2,   // 16 frames per step
+        };
+
+        // Widest instruction set this build can use
+        static ISA best_isa();
+        static bool supported(ISA isa);
+        static const char *isa_name(ISA isa);
+
+        /*
+         * Decode frames 0 .. frames-1. lens[f] counts of frame f are read
+         * (clamped to CAPACITY::counts like parse() does); the result goes to
+         * out[f] and parse()'s return value to parsed[f]. An unsupported isa
+         * falls back to ISA_SCALAR.
+         */
+        static void parse(const uint8_t *counts, size_t stride, const uint16_t *lens, size_t frames,
+                          GDOOR_DATA_T<WORDS> *out, bool *parsed, ISA isa = best_isa());
+};
+
+// Batch decoder of this build, sized by MAX_WORDLEN
+typedef GDOOR_DATA_BATCH_T<MAX_WORDLEN> GDOOR_DATA_BATCH;
+
+#endif
@@ -0,0 +1,144 @@
+#include "gdoor_device_registry.h"
+#include <cinttypes>
+#include <memory>
+#include "gdoor_data.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+static const char *TAG = "gdoor_esphome.devices";
+
+void GDoorDeviceRegistry::setup(uint32_t key) {
+  this->slots_ = new Device[CAPACITY]();  // NOLINT lives as long as the component
+  this->pref_ = global_preferences->make_preference<Stored>(fnv1_hash("gdoor_devices") ^ key);
+  std::unique_ptr<Stored> stored(new Stored());
+  if (!this->pref_.load(stored.get())) {
+    return;
+  }
+  bool added;
+  for (uint16_t i = 0; i < stored->count && i < MAX_DEVICES; i++) {
+    Device *device = this->learn_(stored->devices[i] >> 8, &added);
+    if (device != nullptr) {
+      device->type = (uint8_t) stored->devices[i];
+    }
+  }
+  ESP_LOGD(TAG, "Restored %u devices", this->count_);
+}
+
+const GDoorDeviceRegistry::Device *GDoorDeviceRegistry::find(uint32_t address) const {
+  if (this->slots_ == nullptr || address == 0) {
+    return nullptr;
+  }
+  for (uint16_t i = 0, slot = slot_(address); i < CAPACITY; i++, slot = (slot + 1) & (CAPACITY - 1)) {
+    const Device &device = this->slots_[slot];
+    if (device.address == address) {
+      return &device;
+    }
+    if (device.address == 0) {
+      return nullptr;
+    }
+  }
+  return nullptr;
+}
+
+GDoorDeviceRegistry::Device *GDoorDeviceRegistry::learn_(uint32_t address, bool *added) {
+  *added = false;
+  for (uint16_t i = 0, slot = slot_(address); i < CAPACITY; i++, slot = (slot + 1) & (CAPACITY - 1)) {
+    Device &device = this->slots_[slot];
+    if (device.address == address) {
+      return &device;
+    }
+    if (device.address == 0) {
+      if (this->count_ >= MAX_DEVICES) {
+        this->rejected_++;
+        return nullptr;  // keep the load factor, and so the probe length, bounded
+      }
+      device.address = address;
+      this->count_++;
+      *added = true;
+      return &device;
+    }
+  }
+  return nullptr;
+}
+
+bool GDoorDeviceRegistry::on_frame(const GDOOR_DATA_VIEW &frame, uint32_t now) {
+  if (this->slots_ == nullptr || !frame.decoded()) {
+    return false;
+  }
+  bool changed = false;
+  bool source_added = false;
+  uint32_t source = frame.source();
+  uint8_t type = frame.type_code();
+  Device *device = source != 0 ? this->learn_(source, &source_added) : nullptr;
+  if (device != nullptr) {
+    if (device->type != type) {
+      device->type = type;
+      changed = true;
+    }
+    if (device->frames != UINT16_MAX) {
+      device->frames++;
+    }
+    device->last_seen = now;
+  }
+  if (frame.has_destination()) {
+    bool added;
+    uint32_t destination = frame.destination();
+    device = destination != 0 ? this->learn_(destination, &added) : nullptr;
+    if (device != nullptr) {
+      device->last_seen = now;
+      changed |= added;
+    }
+  }
+  if (source_added) {
+    ESP_LOGI(TAG, "New device %06" PRIX32 " (%s), %u known", source, type_name(type), this->count_);
+  }
+  if (changed || source_added) {
+    this->persist_();
+  }
+  return source_added;
+}
+
+/*
+ * Hand the whole table to the preferences store. It only reaches flash with
+ * the next preferences sync (flash_write_interval), so a burst of new devices
+ * costs one write.
+ */
+void GDoorDeviceRegistry::persist_() {
+  std::unique_ptr<Stored> stored(new Stored());
+  this->for_each([&stored](const Device &device) {
+    if (stored->count < MAX_DEVICES) {
+      stored->devices[stored->count++] = device.address << 8 | device.type;
+    }
+  });
+  this->pref_.save(stored.get());
+}
+
+const char *GDoorDeviceRegistry::type_name(uint8_t type) {
+  auto it = GDOOR_DATA_HWTYPE.find(type);
+  return it != GDOOR_DATA_HWTYPE.end() ? it->second : "UNKNOWN";
+}
+
+void GDoorDeviceRegistry::dump(uint32_t now) const {
+  ESP_LOGI(TAG, "Devices (%u of %u):", this->count_, MAX_DEVICES);
+  this->for_each([now](const Device &device) {
+    if (device.last_seen == 0) {
+      ESP_LOGI(TAG, "  %06" PRIX32 " %-15s not seen since boot", device.address, type_name(device.type));
+    } else {
+      ESP_LOGI(TAG, "  %06" PRIX32 " %-15s %5u frames, last %" PRIu32 " s ago", device.address,
+               type_name(device.type), device.frames, (now - device.last_seen) / 1000);
+    }
+  });
+}
+
+void GDoorDeviceRegistry::dump_config() const {
+  ESP_LOGCONFIG(TAG, "  Device registry: %u of %u devices", this->count_, MAX_DEVICES);
+  if (this->rejected_ > 0) {
+    ESP_LOGCONFIG(TAG, "    Rejected, table full: %" PRIu32, this->rejected_);
+  }
+}
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
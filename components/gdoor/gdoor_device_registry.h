@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include "esphome/core/preferences.h"
+#include "gdoor_data.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+/// Every address heard on the bus, with the HW type it announces in its own
+/// frames and when it was last heard. Open addressing with linear probing
+/// over a fixed power-of-two table, allocated once in setup(); devices are
+/// never removed, so there are no tombstones and a lookup stops at the first
+/// free slot. Addresses and types survive reboots through the preferences
+/// store (NVS on ESP32); last-seen times and frame counts are since boot.
+///
+/// Sized for a large building: 256 slots hold up to 192 devices (75% load,
+/// a few probes per lookup at most), 12 bytes per slot in RAM and 4 bytes
+/// per device in NVS.
+class GDoorDeviceRegistry {
+ public:
+  static const uint16_t CAPACITY = 256;
+  static const uint16_t MAX_DEVICES = 192;
+
+  struct Device {
+    uint32_t address;    // 3-byte bus address, 0 = free slot
+    uint8_t type;        // HW type byte of its own frames, 0 = only seen as destination
+    uint8_t reserved;
+    uint16_t frames;     // frames sent since boot, saturating
+    uint32_t last_seen;  // millis() of the last frame from or to it, 0 = not since boot
+  };
+
+  // Allocate the table and restore the persisted devices; key tells the
+  // stores of several buses apart
+  void setup(uint32_t key);
+  bool enabled() const { return this->slots_ != nullptr; }
+
+  // Learn source (with its type) and destination of a valid frame.
+  // Returns true if the source was not known before.
+  bool on_frame(const GDOOR_DATA_VIEW &frame, uint32_t now);
+  // Device with this address, nullptr if never seen
+  const Device *find(uint32_t address) const;
+  uint16_t size() const { return this->count_; }
+
+  // Calls f(device) for every known device, in table order
+  template<typename F> void for_each(F &&f) const {
+    for (uint16_t i = 0; this->slots_ != nullptr && i < CAPACITY; i++) {
+      if (this->slots_[i].address != 0) {
+        f(this->slots_[i]);
+      }
+    }
+  }
+
+  // HW type name as in the JSON message, "UNKNOWN" if none or unknown
+  static const char *type_name(uint8_t type);
+  // Log every device with type, frame count and last seen time
+  void dump(uint32_t now) const;
+  void dump_config() const;
+
+ protected:
+  // Home slot: top 8 bits of a Fibonacci hash
+  static uint16_t slot_(uint32_t address) { return (uint16_t) ((address * 2654435761u) >> 24); }
+  // Slot of address, a new one if absent; nullptr if the table is full
+  Device *learn_(uint32_t address, bool *added);
+  void persist_();
+
+  // Persisted form: address << 8 | type per device
+  struct Stored {
+    uint16_t count;
+    uint32_t devices[MAX_DEVICES];
+  };
+
+  Device *slots_{nullptr};
+  uint16_t count_{0};
+  uint32_t rejected_{0};  // new addresses seen while the table was full
+  ESPPreferenceObject pref_;
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
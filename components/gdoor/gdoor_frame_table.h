@@ -0,0 +1,62 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include "gdoor_utils.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+/// Read-only view on a table of frame patterns that the Python platforms
+/// emit as one `static const uint8_t` array, so it stays in flash and nothing
+/// is copied to the heap at boot. Layout per entry: {len, tag, data[len]},
+/// closed by a len of 0. The tag is up to the platform; the event platform
+/// stores the index of the event type there.
+class GDoorFrameTable {
+ public:
+  GDoorFrameTable() = default;
+  explicit GDoorFrameTable(const uint8_t *table) : table_(table) {}
+
+  bool empty() const { return this->table_ == nullptr || this->table_[0] == 0; }
+
+  // Tag of the first entry equal to data, or -1 if none matches
+  int find(const uint8_t *data, uint16_t len) const {
+    for (const uint8_t *entry = this->table_; entry != nullptr && entry[0] != 0; entry += 2 + entry[0]) {
+      if (entry[0] == len && memcmp(entry + 2, data, len) == 0) {
+        return entry[1];
+      }
+    }
+    return -1;
+  }
+
+  // Data of the entry at position index (0-based), nullptr past the end
+  const uint8_t *at(uint8_t index, uint8_t *len) const {
+    for (const uint8_t *entry = this->table_; entry != nullptr && entry[0] != 0; entry += 2 + entry[0]) {
+      if (index-- == 0) {
+        *len = entry[0];
+        return entry + 2;
+      }
+    }
+    return nullptr;
+  }
+
+  // Calls f(data, len, tag) for every entry
+  template<typename F> void for_each(F &&f) const {
+    for (const uint8_t *entry = this->table_; entry != nullptr && entry[0] != 0; entry += 2 + entry[0]) {
+      f(entry + 2, entry[0], entry[1]);
+    }
+  }
+
+  // Uppercase hex of a frame, as written in the YAML; for dump_config
+  static std::string to_hex(const uint8_t *data, uint16_t len) {
+    std::string hex(2 * (size_t) len, '\0');
+    GDOOR_UTILS::put_hexbytes(&hex[0], data, len);
+    return hex;
+  }
+
+ protected:
+  const uint8_t *table_{nullptr};
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
@@ -0,0 +1,102 @@
+/*
+ * This file is part of the GDoor distribution (https://github.com/gdoor-org).
+ * Copyright (c) 2024 GDoor authors.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Opt-in ISR profiling (USE_GDOOR_ISR_PROFILING, set by `profile_isr: true`
+ * or by configuring an isr_* stats sensor).
+ *
+ * Each profiled ISR owns a GDOOR_ISR_HISTOGRAM and is its only writer, so
+ * recording needs no lock: every field is a single aligned 32-bit store.
+ * The main loop reads the counters racily, which at worst skews a
+ * percentile by the few samples recorded while it reads.
+ *
+ * Buckets are log-linear: exact below 8 cycles, then 4 sub-buckets per
+ * power of two, i.e. at most 25 % relative error over the full 32-bit range.
+ */
+#ifndef GDOOR_ISR_PROFILE_H
+#define GDOOR_ISR_PROFILE_H
+#include <stdint.h>
+// Pull in ESPHome's generated defines first: the histogram members below are
+// conditional and every translation unit must agree on the struct layout.
+#include "esphome/core/defines.h"
+
+#ifdef USE_GDOOR_ISR_PROFILING
+#include "esp_cpu.h"
+#endif
+
+#define GDOOR_ALWAYS_INLINE inline __attribute__((always_inline))
+
+class GDOOR_ISR_HISTOGRAM {
+    public:
+        static const uint8_t BUCKETS = 124;
+
+        volatile uint32_t count = 0;
+        volatile uint32_t min_cycles = UINT32_MAX;
+        volatile uint32_t max_cycles = 0;
+        volatile uint32_t buckets[BUCKETS] = {};
+
+        static GDOOR_ALWAYS_INLINE uint8_t bucket_of(uint32_t cycles) {
+            if (cycles < 8) return (uint8_t)cycles;
+            uint8_t msb = (uint8_t)(31 - __builtin_clz(cycles));
+            return (uint8_t)((msb - 1) * 4 + ((cycles >> (msb - 2)) & 3));
+        }
+
+        static inline uint32_t bucket_floor(uint8_t bucket) {
+            if (bucket < 8) return bucket;
+            uint8_t msb = (uint8_t)(bucket / 4 + 1);
+            return (uint32_t)(4 + bucket % 4) << (msb - 2);
+        }
+
+        GDOOR_ALWAYS_INLINE void record(uint32_t cycles) {
+            buckets[bucket_of(cycles)]++;
+            if (cycles < min_cycles) min_cycles = cycles;
+            if (cycles > max_cycles) max_cycles = cycles;
+            count++;
+        }
+
+        // Lower bound of the bucket holding the given percentile (0-100)
+        uint32_t percentile(float pct) const {
+            uint32_t total = count;
+            if (total == 0) return 0;
+            uint32_t rank = (uint32_t)(total * pct / 100.0f);
+            uint32_t seen = 0;
+            for (uint8_t b = 0; b < BUCKETS; b++) {
+                seen += buckets[b];
+                if (seen > rank) return bucket_floor(b);
+            }
+            return max_cycles;
+        }
+};
+
+#ifdef USE_GDOOR_ISR_PROFILING
+// Scope guard: records the cycles spent from declaration to scope exit,
+// so ISRs with several return paths need a single line.
+class GDOOR_ISR_SCOPE {
+    public:
+        GDOOR_ALWAYS_INLINE GDOOR_ISR_SCOPE(GDOOR_ISR_HISTOGRAM &histogram)
+            : hist(histogram), start(esp_cpu_get_cycle_count()) {}
+        GDOOR_ALWAYS_INLINE ~GDOOR_ISR_SCOPE() { hist.record(esp_cpu_get_cycle_count() - start); }
+    private:
+        GDOOR_ISR_HISTOGRAM &hist;
+        uint32_t start;
+};
+#define GDOOR_ISR_PROFILE(hist) GDOOR_ISR_SCOPE gdoor_isr_scope_(hist)
+#else
+#define GDOOR_ISR_PROFILE(hist) do {} while (0)
+#endif
+
+#endif
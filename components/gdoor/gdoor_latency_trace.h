@@ -0,0 +1,103 @@
+/*
+ * This file is part of the GDoor distribution (https://github.com/gdoor-org).
+ * Copyright (c) 2024 GDoor authors.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Opt-in end-to-end latency tracing (USE_GDOOR_LATENCY_TRACE, set by
+ * `trace_latency: true` or by configuring a latency_* stats sensor).
+ *
+ * Every frame carries a GDOOR_TRACE with the time of each stage it passed,
+ * from the first carrier edge on the bus to the first entity that published
+ * it. All stages are stamped on one clock, the RX GPTIMER (GDOOR::now_us(),
+ * the clock of start_us/end_us), so the differences never mix timebases.
+ * Once dispatched, the trace is copied into a fixed ring of the most recent
+ * frames; percentiles are computed from the ring on demand, so recording
+ * costs a few stores per frame and no allocation.
+ */
+#ifndef GDOOR_LATENCY_TRACE_H
+#define GDOOR_LATENCY_TRACE_H
+#include <stdint.h>
+#include <algorithm>
+// Same as gdoor_isr_profile.h: the trace member of GDOOR_DATA is conditional
+#include "esphome/core/defines.h"
+
+enum GDOOR_TRACE_STAGE : uint8_t {
+    TRACE_FIRST_EDGE = 0, // first carrier edge (RX edge ISR)
+    TRACE_LAST_EDGE,      // last carrier edge (derived in the frame-end alarm)
+    TRACE_FRAME_END,      // frame-end alarm ISR ran
+    TRACE_PARSED,         // GDOOR_RX::loop() decoded the pulse counts
+    TRACE_DECODED,        // protocol decode and JSON render done
+    TRACE_DISPATCHED,     // listeners are being called
+    TRACE_PUBLISHED,      // first publish_state()/trigger() of an entity
+    TRACE_STAGES
+};
+
+struct GDOOR_TRACE {
+    uint32_t at[TRACE_STAGES] = {}; // RX clock µs per stage, 0 = not reached
+
+    void mark(GDOOR_TRACE_STAGE stage, uint32_t us) { at[stage] = us != 0 ? us : 1; }
+    bool reached(GDOOR_TRACE_STAGE stage) const { return at[stage] != 0; }
+};
+
+class GDOOR_TRACE_RING {
+    public:
+        static const uint8_t SIZE = 64; // most recent frames kept
+
+        void push(const GDOOR_TRACE &trace) {
+            traces[head] = trace;
+            head = (head + 1) % SIZE;
+            total++;
+        }
+
+        uint32_t count() const { return total; }
+
+        // Percentile (0-100, nearest rank) of the time from the first edge to
+        // the given stage over the frames in the ring that reached it.
+        // False if none did.
+        bool percentile(GDOOR_TRACE_STAGE stage, float pct, uint32_t *us) const {
+            uint32_t values[SIZE];
+            uint8_t n = 0;
+            uint8_t stored = total < SIZE ? (uint8_t)total : SIZE;
+            for (uint8_t i = 0; i < stored; i++) {
+                const GDOOR_TRACE &t = traces[i];
+                if (t.reached(TRACE_FIRST_EDGE) && t.reached(stage)) {
+                    // Wrap-safe; a stamp before the first edge counts as 0,
+                    // never as ~4.29e9
+                    int32_t us = (int32_t)(t.at[stage] - t.at[TRACE_FIRST_EDGE]);
+                    values[n++] = us > 0 ? (uint32_t)us : 0;
+                }
+            }
+            if (n == 0) return false;
+            uint8_t rank = (uint8_t)std::min<float>(n - 1, n * pct / 100.0f);
+            std::nth_element(values, values + rank, values + n);
+            *us = values[rank];
+            return true;
+        }
+
+        static const char *stage_name(GDOOR_TRACE_STAGE stage) {
+            static const char *const NAMES[TRACE_STAGES] = {
+                "first_edge", "last_edge", "frame_end", "parsed", "decoded", "dispatched", "published",
+            };
+            return NAMES[stage];
+        }
+
+    private:
+        GDOOR_TRACE traces[SIZE];
+        uint8_t head = 0;
+        uint32_t total = 0;
+};
+
+#endif
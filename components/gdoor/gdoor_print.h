@@ -36,6 +36,8 @@
 // ---------------------------------------------------------------------------
 // Print — abstract base class; subclasses implement write(uint8_t).
 // Provides print() overloads for strings and integer types.
+// Subclasses may override the bulk write(buffer, size) for a faster sink;
+// every string helper funnels into it, as in Arduino's Print.
 // ---------------------------------------------------------------------------
 class Print {
 public:
@@ -44,12 +46,20 @@ public:
     // --- pure virtual byte sink ---
     virtual size_t write(uint8_t c) = 0;
 
+    // --- bulk sink, default falls back to the byte sink ---
+    virtual size_t write(const uint8_t *buffer, size_t size) {
+        size_t n = 0;
+        while (size--) n += write(*buffer++);
+        return n;
+    }
+    size_t write(const char *buffer, size_t size) {
+        return write((const uint8_t *)buffer, size);
+    }
+
     // --- string helpers ---
     size_t write(const char *s) {
         if (!s) return 0;
-        size_t n = 0;
-        while (*s) n += write((uint8_t)*s++);
-        return n;
+        return write((const uint8_t *)s, strlen(s));
     }
     size_t print(const char *s) { return write(s); }
 
@@ -82,7 +92,7 @@ private:
                 value /= (uint32_t)base;
             }
         }
-        return write(p);
+        return write(p, (size_t)(buf + sizeof(buf) - 1 - p));
     }
 };
 
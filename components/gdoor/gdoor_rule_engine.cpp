@@ -0,0 +1,111 @@
+#include "gdoor_rule_engine.h"
+#include <cinttypes>
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+static const char *TAG = "gdoor_esphome.rules";
+
+void GDoorRuleEngine::set_rules(const uint8_t *match_table, const uint8_t *send_table, const uint32_t *delays_us,
+                                const uint8_t *max_per_minute, uint8_t count) {
+  this->match_ = GDoorFrameTable(match_table);
+  this->send_ = GDoorFrameTable(send_table);
+  this->delays_us_ = delays_us;
+  this->max_per_minute_ = max_per_minute;
+  this->count_ = count;
+  // Sized once; every rule starts with a full bucket
+  this->states_.assign(count, RuleState{});
+  for (uint8_t i = 0; i < count; i++) {
+    this->states_[i].tokens = max_per_minute[i];
+  }
+}
+
+bool GDoorRuleEngine::take_token_(uint8_t rule, uint32_t now) {
+  RuleState &state = this->states_[rule];
+  float limit = this->max_per_minute_[rule];
+  state.tokens += (now - state.refilled) * limit / 60000.0f;
+  if (state.tokens > limit) {
+    state.tokens = limit;
+  }
+  state.refilled = now;
+  if (state.tokens < 1.0f) {
+    return false;
+  }
+  state.tokens -= 1.0f;
+  return true;
+}
+
+void GDoorRuleEngine::on_frame(const GDOOR_DATA_VIEW &frame, uint32_t now) {
+  if (!frame.valid()) {
+    return;
+  }
+  // Several rules may share a match frame, so walk the whole table
+  this->match_.for_each([&](const uint8_t *data, uint8_t len, uint8_t rule) {
+    if (len != frame.len() || memcmp(data, frame.data(), len) != 0) {
+      return;
+    }
+    RuleState &state = this->states_[rule];
+    if (state.pending || !this->take_token_(rule, now)) {
+      state.limited++;
+      ESP_LOGV(TAG, "Rule %u matched, rate limited", rule);
+      return;
+    }
+    state.frame_end_us = frame.end_us();
+    state.pending = true;
+    if (this->pending_++ == 0) {
+      this->high_freq_.start();
+    }
+  });
+}
+
+void GDoorRuleEngine::loop(GDOOR &bus) {
+  if (this->pending_ == 0) {
+    return;
+  }
+  // The clock of frame_end_us, which send_at() counts on as well
+  int64_t now = bus.now_us();
+  for (uint8_t rule = 0; rule < this->count_; rule++) {
+    RuleState &state = this->states_[rule];
+    if (!state.pending) {
+      continue;
+    }
+    int64_t due_us = state.frame_end_us + this->delays_us_[rule];
+    if (due_us - now > (int64_t) GDOOR_TX::SEND_AT_AHEAD_MAX_US) {
+      continue;  // too early to arm the TX timer
+    }
+    uint8_t len = 0;
+    const uint8_t *reply = this->send_.at(rule, &len);
+    // Never talk over a telegram in flight; send_at() refuses a busy TX itself
+    bool sent = !bus.active() && bus.send_at(reply, len, state.frame_end_us, this->delays_us_[rule]);
+    if (!sent && now - due_us < SEND_WINDOW_US) {
+      continue;  // retried next loop
+    }
+    state.pending = false;
+    if (--this->pending_ == 0) {
+      this->high_freq_.stop();
+    }
+    if (!sent) {
+      state.dropped++;
+      ESP_LOGW(TAG, "Rule %u reply dropped, bus busy for %" PRId64 "us", rule, now - due_us);
+      continue;
+    }
+    state.fired++;
+    ESP_LOGD(TAG, "Rule %u reply armed", rule);
+  }
+}
+
+void GDoorRuleEngine::dump_config() {
+  ESP_LOGCONFIG(TAG, "  Rules: %u", this->count_);
+  for (uint8_t rule = 0; rule < this->count_; rule++) {
+    const RuleState &state = this->states_[rule];
+    ESP_LOGCONFIG(TAG,
+                  "    #%u: delay %" PRIu32 "us, max %u/min, fired %" PRIu32 ", limited %" PRIu32
+                  ", dropped %" PRIu32,
+                  rule, this->delays_us_[rule], this->max_per_minute_[rule], state.fired, state.limited,
+                  state.dropped);
+  }
+}
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
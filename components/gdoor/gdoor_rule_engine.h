@@ -0,0 +1,58 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "esphome/core/helpers.h"
+#include "gdoor.h"
+#include "gdoor_frame_table.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+/// Local reactions without a round trip to Home Assistant: "when telegram X
+/// is received, send telegram Y Z µs after its end, at most N times per
+/// minute". The rules are compiled by the codegen into flash tables (match
+/// and reply frame tables tagged with the rule index, delay and limit arrays)
+/// and checked right after the RX engine hands over a frame, before JSON
+/// rendering, dedupe and entity dispatch. Replies are armed through
+/// GDOOR::send_at(), so the delay is counted by the TX timer, not the loop.
+class GDoorRuleEngine {
+ public:
+  void set_rules(const uint8_t *match_table, const uint8_t *send_table, const uint32_t *delays_us,
+                 const uint8_t *max_per_minute, uint8_t count);
+  bool empty() const { return this->count_ == 0; }
+
+  // Every frame from the RX engine, repeats included
+  void on_frame(const GDOOR_DATA_VIEW &frame, uint32_t now);
+  // Sends the replies that are due; call every loop, right after on_frame()
+  void loop(GDOOR &bus);
+  void dump_config();
+
+ protected:
+  // A reply that cannot go out (bus busy) is retried this long, then dropped
+  static const int64_t SEND_WINDOW_US = 200000;
+
+  struct RuleState {
+    int64_t frame_end_us;  // end_us of the matched frame, the delay counts from here
+    bool pending;
+    float tokens;          // token bucket, max_per_minute_[i] deep
+    uint32_t refilled;     // millis() of the last refill
+    uint32_t fired;
+    uint32_t limited;      // matches dropped by the rate limit or a pending reply
+    uint32_t dropped;      // replies the bus was too busy for
+  };
+
+  bool take_token_(uint8_t rule, uint32_t now);
+
+  GDoorFrameTable match_;
+  GDoorFrameTable send_;
+  const uint32_t *delays_us_{nullptr};
+  const uint8_t *max_per_minute_{nullptr};
+  uint8_t count_{0};
+  uint8_t pending_{0};
+  std::vector<RuleState> states_;
+  // Loop at full speed while a reply waits, so it is armed before it is due
+  HighFrequencyLoopRequester high_freq_;
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
@@ -18,7 +18,7 @@
 /*
  * RX implementation for ESPHome >= v2025.6.3 (ESP-IDF / Arduino-ESP32 v3).
  *
- * Strategy: mirrors gdoor-alt exactly, only hardware API wrappers change:
+ * Strategy: mirrors gdoor-alt, only hardware API wrappers change:
  *   - hw_timer_t  → ESP-IDF GPTIMER (driver/gptimer.h)
  *   - timerWrite(timer, 0) / timerStart() from GPIO ISR
  *       → gptimer_get_raw_count() + gptimer_set_alarm_action() from GPIO ISR
@@ -27,6 +27,11 @@
  *       → alarm auto-disables after firing (auto_reload_on_alarm = false)
  *   - "always running timer + alarm deadline" replaces start/stop per edge
  *
+ * Each GDOOR_RX instance owns one GPTIMER. The old bit-end and frame-end
+ * timers are folded into a single alarm that first fires at bit end and is
+ * then pushed out to the frame-end deadline, so two buses fit into the
+ * four GPTIMERs of an ESP32 (one RX + one TX timer per bus).
+ *
  * Timing (120 kHz = 8.33 µs/tick):
  *   BIT_TIMEOUT_TICKS       = 20  → 166.7 µs  (bit-end detection)
  *   BITSTREAM_TIMEOUT_TICKS = 270 → 2250  µs  (frame-end detection)
@@ -37,6 +42,9 @@
 #include "gdoor_data.h"
 #include "gdoor_utils.h"
 #include "esphome/core/log.h"
+#include "esp_timer.h"
+#include "esp_clk_tree.h"
+#include <inttypes.h>
 
 static const char *TAG = "gdoor_esphome.gdoor_rx";
 
@@ -49,214 +57,316 @@ static const char *TAG = "gdoor_esphome.gdoor_rx";
 // = 6 × 45 = 270 ticks at 120kHz.
 #define BITSTREAM_TIMEOUT_TICKS (6u * STARTBIT_MIN_LEN)  // = 270
 
-namespace GDOOR_RX {
-
-    // -------------------------------------------------------------------------
-    // State — all accessed from ISR context, so volatile
-    // -------------------------------------------------------------------------
-    static volatile uint16_t counts[MAX_WORDLEN * 9]; // pulse counts per bit burst
-    static volatile uint16_t isr_cnt    = 0;           // edges counted in current burst
-    static volatile uint8_t  bitcounter = 0;           // number of complete bits stored
-
-    uint16_t rx_state = 0; // state flags (extern in header for active() check)
-
-    static GDOOR_DATA retval;
-
-    static gptimer_handle_t timer_bit_received       = nullptr;
-    static gptimer_handle_t timer_bitstream_received = nullptr;
-
-    static uint8_t pin_rx = 0;
-
-    // -------------------------------------------------------------------------
-    // reset_state — clears counters and disables both timer alarms.
-    // Does NOT touch rx_state so FLAG_DATA_READY survives until read().
-    // Called from enable(), disable(), and loop() after parse.
-    // -------------------------------------------------------------------------
-    static void reset_state() {
-        bitcounter = 0;
-        isr_cnt    = 0;
-        // Passing nullptr disables the alarm (no new firing until GPIO ISR re-arms).
-        if (timer_bit_received)
-            gptimer_set_alarm_action(timer_bit_received, nullptr);
-        if (timer_bitstream_received)
-            gptimer_set_alarm_action(timer_bitstream_received, nullptr);
+// How often loop() compares the RX clock with esp_timer, see check_clock()
+#define CLOCK_CHECK_US          10000000
+
+// -------------------------------------------------------------------------
+// reset_state — clears counters and disables the timer alarm.
+// Does NOT touch rx_state so FLAG_DATA_READY survives until read().
+// Called from enable(), disable(), and loop() after parse.
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+void GDOOR_RX_T<WORDS>::reset_state() {
+    bitcounter = 0;
+    isr_cnt    = 0;
+    // Passing nullptr disables the alarm (no new firing until GPIO ISR re-arms).
+    if (timer_rx)
+        gptimer_set_alarm_action(timer_rx, nullptr);
+}
+
+// -------------------------------------------------------------------------
+// GPIO ISR — fires on every FALLING edge of the 60 kHz carrier burst.
+//
+// For each edge:
+//   1. Mark RX as active, the first edge of a frame records its timestamp
+//   2. Count the edge
+//   3. Re-arm the alarm: deadline = now + BIT_TIMEOUT_TICKS (bit end)
+//
+// Both gptimer_get_raw_count() and gptimer_set_alarm_action() are ISR-safe
+// (they use portENTER_CRITICAL spinlocks internally — pure register ops).
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+void GDOOR_RX_T<WORDS>::isr_extint_rx(void *arg) {
+    GDOOR_RX_T *self = static_cast<GDOOR_RX_T *>(arg);
+    GDOOR_ISR_PROFILE(self->rx_stats.isr_edge);
+    uint64_t now;
+    (void)gptimer_get_raw_count(self->timer_rx, &now);
+    if (!(self->rx_state & FLAG_RX_ACTIVE)) {
+        self->first_edge_ticks = now;
     }
-
-    // -------------------------------------------------------------------------
-    // GPIO ISR — fires on every FALLING edge of the 60 kHz carrier burst.
-    //
-    // For each edge:
-    //   1. Mark RX as active
-    //   2. Count the edge
-    //   3. Re-arm the bit-end   alarm: deadline = now + BIT_TIMEOUT_TICKS
-    //   4. Re-arm the frame-end alarm: deadline = now + BITSTREAM_TIMEOUT_TICKS
-    //
-    // Both gptimer_get_raw_count() and gptimer_set_alarm_action() are ISR-safe
-    // (they use portENTER_CRITICAL spinlocks internally — pure register ops).
-    // -------------------------------------------------------------------------
-    static void IRAM_ATTR isr_extint_rx(void * /*arg*/) {
-        rx_state |= (uint16_t)FLAG_RX_ACTIVE;
-        isr_cnt++;
-
+    self->rx_state |= (uint16_t)FLAG_RX_ACTIVE;
+    self->isr_cnt++;
+
+    gptimer_alarm_config_t alarm = {};
+    alarm.flags.auto_reload_on_alarm = false; // one-shot: auto-disables after firing
+    alarm.alarm_count = now + BIT_TIMEOUT_TICKS;
+    (void)gptimer_set_alarm_action(self->timer_rx, &alarm);
+}
+
+// -------------------------------------------------------------------------
+// GPTIMER callback, two stages on the same alarm:
+//
+//   Edges counted since the last alarm → bit burst ended (no new edge for
+//   BIT_TIMEOUT_TICKS). Store the edge count and push the alarm out to the
+//   frame-end deadline, BITSTREAM_TIMEOUT_TICKS after the last edge.
+//
+//   No edges since the last alarm → frame ended. Signal loop() that a
+//   complete frame is ready for parsing. The alarm was set relative to the
+//   last edge, which gives the frame end time without another timer read.
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+bool GDOOR_RX_T<WORDS>::cb_rx_alarm(
+    gptimer_handle_t timer,
+    const gptimer_alarm_event_data_t *edata,
+    void *user_ctx)
+{
+    GDOOR_RX_T *self = static_cast<GDOOR_RX_T *>(user_ctx);
+    GDOOR_ISR_PROFILE(self->isr_cnt == 0 ? self->rx_stats.isr_frame : self->rx_stats.isr_bit);
+
+    if (self->isr_cnt == 0) {
+        self->last_edge_ticks = edata->alarm_value - BITSTREAM_TIMEOUT_TICKS;
+#ifdef USE_GDOOR_LATENCY_TRACE
         uint64_t now;
-        gptimer_alarm_config_t alarm = {};
-        alarm.flags.auto_reload_on_alarm = false; // one-shot: auto-disables after firing
-
-        // Bit-end alarm
-        (void)gptimer_get_raw_count(timer_bit_received, &now);
-        alarm.alarm_count = now + BIT_TIMEOUT_TICKS;
-        (void)gptimer_set_alarm_action(timer_bit_received, &alarm);
-
-        // Frame-end alarm
-        (void)gptimer_get_raw_count(timer_bitstream_received, &now);
-        alarm.alarm_count = now + BITSTREAM_TIMEOUT_TICKS;
-        (void)gptimer_set_alarm_action(timer_bitstream_received, &alarm);
-    }
-
-    // -------------------------------------------------------------------------
-    // GPTIMER callback: bit burst ended (no new edge for BIT_TIMEOUT_TICKS).
-    // Stores the edge count for the completed burst; resets the edge counter.
-    // Mirrors old isr_timer_bit_received() exactly.
-    // -------------------------------------------------------------------------
-    static bool IRAM_ATTR cb_bit_received(
-        gptimer_handle_t /*timer*/,
-        const gptimer_alarm_event_data_t * /*edata*/,
-        void * /*user_ctx*/)
-    {
-        if (bitcounter >= (uint8_t)(MAX_WORDLEN * 9)) {
-            bitcounter = 0; // guard against buffer overrun
-        }
-        counts[bitcounter] = isr_cnt;
-        isr_cnt = 0;
-        bitcounter++;
-        // Alarm auto-disables (auto_reload_on_alarm = false).
-        // It will be re-armed by the next GPIO edge.
-        return false; // no high-priority task woken
-    }
-
-    // -------------------------------------------------------------------------
-    // GPTIMER callback: frame ended (no new edge for BITSTREAM_TIMEOUT_TICKS).
-    // Signals loop() that a complete frame is ready for parsing.
-    // Mirrors old isr_timer_bitstream_received() exactly.
-    // -------------------------------------------------------------------------
-    static bool IRAM_ATTR cb_bitstream_received(
-        gptimer_handle_t /*timer*/,
-        const gptimer_alarm_event_data_t * /*edata*/,
-        void * /*user_ctx*/)
-    {
-        rx_state &= (uint16_t)~FLAG_RX_ACTIVE;
-        rx_state |= (uint16_t)FLAG_BITSTREAM_RECEIVED;
+        (void)gptimer_get_raw_count(timer, &now);
+        self->frame_end_ticks = now;
+#endif
+        self->rx_state &= (uint16_t)~FLAG_RX_ACTIVE;
+        self->rx_state |= (uint16_t)FLAG_BITSTREAM_RECEIVED;
         // Alarm auto-disables after firing.
         return false;
     }
 
-    // -------------------------------------------------------------------------
-    // enable / disable — RX interrupt gate, called by GDOOR_TX around TX bursts.
-    // Both mirror gdoor-alt: reset state on both enter and exit.
-    // -------------------------------------------------------------------------
-    void enable() {
-        rx_state = 0;      // clear all flags including any stale state
-        reset_state();     // clear counters, disable pending timer alarms
-        gpio_isr_handler_add((gpio_num_t)pin_rx, isr_extint_rx, nullptr);
+    if (self->bitcounter >= CAPACITY::counts) {
+        self->bitcounter = 0; // guard against buffer overrun
+        self->rx_stats.overruns++;
     }
-
-    void disable() {
-        gpio_isr_handler_remove((gpio_num_t)pin_rx);  // stop new edges first
-        rx_state = 0;
-        reset_state();
+    // Valid bursts are well below 255 edges (start bit ~66), longer ones
+    // only need to stay "long" for the parser
+    self->counts[self->bitcounter] = self->isr_cnt > 0xFF ? 0xFF : (uint8_t)self->isr_cnt;
+    self->isr_cnt = 0;
+    self->bitcounter++;
+
+    // Bit alarm was armed BIT_TIMEOUT_TICKS after the last edge;
+    // the frame ends BITSTREAM_TIMEOUT_TICKS after that same edge.
+    // The next GPIO edge moves the alarm back to the bit deadline.
+    gptimer_alarm_config_t alarm = {};
+    alarm.flags.auto_reload_on_alarm = false;
+    alarm.alarm_count = edata->alarm_value + (BITSTREAM_TIMEOUT_TICKS - BIT_TIMEOUT_TICKS);
+    (void)gptimer_set_alarm_action(timer, &alarm);
+    return false; // no high-priority task woken
+}
+
+// -------------------------------------------------------------------------
+// enable / disable — RX interrupt gate, called by GDOOR_TX around TX bursts.
+// Both mirror gdoor-alt: reset state on both enter and exit.
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+void GDOOR_RX_T<WORDS>::enable() {
+    rx_state = 0;      // clear all flags including any stale state
+    reset_state();     // clear counters, disable pending timer alarm
+    gpio_isr_handler_add((gpio_num_t)pin_rx, isr_extint_rx, this);
+}
+
+template<uint16_t WORDS>
+void GDOOR_RX_T<WORDS>::disable() {
+    gpio_isr_handler_remove((gpio_num_t)pin_rx);  // stop new edges first
+    rx_state = 0;
+    reset_state();
+}
+
+// -------------------------------------------------------------------------
+// setup — called once per bus from GDOOR::setup()
+// @return false if the GPTIMER could not be allocated
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+bool GDOOR_RX_T<WORDS>::setup(uint8_t rxpin) {
+    pin_rx = rxpin;
+    // Configure as plain input — active comparator output; no pullup (INPUT_PULLUP
+    // would load the comparator at 45kΩ and distort the threshold).
+    gpio_config_t io_conf = {};
+    io_conf.intr_type    = GPIO_INTR_NEGEDGE;  // FALLING edge trigger
+    io_conf.mode         = GPIO_MODE_INPUT;
+    io_conf.pin_bit_mask = (1ULL << pin_rx);
+    io_conf.pull_up_en   = GPIO_PULLUP_DISABLE;
+    io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
+    gpio_config(&io_conf);
+
+    // Install per-GPIO ISR service; ESP_ERR_INVALID_STATE means already installed
+    // (e.g. by a second bus instance).
+    esp_err_t err = gpio_install_isr_service(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
+        ESP_LOGE(TAG, "gpio_install_isr_service failed: %d", err);
     }
 
-    // -------------------------------------------------------------------------
-    // setup — called once from GdoorComponent::setup()
-    // -------------------------------------------------------------------------
-    void setup(uint8_t rxpin) {
-        pin_rx = rxpin;
-        // Configure as plain input — active comparator output; no pullup (INPUT_PULLUP
-        // would load the comparator at 45kΩ and distort the threshold).
-        gpio_config_t io_conf = {};
-        io_conf.intr_type    = GPIO_INTR_NEGEDGE;  // FALLING edge trigger
-        io_conf.mode         = GPIO_MODE_INPUT;
-        io_conf.pin_bit_mask = (1ULL << pin_rx);
-        io_conf.pull_up_en   = GPIO_PULLUP_DISABLE;
-        io_conf.pull_down_en = GPIO_PULLDOWN_DISABLE;
-        gpio_config(&io_conf);
-
-        // Install per-GPIO ISR service; ESP_ERR_INVALID_STATE means already installed.
-        esp_err_t err = gpio_install_isr_service(0);
-        if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) {
-            ESP_LOGE(TAG, "gpio_install_isr_service failed: %d", err);
-        }
+    retval.len   = 0;
+    retval.valid = 0;
 
-        retval.len   = 0;
-        retval.valid = 0;
-
-        // Shared GPTIMER config: 120 kHz resolution, count up
-        gptimer_config_t timer_config = {};
-        timer_config.clk_src       = GPTIMER_CLK_SRC_DEFAULT;
-        timer_config.direction     = GPTIMER_COUNT_UP;
-        timer_config.resolution_hz = TIMER_FREQ_RX; // 120000
-
-        // --- Bit-end timer ---
-        gptimer_new_timer(&timer_config, &timer_bit_received);
-
-        gptimer_event_callbacks_t cbs = {};
-        cbs.on_alarm = cb_bit_received;
-        gptimer_register_event_callbacks(timer_bit_received, &cbs, nullptr);
-
-        // Alarm disabled initially (nullptr); GPIO ISR will arm it on first edge.
-        gptimer_set_alarm_action(timer_bit_received, nullptr);
-        gptimer_enable(timer_bit_received);
-        gptimer_start(timer_bit_received); // always running; alarm deadline set per-edge
-
-        // --- Frame-end timer ---
-        gptimer_new_timer(&timer_config, &timer_bitstream_received);
-
-        cbs.on_alarm = cb_bitstream_received;
-        gptimer_register_event_callbacks(timer_bitstream_received, &cbs, nullptr);
-
-        gptimer_set_alarm_action(timer_bitstream_received, nullptr);
-        gptimer_enable(timer_bitstream_received);
-        gptimer_start(timer_bitstream_received); // always running
-
-        ESP_LOGCONFIG(TAG, "GDoor RX setup:");
-        ESP_LOGCONFIG(TAG, "  RX pin            : GPIO %u", pin_rx);
-        ESP_LOGCONFIG(TAG, "  Timer resolution  : %u Hz", TIMER_FREQ_RX);
-        ESP_LOGCONFIG(TAG, "  Bit timeout       : %u ticks (%.0f µs)",
-                      BIT_TIMEOUT_TICKS,
-                      BIT_TIMEOUT_TICKS * 1e6f / TIMER_FREQ_RX);
-        ESP_LOGCONFIG(TAG, "  Bitstream timeout : %u ticks (%.0f µs)",
-                      BITSTREAM_TIMEOUT_TICKS,
-                      BITSTREAM_TIMEOUT_TICKS * 1e6f / TIMER_FREQ_RX);
-
-        // Enable external interrupt last
-        enable();
+    // GPTIMER config: 120 kHz resolution, count up
+    gptimer_config_t timer_config = {};
+    timer_config.clk_src       = GPTIMER_CLK_SRC_DEFAULT;
+    timer_config.direction     = GPTIMER_COUNT_UP;
+    timer_config.resolution_hz = TIMER_FREQ_RX; // 120000
+
+    err = gptimer_new_timer(&timer_config, &timer_rx);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "No free GPTIMER for RX on GPIO %u: %d", pin_rx, err);
+        timer_rx = nullptr;
+        return false;
     }
 
-    // -------------------------------------------------------------------------
-    // loop — called from GdoorComponent::loop() via GDOOR::loop().
-    // Detects frame completion, parses, then resets counters for next frame.
-    // -------------------------------------------------------------------------
-    void loop() {
-        if (rx_state & FLAG_BITSTREAM_RECEIVED) {
-            rx_state &= (uint16_t)~FLAG_BITSTREAM_RECEIVED;
-            ESP_LOGVV(TAG, "Gira RX done, bits=%u", bitcounter);
-            if (retval.parse(const_cast<uint16_t *>(counts), bitcounter)) {
-                ESP_LOGVV(TAG, "Gira RX parsed OK");
-                rx_state |= FLAG_DATA_READY; // preserved through reset_state()
-            }
-            reset_state(); // clear counters + disable alarms; FLAG_DATA_READY survives
-        }
+    // The driver divides the source clock by src / TIMER_FREQ_RX, rounded
+    // down, and counts at src / prescaler. Convert ticks with that rate,
+    // the nominal one is 1000 ppm off on the 80 MHz APB clock.
+    uint32_t resolution_hz = TIMER_FREQ_RX;
+    gptimer_get_resolution(timer_rx, &resolution_hz);
+    uint32_t src_hz = 0;
+    esp_clk_tree_src_get_freq_hz((soc_module_clk_t)GPTIMER_CLK_SRC_DEFAULT,
+                                 ESP_CLK_TREE_SRC_FREQ_PRECISION_CACHED, &src_hz);
+    if (src_hz >= TIMER_FREQ_RX && src_hz / (src_hz / TIMER_FREQ_RX) == resolution_hz) {
+        clock_src_hz   = src_hz;
+        clock_prescale = src_hz / TIMER_FREQ_RX;
+    } else {
+        clock_src_hz   = resolution_hz; // check_clock() keeps the rest in line
+        clock_prescale = 1;
     }
 
-    // -------------------------------------------------------------------------
-    // read — return parsed frame data if available
-    // -------------------------------------------------------------------------
-    GDOOR_DATA* read() {
-        if (rx_state & FLAG_DATA_READY) {
-            rx_state &= (uint16_t)~FLAG_DATA_READY;
-            return &retval;
+    gptimer_event_callbacks_t cbs = {};
+    cbs.on_alarm = cb_rx_alarm;
+    gptimer_register_event_callbacks(timer_rx, &cbs, this);
+
+    // Alarm disabled initially (nullptr); GPIO ISR will arm it on first edge.
+    gptimer_set_alarm_action(timer_rx, nullptr);
+    gptimer_enable(timer_rx);
+    gptimer_start(timer_rx); // always running; alarm deadline set per-edge
+    gptimer_get_raw_count(timer_rx, &ticks_base);
+    us_base = esp_timer_get_time();
+    clock_checked_us = us_base;
+
+    ESP_LOGCONFIG(TAG, "GDoor RX setup:");
+    ESP_LOGCONFIG(TAG, "  RX pin            : GPIO %u", pin_rx);
+    ESP_LOGCONFIG(TAG, "  Timer resolution  : %" PRIu32 " Hz (%" PRIu32 " Hz / %" PRIu32 ")",
+                  resolution_hz, clock_src_hz, clock_prescale);
+    ESP_LOGCONFIG(TAG, "  Bit timeout       : %u ticks (%.0f µs)",
+                  BIT_TIMEOUT_TICKS,
+                  BIT_TIMEOUT_TICKS * 1e6f / TIMER_FREQ_RX);
+    ESP_LOGCONFIG(TAG, "  Bitstream timeout : %u ticks (%.0f µs)",
+                  BITSTREAM_TIMEOUT_TICKS,
+                  BITSTREAM_TIMEOUT_TICKS * 1e6f / TIMER_FREQ_RX);
+
+    // Enable external interrupt last
+    enable();
+    return true;
+}
+
+// -------------------------------------------------------------------------
+// loop — called from GdoorComponent::loop() via GDOOR::loop().
+// Detects frame completion, parses, then resets counters for next frame.
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+void GDOOR_RX_T<WORDS>::loop() {
+    if (rx_state & FLAG_BITSTREAM_RECEIVED) {
+        rx_state &= (uint16_t)~FLAG_BITSTREAM_RECEIVED;
+        ESP_LOGVV(TAG, "Gira RX done, bits=%u", (unsigned)bitcounter);
+        retval.start_us = ticks_to_us(first_edge_ticks);
+        retval.end_us   = ticks_to_us(last_edge_ticks);
+        int64_t start = esp_timer_get_time();
+        bool parsed = retval.parse(const_cast<const uint8_t *>(counts), bitcounter);
+        rx_stats.parse.add((uint32_t)(esp_timer_get_time() - start));
+#ifdef USE_GDOOR_LATENCY_TRACE
+        retval.trace = GDOOR_TRACE();
+        retval.trace.mark(TRACE_FIRST_EDGE, (uint32_t)retval.start_us);
+        retval.trace.mark(TRACE_LAST_EDGE, (uint32_t)retval.end_us);
+        retval.trace.mark(TRACE_FRAME_END, (uint32_t)ticks_to_us(frame_end_ticks));
+        retval.trace.mark(TRACE_PARSED, (uint32_t)now_us());
+#endif
+
+        rx_stats.trains++;
+        rx_stats.filtered_pulses    += retval.filtered_pulses;
+        rx_stats.startbits_rejected += retval.startbits_rejected;
+        if (parsed) {
+            ESP_LOGVV(TAG, "Gira RX parsed OK");
+            rx_stats.frames++;
+            rx_stats.parity_errors += retval.parity_errors;
+            rx_stats.crc_errors    += retval.crc_error;
+            rx_state |= FLAG_DATA_READY; // preserved through reset_state()
         }
-        return nullptr;
+        if (train_callback != nullptr) {
+            train_callback(retval, parsed, train_callback_arg);
+        }
+        reset_state(); // clear counters + disable alarm; FLAG_DATA_READY survives
     }
-
-} // namespace GDOOR_RX
+    if (rx_state == 0 && esp_timer_get_time() - clock_checked_us >= CLOCK_CHECK_US) {
+        check_clock();
+    }
+}
+
+// -------------------------------------------------------------------------
+// check_clock — called from loop() between frames
+// Samples both clocks and records how far end_us would be from
+// esp_timer_get_time(). More than a tick apart (a wrong rate, or a source
+// clock change) re-anchors the conversion, so the stamps never drift.
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+void GDOOR_RX_T<WORDS>::check_clock() {
+    uint64_t ticks;
+    int64_t before = esp_timer_get_time();
+    gptimer_get_raw_count(timer_rx, &ticks);
+    int64_t after = esp_timer_get_time();
+    if (after - before > 2) {
+        return; // interrupted between the reads, try again next loop
+    }
+    clock_checked_us = after;
+    int64_t now = before + (after - before) / 2;
+    int64_t skew = now - ticks_to_us(ticks);
+    uint32_t skew_abs = (uint32_t)(skew < 0 ? -skew : skew);
+    if (skew_abs > rx_stats.clock_skew_us) {
+        rx_stats.clock_skew_us = skew_abs;
+    }
+    // A count converts to the start of its tick, so up to one tick is exact
+    if (skew_abs > 1000000u * clock_prescale / clock_src_hz + 1) {
+        ticks_base = ticks;
+        us_base = now;
+        rx_stats.clock_resyncs++;
+        ESP_LOGD(TAG, "RX clock %" PRId64 " us off esp_timer, re-anchored", skew);
+    }
+}
+
+// -------------------------------------------------------------------------
+// ticks_to_us / now_us — GPTIMER count to esp_timer_get_time() time
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+int64_t GDOOR_RX_T<WORDS>::ticks_to_us(uint64_t ticks) const {
+    // Source clock cycles since the anchor, split so nothing overflows;
+    // a count from before a re-anchor is negative
+    bool before = ticks < ticks_base;
+    uint64_t cycles = (before ? ticks_base - ticks : ticks - ticks_base) * clock_prescale;
+    int64_t us = (int64_t)(cycles / clock_src_hz * 1000000ULL + cycles % clock_src_hz * 1000000ULL / clock_src_hz);
+    return before ? us_base - us : us_base + us;
+}
+
+template<uint16_t WORDS>
+int64_t GDOOR_RX_T<WORDS>::now_us() const {
+    uint64_t ticks;
+    gptimer_get_raw_count(timer_rx, &ticks);
+    return ticks_to_us(ticks);
+}
+
+// -------------------------------------------------------------------------
+// read — return parsed frame data if available
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+GDOOR_DATA_T<WORDS>* GDOOR_RX_T<WORDS>::read() {
+    if (rx_state & FLAG_DATA_READY) {
+        rx_state &= (uint16_t)~FLAG_DATA_READY;
+        return &retval;
+    }
+    return nullptr;
+}
+
+// GCC ignores IRAM_ATTR on a template definition and emits the code into a
+// COMDAT .text section in flash; only the explicit instantiation takes it.
+// Both ISRs must stay in IRAM, flash is off during NVS writes and OTA.
+template void IRAM_ATTR GDOOR_RX_T<MAX_WORDLEN>::isr_extint_rx(void *arg);
+template bool IRAM_ATTR GDOOR_RX_T<MAX_WORDLEN>::cb_rx_alarm(
+    gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx);
+template class GDOOR_RX_T<MAX_WORDLEN>;
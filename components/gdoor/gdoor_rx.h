@@ -22,14 +22,70 @@
 #include "driver/gptimer.h"
 #include "driver/gpio.h"
 #include "gdoor_data.h"
+#include "gdoor_stats.h"
 
-namespace GDOOR_RX { //Namespace as we can only use it once
-    extern uint16_t rx_state;
-    void setup(uint8_t rxpin);
-    void loop();
-    void enable();
-    void disable();
-    GDOOR_DATA* read();
+template<uint16_t WORDS>
+class GDOOR_RX_T { // One instance per bus; ISRs reach it through their user context
+    public:
+        typedef GDOOR_CAPACITY<WORDS> CAPACITY;
+
+        volatile uint16_t rx_state = 0; // state flags, read by GDOOR::active()
+
+        bool setup(uint8_t rxpin);
+        void loop();
+        void enable();
+        void disable();
+        GDOOR_DATA_T<WORDS>* read();
+        const GDOOR_RX_STATS &stats() const { return rx_stats; }
+        // GPTIMER count / current time in the esp_timer timebase of start_us
+        // and end_us
+        int64_t ticks_to_us(uint64_t ticks) const;
+        int64_t now_us() const;
+        gptimer_handle_t clock() const { return timer_rx; } // ISR-safe raw count for TX stamps
+
+        // Called from loop() (task context) for every pulse train that reached
+        // frame end, decoded or not, before read() can return it. The data is
+        // only valid during the call.
+        typedef void (*train_callback_t)(const GDOOR_DATA_T<WORDS> &train, bool parsed, void *arg);
+        void set_train_callback(train_callback_t callback, void *arg) {
+            train_callback = callback;
+            train_callback_arg = arg;
+        }
+
+    private:
+        static void isr_extint_rx(void *arg);
+        static bool cb_rx_alarm(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx);
+        void reset_state();
+        void check_clock();
+
+        volatile uint8_t  counts[CAPACITY::counts]; // pulse counts per bit burst, saturated at 255
+        volatile uint16_t isr_cnt    = 0;         // edges counted in current burst
+        volatile typename CAPACITY::bit_index_t bitcounter = 0; // number of complete bits stored
+        volatile uint64_t first_edge_ticks = 0;   // GPTIMER count at the first edge of the frame
+        volatile uint64_t last_edge_ticks  = 0;   // GPTIMER count at the last edge, set at frame end
+#ifdef USE_GDOOR_LATENCY_TRACE
+        volatile uint64_t frame_end_ticks  = 0;   // GPTIMER count when the frame-end alarm ran
+#endif
+
+        GDOOR_DATA_T<WORDS> retval;
+        GDOOR_RX_STATS rx_stats;
+        train_callback_t train_callback = nullptr;
+        void *train_callback_arg = nullptr;
+        gptimer_handle_t timer_rx = nullptr;
+        uint8_t pin_rx = 0;
+        // GPTIMER count and esp_timer time sampled together. Ticks are
+        // converted with the real counter rate, source clock / prescaler
+        // (80 MHz / 666 = 120120 Hz on the APB clock, not TIMER_FREQ_RX);
+        // check_clock() compares both clocks now and then and re-anchors if
+        // they are more than a tick apart
+        uint64_t ticks_base = 0;
+        int64_t us_base = 0;
+        uint32_t clock_src_hz = TIMER_FREQ_RX;
+        uint32_t clock_prescale = 1;
+        int64_t clock_checked_us = 0;
 };
 
+// RX engine of this build, sized by MAX_WORDLEN
+typedef GDOOR_RX_T<MAX_WORDLEN> GDOOR_RX;
+
 #endif
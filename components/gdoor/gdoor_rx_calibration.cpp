@@ -0,0 +1,147 @@
+#include "gdoor_rx_calibration.h"
+#include "gdoor.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+static const char *TAG = "gdoor_esphome.rx_calibration";
+
+void GDoorRxCalibrator::setup(uint8_t dac_pin, float start_volts) {
+  this->dac_pin_ = dac_pin;
+  for (auto &score : this->scores_) {
+    score = -1;
+  }
+
+  // One preference per DAC pin, so each bus keeps its own threshold
+  this->pref_ = global_preferences->make_preference<uint8_t>(fnv1_hash("gdoor_rx_threshold") ^ dac_pin);
+  uint8_t stored;
+  if (this->pref_.load(&stored) && stored < STEPS) {
+    this->best_ = stored;
+    ESP_LOGD(TAG, "Restored RX threshold %.2fV", volts_(stored));
+  } else {
+    int step = (int) ((start_volts - MIN_VOLTS) / STEP_VOLTS + 0.5f);
+    this->best_ = (uint8_t) (step < 0 ? 0 : (step >= STEPS ? STEPS - 1 : step));
+  }
+  this->apply_(this->best_);
+}
+
+void GDoorRxCalibrator::apply_(uint8_t step) {
+  this->current_ = step;
+  GDOOR::setRxThreshold(this->dac_pin_, volts_(step));
+}
+
+void GDoorRxCalibrator::commit_best_(uint8_t step) {
+  ESP_LOGI(TAG, "RX threshold %.2fV -> %.2fV", volts_(this->best_), volts_(step));
+  this->best_ = step;
+  this->pref_.save(&this->best_);
+}
+
+void GDoorRxCalibrator::on_frame(const GDOOR_DATA *data, const GDOOR_RX_STATS &stats, uint32_t now) {
+  if (data->valid) {
+    this->score_sum_ += 100 + (data->margin > 100 ? 100 : data->margin);
+  } else {
+    this->fails_++;
+  }
+  this->frames_++;
+  // A frame arrived, so the noise guard starts over
+  this->noise_base_ = spurious_(stats);
+  this->noise_since_ = now;
+
+  bool abort_probe = this->is_probing() && this->fails_ >= PROBE_ABORT_FAILS;
+  if (abort_probe || this->frames_ >= WINDOW_FRAMES) {
+    this->finish_window_(stats);
+  }
+}
+
+/*
+ * Score the window for the current step: mean per-frame score (0 for broken
+ * frames, 100-200 for valid ones by margin) minus 5 points per spurious pulse
+ * per frame, capped at 100. Scores are smoothed over the visits of a step.
+ */
+void GDoorRxCalibrator::finish_window_(const GDOOR_RX_STATS &stats) {
+  uint32_t spurious = spurious_(stats) - this->spurious_base_;
+  int32_t penalty = (int32_t) (spurious * 5 / this->frames_);
+  int32_t score = (int32_t) (this->score_sum_ / this->frames_) - (penalty > 100 ? 100 : penalty);
+  if (score < 0) {
+    score = 0;
+  }
+  int16_t &smoothed = this->scores_[this->current_];
+  smoothed = smoothed < 0 ? (int16_t) score : (int16_t) ((3 * smoothed + score) / 4);
+  ESP_LOGV(TAG, "Window at %.2fV: %u frames, %u failed, %" PRIu32 " spurious -> score %d", volts_(this->current_),
+           this->frames_, this->fails_, spurious, smoothed);
+
+  this->frames_ = 0;
+  this->fails_ = 0;
+  this->score_sum_ = 0;
+  this->spurious_base_ = spurious_(stats);
+
+  if (this->is_probing()) {
+    if (this->scores_[this->current_] > this->scores_[this->best_] + HYSTERESIS) {
+      // Keep walking the same way on the next probe
+      this->commit_best_(this->current_);
+      this->dwell_windows_ = DWELL_WINDOWS;
+    } else {
+      this->probe_dir_ = -this->probe_dir_;
+      this->apply_(this->best_);
+      if (this->dwell_windows_ < DWELL_WINDOWS_MAX) {
+        this->dwell_windows_ *= 2;
+      }
+    }
+    this->dwell_left_ = this->dwell_windows_;
+    return;
+  }
+
+  if (--this->dwell_left_ > 0) {
+    return;
+  }
+  int next = this->best_ + this->probe_dir_;
+  if (next < 0 || next >= STEPS) {
+    this->probe_dir_ = -this->probe_dir_;
+    next = this->best_ + this->probe_dir_;
+  }
+  ESP_LOGV(TAG, "Probing RX threshold %.2fV", volts_(next));
+  this->apply_((uint8_t) next);
+}
+
+/*
+ * Without frames the score cannot judge anything, but a flood of spurious
+ * pulses means the comparator triggers on noise. Abort a running probe, or
+ * step to a lower (less sensitive, see RX_SENS_* presets) threshold.
+ */
+void GDoorRxCalibrator::loop(const GDOOR_RX_STATS &stats, uint32_t now) {
+  if (now - this->noise_since_ < NOISE_INTERVAL_MS) {
+    return;
+  }
+  uint32_t spurious = spurious_(stats) - this->noise_base_;
+  this->noise_base_ = spurious_(stats);
+  this->noise_since_ = now;
+  if (spurious <= NOISE_LIMIT) {
+    return;
+  }
+
+  ESP_LOGD(TAG, "%" PRIu32 " spurious pulses without a frame at %.2fV", spurious, volts_(this->current_));
+  if (this->is_probing()) {
+    this->scores_[this->current_] = 0;
+    this->probe_dir_ = -this->probe_dir_;
+  } else if (this->best_ > 0) {
+    this->scores_[this->best_] = 0;
+    this->commit_best_(this->best_ - 1);
+  }
+  this->frames_ = 0;
+  this->fails_ = 0;
+  this->score_sum_ = 0;
+  this->spurious_base_ = spurious_(stats);
+  this->dwell_windows_ = DWELL_WINDOWS;
+  this->dwell_left_ = DWELL_WINDOWS;
+  this->apply_(this->best_);
+}
+
+void GDoorRxCalibrator::dump_config() {
+  ESP_LOGCONFIG(TAG, "  RX Sensitivity: auto, %.2fV (range %.2fV-%.2fV)", this->best_threshold(), volts_(0),
+                volts_(STEPS - 1));
+}
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include "esphome/core/preferences.h"
+#include "gdoor_data.h"
+#include "gdoor_stats.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+/// Closed-loop RX threshold calibration for the adjustable comparator input
+/// (IO22 on v3.1 hardware). The DAC threshold is stepped through a fixed grid;
+/// every step gets a score from the frames received while it was active:
+/// valid frames with a wide 1/0 decode margin score high, parity/CRC failures
+/// score zero and spurious pulses (noise) cost points. The calibrator dwells
+/// on the best step and now and then probes a neighbour for one window, moving
+/// over only if the neighbour scores clearly better. The chosen step survives
+/// reboots through the preferences store.
+class GDoorRxCalibrator {
+ public:
+  // Threshold grid in volts, covers the low/med/high presets of rx_sens
+  static constexpr float MIN_VOLTS = 1.20f;
+  static constexpr float STEP_VOLTS = 0.05f;
+  static const uint8_t STEPS = 13;  // 1.20V .. 1.80V
+
+  // Restore the persisted step (or start at start_volts) and apply it
+  void setup(uint8_t dac_pin, float start_volts);
+  // Feed every parsed frame, before dedupe; stats give the spurious pulse count
+  void on_frame(const GDOOR_DATA *data, const GDOOR_RX_STATS &stats, uint32_t now);
+  // Noise guard while no frames arrive
+  void loop(const GDOOR_RX_STATS &stats, uint32_t now);
+
+  float threshold() const { return volts_(this->current_); }
+  float best_threshold() const { return volts_(this->best_); }
+  bool is_probing() const { return this->current_ != this->best_; }
+  void dump_config();
+
+ protected:
+  // Frames per evaluation window
+  static const uint8_t WINDOW_FRAMES = 8;
+  // Failed frames that end a probe early, before the window is full
+  static const uint8_t PROBE_ABORT_FAILS = 2;
+  // Score lead a neighbour needs before the calibrator moves to it
+  static const int16_t HYSTERESIS = 10;
+  // Windows spent on the best step between two probes; doubles after every
+  // probe that did not move, so a settled threshold is rarely disturbed
+  static const uint8_t DWELL_WINDOWS = 2;
+  static const uint8_t DWELL_WINDOWS_MAX = 64;
+  // Noise guard: spurious pulses per NOISE_INTERVAL_MS without any frame
+  static const uint32_t NOISE_INTERVAL_MS = 60000;
+  static const uint32_t NOISE_LIMIT = 500;
+
+  static float volts_(uint8_t step) { return MIN_VOLTS + STEP_VOLTS * step; }
+  static uint32_t spurious_(const GDOOR_RX_STATS &stats) {
+    return stats.filtered_pulses + stats.startbits_rejected;
+  }
+  void apply_(uint8_t step);
+  void finish_window_(const GDOOR_RX_STATS &stats);
+  void commit_best_(uint8_t step);
+
+  ESPPreferenceObject pref_;
+  uint8_t dac_pin_{0};
+  uint8_t best_{0};     // step in use outside of probes, persisted
+  uint8_t current_{0};  // step the DAC is set to right now
+  int8_t probe_dir_{1};
+  uint8_t dwell_windows_{DWELL_WINDOWS};
+  uint8_t dwell_left_{DWELL_WINDOWS};
+  // Running window
+  uint8_t frames_{0};
+  uint8_t fails_{0};
+  uint16_t score_sum_{0};
+  uint32_t spurious_base_{0};
+  uint32_t noise_base_{0};
+  uint32_t noise_since_{0};
+  // Smoothed score per step, -1 = not measured yet
+  int16_t scores_[STEPS];
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
@@ -0,0 +1,71 @@
+/*
+ * This file is part of the GDoor distribution (https://github.com/gdoor-org).
+ * Copyright (c) 2024 GDoor authors.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef GDOOR_STATS_H
+#define GDOOR_STATS_H
+#include <stdint.h>
+#include "gdoor_isr_profile.h"
+
+// Accumulated duration of one processing stage, in µs since boot.
+// Consumers diff two snapshots to get the average over an interval.
+struct GDOOR_TIMING {
+    uint64_t total_us = 0;
+    uint32_t samples  = 0;
+    uint32_t last_us  = 0;
+    uint32_t max_us   = 0;
+
+    void add(uint32_t us) {
+        total_us += us;
+        samples++;
+        last_us = us;
+        if (us > max_us) max_us = us;
+    }
+};
+
+// Decoder health counters of one GDOOR_RX engine, totals since boot
+struct GDOOR_RX_STATS {
+    uint32_t trains             = 0; // pulse trains that reached frame end, decoded or not
+    uint32_t frames             = 0; // pulse trains decoded to at least one word
+    uint32_t parity_errors      = 0; // words with a wrong parity bit
+    uint32_t crc_errors         = 0; // frames with a wrong CRC byte
+    uint32_t filtered_pulses    = 0; // bursts shorter than BIT_MIN_LEN
+    uint32_t startbits_rejected = 0; // leading bursts shorter than STARTBIT_MIN_LEN
+    volatile uint32_t overruns  = 0; // bit buffer wraps in the ISR
+    uint32_t clock_skew_us      = 0; // largest RX clock vs esp_timer distance seen
+    uint32_t clock_resyncs      = 0; // RX clock re-anchored to esp_timer
+    GDOOR_TIMING parse;
+#ifdef USE_GDOOR_ISR_PROFILING
+    GDOOR_ISR_HISTOGRAM isr_edge;  // isr_extint_rx
+    GDOOR_ISR_HISTOGRAM isr_bit;   // cb_rx_alarm, bit-end stage
+    GDOOR_ISR_HISTOGRAM isr_frame; // cb_rx_alarm, frame-end stage
+#endif
+};
+
+// TX counters of one GDOOR_TX engine, totals since boot
+struct GDOOR_TX_STATS {
+    uint32_t sent    = 0; // frames handed to the ISR for sending
+    uint32_t dropped = 0; // frames rejected: TX busy, too long or bad hex
+    // Timed sends (send_at): |achieved - requested| start offset, and the
+    // offsets of the most recent one
+    GDOOR_TIMING timed_error;
+    int32_t timed_requested_us = 0;
+    int32_t timed_achieved_us  = 0;
+#ifdef USE_GDOOR_ISR_PROFILING
+    GDOOR_ISR_HISTOGRAM isr_tick;  // isr_timer_60khz while sending
+#endif
+};
+
+#endif
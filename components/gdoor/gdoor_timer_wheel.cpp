@@ -0,0 +1,85 @@
+#include "gdoor_timer_wheel.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+void GDoorTimerWheel::schedule(GDoorTimer *timer, uint32_t now, uint32_t delay) {
+  if (timer->armed_) {
+    this->unlink_(timer);
+  }
+  if (this->armed_count_ == 0) {
+    // Nothing pending, so no slot was skipped: jump straight to the present
+    this->current_tick_ = now / TICK_MS;
+  }
+  timer->expiry_ = now + delay;
+  uint8_t slot = (uint8_t)((timer->expiry_ / TICK_MS) % SLOTS);
+  timer->prev_ = nullptr;
+  timer->next_ = this->slots_[slot];
+  if (timer->next_ != nullptr) {
+    timer->next_->prev_ = timer;
+  }
+  this->slots_[slot] = timer;
+  timer->armed_ = true;
+  this->armed_count_++;
+}
+
+void GDoorTimerWheel::cancel(GDoorTimer *timer) {
+  if (timer->armed_) {
+    this->unlink_(timer);
+  }
+}
+
+void GDoorTimerWheel::unlink_(GDoorTimer *timer) {
+  if (timer->prev_ != nullptr) {
+    timer->prev_->next_ = timer->next_;
+  } else {
+    this->slots_[(timer->expiry_ / TICK_MS) % SLOTS] = timer->next_;
+  }
+  if (timer->next_ != nullptr) {
+    timer->next_->prev_ = timer->prev_;
+  }
+  timer->prev_ = nullptr;
+  timer->next_ = nullptr;
+  timer->armed_ = false;
+  this->armed_count_--;
+}
+
+void GDoorTimerWheel::fire_due_(uint8_t slot, uint32_t now) {
+  GDoorTimer *timer = this->slots_[slot];
+  while (timer != nullptr) {
+    // Fetch next first: the callback may re-arm the timer into any slot
+    GDoorTimer *next = timer->next_;
+    if ((int32_t)(now - timer->expiry_) >= 0) {
+      this->unlink_(timer);
+      if (timer->callback_) {
+        timer->callback_();
+      }
+    }
+    timer = next;
+  }
+}
+
+void GDoorTimerWheel::advance(uint32_t now) {
+  if (this->armed_count_ == 0) {
+    return;
+  }
+  uint32_t now_tick = now / TICK_MS;
+  if (now_tick - this->current_tick_ >= SLOTS) {
+    // Loop stalled for a full revolution: every slot may hold due timers
+    for (uint8_t slot = 0; slot < SLOTS; slot++) {
+      this->fire_due_(slot, now);
+    }
+  } else {
+    // Walk the ticks passed since the last call, including the current one
+    // (it may still hold timers due later in this tick, so it stays current)
+    while (true) {
+      this->fire_due_((uint8_t)(this->current_tick_ % SLOTS), now);
+      if (this->current_tick_ == now_tick) break;
+      this->current_tick_++;
+    }
+  }
+  this->current_tick_ = now_tick;
+}
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+
+namespace esphome {
+namespace gdoor_esphome {
+
+/// Intrusive timer handle owned by an entity and armed through GDoorTimerWheel.
+/// The callback runs from GdoorComponent::loop() once the delay has passed.
+class GDoorTimer {
+ public:
+  void set_callback(std::function<void()> &&callback) { this->callback_ = std::move(callback); }
+  bool is_armed() const { return this->armed_; }
+
+ protected:
+  friend class GDoorTimerWheel;
+  std::function<void()> callback_;
+  uint32_t expiry_{0};
+  GDoorTimer *prev_{nullptr};
+  GDoorTimer *next_{nullptr};
+  bool armed_{false};
+};
+
+/// Hashed timer wheel shared by all entities of one GdoorComponent.
+/// Replaces per-entity loop() polling for deferred state resets: scheduling
+/// and cancelling are O(1), and an empty wheel costs one compare per loop.
+class GDoorTimerWheel {
+ public:
+  // (Re-)arm timer to fire delay ms after now
+  void schedule(GDoorTimer *timer, uint32_t now, uint32_t delay);
+  void cancel(GDoorTimer *timer);
+  // Fire all timers due at now; called from GdoorComponent::loop()
+  void advance(uint32_t now);
+  uint16_t armed() const { return this->armed_count_; }
+
+ protected:
+  static const uint8_t SLOTS = 16;
+  static const uint32_t TICK_MS = 32;
+
+  void unlink_(GDoorTimer *timer);
+  void fire_due_(uint8_t slot, uint32_t now);
+
+  GDoorTimer *slots_[SLOTS]{};
+  uint32_t current_tick_{0};
+  uint16_t armed_count_{0};
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
@@ -23,6 +23,9 @@
  *   - ledcWrite(channel, duty) → ledc_set_duty / ledc_update_duty (IDF, ISR-safe)
  *   - timerStart/timerStop from ISR → "always-running timer + tx_active flag" pattern
  *   - GDOOR_RX::enable() deferred from ISR to loop() (attachInterrupt not ISR-safe)
+ *
+ * Each GDOOR_TX instance owns its GPTIMER and an LEDC channel/timer pair
+ * handed in by GdoorComponent, so several buses transmit independently.
  */
 
 #include "defines.h"
@@ -30,277 +33,353 @@
 #include "gdoor_rx.h"
 #include "gdoor_utils.h"
 #include "esphome/core/log.h"
+#include <inttypes.h>
 
 static const char *TAG = "gdoor_esphome.gdoor_tx";
 
-namespace GDOOR_TX {
-
-    // -------------------------------------------------------------------------
-    // State (mirrors gdoor-alt)
-    // -------------------------------------------------------------------------
-    static volatile uint16_t tx_state    = 0;
-    static volatile uint16_t tx_words[MAX_WORDLEN];
-    static volatile uint16_t bits_len    = 0;
-    static volatile uint16_t bits_ptr    = 0;
-    static volatile uint16_t pulse_cnt   = 0;
-    static volatile uint8_t  startbit_send = 0;
-    static volatile uint8_t  timer_oc_state = 0;
-
-    // GPTIMER design: timer runs always; ISR is gated by tx_active flag.
-    // tx_just_done signals loop() to call GDOOR_RX::enable() in main context.
-    static volatile bool tx_active    = false;
-    static volatile bool tx_just_done = false;
-
-    static gptimer_handle_t timer_60khz = nullptr;
-    static ledc_channel_t   ledc_ch     = LEDC_CHANNEL_0; // cached at setup
-
-    static uint8_t pin_tx    = 0;
-    static uint8_t pin_tx_en = 0;
-
-    // Hex digit lookup — replaces Arduino String hexChars
-    static inline int hex_digit(char c) {
-        if (c >= '0' && c <= '9') return c - '0';
-        if (c >= 'a' && c <= 'f') return c - 'a' + 10;
-        if (c >= 'A' && c <= 'F') return c - 'A' + 10;
-        return -1;
+// Hex digit lookup — replaces Arduino String hexChars
+static inline int hex_digit(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+// -------------------------------------------------------------------------
+// Helpers (identical to gdoor-alt)
+// -------------------------------------------------------------------------
+static inline uint16_t byte2word(uint8_t byte) {
+    uint16_t value = byte & 0x00FF;
+    if (GDOOR_UTILS::parity_odd(byte)) {
+        value |= 0x100;
     }
-
-    // -------------------------------------------------------------------------
-    // Helpers (identical to gdoor-alt)
-    // -------------------------------------------------------------------------
-    static inline uint16_t byte2word(uint8_t byte) {
-        uint16_t value = byte & 0x00FF;
-        if (GDOOR_UTILS::parity_odd(byte)) {
-            value |= 0x100;
-        }
-        return value;
+    return value;
+}
+
+// -------------------------------------------------------------------------
+// start_timer — called from main context only
+// @param delay_ticks 0: start now, else the ISR enables the bus driver
+//        after that many ticks (timed send)
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+void GDOOR_TX_T<WORDS>::start_timer(uint32_t delay_ticks) {
+    tx_state |= STATE_SENDING;
+    bits_ptr      = 0;
+    pulse_cnt     = 0;
+    timer_oc_state = 0;
+    startbit_send  = 0;
+    start_delay    = delay_ticks;
+
+    rx->disable();                                    // 1. detach RX interrupt FIRST
+    if (delay_ticks == 0) {
+        gpio_set_level((gpio_num_t)pin_tx_en, 1);     // 2. enable bus driver
     }
-
-    // -------------------------------------------------------------------------
-    // start_timer — called from main context only
-    // -------------------------------------------------------------------------
-    static inline void start_timer() {
-        tx_state |= STATE_SENDING;
-        bits_ptr      = 0;
-        pulse_cnt     = 0;
-        timer_oc_state = 0;
-        startbit_send  = 0;
-
-        GDOOR_RX::disable();                              // 1. detach RX interrupt FIRST
-        gpio_set_level((gpio_num_t)pin_tx_en, 1);         // 2. enable bus driver
-        tx_active = true;                                  // 3. open ISR gate
+    tx_active = true;                                  // 3. open ISR gate
+}
+
+// -------------------------------------------------------------------------
+// stop_timer_from_isr — called from ISR context only
+// All operations must be ISR-safe (register writes only, no RTOS calls).
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+void GDOOR_TX_T<WORDS>::stop_timer_from_isr() {
+    // Carrier OFF — pure IDF register writes, ISR-safe
+    ledc_set_duty(LEDC_LOW_SPEED_MODE, ledc_ch, 0);
+    ledc_update_duty(LEDC_LOW_SPEED_MODE, ledc_ch);
+
+    // TX_EN LOW — IDF gpio_set_level is ISR-safe (hw register write)
+    gpio_set_level((gpio_num_t)pin_tx_en, 0);
+
+    // Update state
+    tx_state  &= (uint16_t)~STATE_SENDING;
+    tx_active  = false;
+    tx_just_done = true;   // signal loop() to re-enable RX
+    // NOTE: rx->enable() is intentionally NOT called here;
+    // attachInterrupt() is not ISR-safe and is deferred to loop().
+}
+
+// -------------------------------------------------------------------------
+// ISR — fires every 16.67 µs (60 kHz), logic is 1:1 from gdoor-alt
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+bool GDOOR_TX_T<WORDS>::isr_timer_60khz(
+    gptimer_handle_t /*timer*/,
+    const gptimer_alarm_event_data_t * /*edata*/,
+    void *user_ctx)
+{
+    GDOOR_TX_T *self = static_cast<GDOOR_TX_T *>(user_ctx);
+    if (!self->tx_active) return false; // gate: instant exit when idle
+    if (self->start_delay != 0) {
+        // Timed send: count down on the tick, then key the bus in this same tick
+        if (--self->start_delay != 0) return false;
+        gpio_set_level((gpio_num_t)self->pin_tx_en, 1);
+        uint64_t now;
+        (void)gptimer_get_raw_count(self->rx_clock, &now);
+        self->started_ticks = now;
     }
+    GDOOR_ISR_PROFILE(self->tx_stats.isr_tick);
 
-    // -------------------------------------------------------------------------
-    // stop_timer_from_isr — called from ISR context only
-    // All operations must be ISR-safe (register writes only, no RTOS calls).
-    // -------------------------------------------------------------------------
-    static inline void IRAM_ATTR stop_timer_from_isr() {
-        // Carrier OFF — pure IDF register writes, ISR-safe
-        ledc_set_duty(LEDC_LOW_SPEED_MODE, ledc_ch, 0);
-        ledc_update_duty(LEDC_LOW_SPEED_MODE, ledc_ch);
-
-        // TX_EN LOW — IDF gpio_set_level is ISR-safe (hw register write)
-        gpio_set_level((gpio_num_t)pin_tx_en, 0);
-
-        // Update state
-        tx_state  &= (uint16_t)~STATE_SENDING;
-        tx_active  = false;
-        tx_just_done = true;   // signal loop() to re-enable RX
-        // NOTE: GDOOR_RX::enable() is intentionally NOT called here;
-        // attachInterrupt() is not ISR-safe and is deferred to loop().
-    }
+    if (self->pulse_cnt == 0) {
+        // Current phase (burst or pause) is finished — decide what comes next.
 
-    // -------------------------------------------------------------------------
-    // ISR — fires every 16.67 µs (60 kHz), logic is 1:1 from gdoor-alt
-    // -------------------------------------------------------------------------
-    static bool IRAM_ATTR isr_timer_60khz(
-        gptimer_handle_t /*timer*/,
-        const gptimer_alarm_event_data_t * /*edata*/,
-        void * /*user_ctx*/)
-    {
-        if (!tx_active) return false; // gate: instant exit when idle
-
-        if (pulse_cnt == 0) {
-            // Current phase (burst or pause) is finished — decide what comes next.
-
-            if (bits_ptr >= bits_len || bits_ptr >= (uint16_t)(MAX_WORDLEN * 9)) {
-                // All bits sent — stop.
-                stop_timer_from_isr();
-                return false;
-            }
+        if (self->bits_ptr >= self->bits_len || self->bits_ptr >= CAPACITY::bits) {
+            // All bits sent — stop.
+            self->stop_timer_from_isr();
+            return false;
+        }
 
-            if (timer_oc_state == 1) {
-                // Just finished a carrier burst → now send inter-bit pause (silence).
-                timer_oc_state = 0;
-                pulse_cnt = PAUSE_PULSENUM;
-                ledc_set_duty(LEDC_LOW_SPEED_MODE, ledc_ch, 0);  // carrier OFF
-                ledc_update_duty(LEDC_LOW_SPEED_MODE, ledc_ch);
+        if (self->timer_oc_state == 1) {
+            // Just finished a carrier burst → now send inter-bit pause (silence).
+            self->timer_oc_state = 0;
+            self->pulse_cnt = PAUSE_PULSENUM;
+            ledc_set_duty(LEDC_LOW_SPEED_MODE, self->ledc_ch, 0);  // carrier OFF
+            ledc_update_duty(LEDC_LOW_SPEED_MODE, self->ledc_ch);
+        } else {
+            // Just finished a pause → now send next carrier burst.
+            if (!self->startbit_send) {
+                // First burst is the start bit (fixed length, not in tx_words).
+                self->pulse_cnt     = STARTBIT_PULSENUM;
+                self->startbit_send = 1;
             } else {
-                // Just finished a pause → now send next carrier burst.
-                if (!startbit_send) {
-                    // First burst is the start bit (fixed length, not in tx_words).
-                    pulse_cnt     = STARTBIT_PULSENUM;
-                    startbit_send = 1;
-                } else {
-                    // Load the next data bit (LSB-first, 9 bits per word).
-                    uint8_t wordindex = (uint8_t)(bits_ptr / 9);
-                    uint8_t bitindex  = (uint8_t)(bits_ptr % 9);
-                    pulse_cnt = (tx_words[wordindex] & (uint16_t)(1u << bitindex))
-                                    ? ONE_PULSENUM : ZERO_PULSENUM;
-                    bits_ptr++;
-                }
-                timer_oc_state = 1;                              // next phase: pause
-                ledc_set_duty(LEDC_LOW_SPEED_MODE, ledc_ch, 127); // carrier ON (50% duty)
-                ledc_update_duty(LEDC_LOW_SPEED_MODE, ledc_ch);
+                // Load the next data bit (LSB-first, 9 bits per word).
+                typename CAPACITY::word_index_t wordindex = (typename CAPACITY::word_index_t)(self->bits_ptr / 9);
+                uint8_t bitindex  = (uint8_t)(self->bits_ptr % 9);
+                self->pulse_cnt = (self->tx_words[wordindex] & (uint16_t)(1u << bitindex))
+                                      ? ONE_PULSENUM : ZERO_PULSENUM;
+                self->bits_ptr++;
             }
-        } else {
-            pulse_cnt--;
+            self->timer_oc_state = 1;                              // next phase: pause
+            ledc_set_duty(LEDC_LOW_SPEED_MODE, self->ledc_ch, 127); // carrier ON (50% duty)
+            ledc_update_duty(LEDC_LOW_SPEED_MODE, self->ledc_ch);
         }
-
-        return false; // no high-priority task woken
+    } else {
+        self->pulse_cnt--;
     }
 
-    // -------------------------------------------------------------------------
-    // setup — called once from GdoorComponent::setup()
-    // -------------------------------------------------------------------------
-    void setup(uint8_t txpin, uint8_t txenpin) {
-        pin_tx    = txpin;
-        pin_tx_en = txenpin;
-
-        // --- GPIO outputs ---
-        gpio_set_direction((gpio_num_t)pin_tx_en, GPIO_MODE_OUTPUT);
-        gpio_set_level((gpio_num_t)pin_tx_en, 0);
-        // pin_tx direction is set by LEDC channel config below
-
-        // --- LEDC carrier: 52 kHz, 8-bit resolution (same frequency as gdoor-alt) ---
-        // Timer config — use LEDC_TIMER_1 (LEDC_TIMER_0 reserved for other use)
-        ledc_timer_config_t ledc_timer_cfg = {};
-        ledc_timer_cfg.speed_mode      = LEDC_LOW_SPEED_MODE;
-        ledc_timer_cfg.timer_num       = LEDC_TIMER_1;
-        ledc_timer_cfg.duty_resolution = LEDC_TIMER_8_BIT;
-        ledc_timer_cfg.freq_hz         = 52000;
-        ledc_timer_cfg.clk_cfg         = LEDC_AUTO_CLK;
-        ledc_timer_config(&ledc_timer_cfg);
-
-        // Channel config — use LEDC_CHANNEL_0, duty=0 (carrier off initially)
-        ledc_ch = LEDC_CHANNEL_0;
-        ledc_channel_config_t ledc_ch_cfg = {};
-        ledc_ch_cfg.speed_mode = LEDC_LOW_SPEED_MODE;
-        ledc_ch_cfg.channel    = ledc_ch;
-        ledc_ch_cfg.timer_sel  = LEDC_TIMER_1;
-        ledc_ch_cfg.intr_type  = LEDC_INTR_DISABLE;
-        ledc_ch_cfg.gpio_num   = (int)pin_tx;
-        ledc_ch_cfg.duty       = 0;
-        ledc_ch_cfg.hpoint     = 0;
-        ledc_channel_config(&ledc_ch_cfg);
-
-        // --- GPTIMER: 60 kHz resolution → fires ISR every 16.67 µs ---
-        gptimer_config_t timer_config = {};
-        timer_config.clk_src     = GPTIMER_CLK_SRC_DEFAULT;
-        timer_config.direction   = GPTIMER_COUNT_UP;
-        timer_config.resolution_hz = 60000; // 60 kHz
-        gptimer_new_timer(&timer_config, &timer_60khz);
-
-        gptimer_event_callbacks_t cbs = {};
-        cbs.on_alarm = isr_timer_60khz;
-        gptimer_register_event_callbacks(timer_60khz, &cbs, nullptr);
-
-        gptimer_alarm_config_t alarm_config = {};
-        alarm_config.alarm_count  = 1;   // alarm every 1 tick = every 16.67 µs
-        alarm_config.reload_count = 0;
-        alarm_config.flags.auto_reload_on_alarm = true;
-        gptimer_set_alarm_action(timer_60khz, &alarm_config);
-
-        // Enable and start — timer runs always; ISR returns immediately when
-        // tx_active == false, keeping idle overhead negligible (~3 µs/ms).
-        gptimer_enable(timer_60khz);
-        gptimer_start(timer_60khz);
-
-        // Initial state
-        tx_active    = false;
-        tx_just_done = false;
-        tx_state     = 0;
-        bits_len     = 0;
-
-        ESP_LOGCONFIG(TAG, "GDoor TX setup:");
-        ESP_LOGCONFIG(TAG, "  TX pin      : GPIO %u", pin_tx);
-        ESP_LOGCONFIG(TAG, "  TX EN pin   : GPIO %u", pin_tx_en);
-        ESP_LOGCONFIG(TAG, "  Carrier     : 52000 Hz");
-        ESP_LOGCONFIG(TAG, "  Timer       : 60000 Hz (GPTIMER)");
-        ESP_LOGCONFIG(TAG, "  LEDC ch     : %u", (uint8_t)ledc_ch);
+    return false; // no high-priority task woken
+}
+
+// -------------------------------------------------------------------------
+// setup — called once per bus from GDOOR::setup()
+// @return false if the GPTIMER could not be allocated
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+bool GDOOR_TX_T<WORDS>::setup(uint8_t txpin, uint8_t txenpin, GDOOR_RX_T<WORDS> *rx,
+                              ledc_channel_t channel, ledc_timer_t timer) {
+    pin_tx     = txpin;
+    pin_tx_en  = txenpin;
+    this->rx   = rx;
+    ledc_ch    = channel;
+    ledc_timer = timer;
+
+    // --- GPIO outputs ---
+    gpio_set_direction((gpio_num_t)pin_tx_en, GPIO_MODE_OUTPUT);
+    gpio_set_level((gpio_num_t)pin_tx_en, 0);
+    // pin_tx direction is set by LEDC channel config below
+
+    // --- LEDC carrier: 52 kHz, 8-bit resolution (same frequency as gdoor-alt) ---
+    // Timer config — per-bus LEDC timer (LEDC_TIMER_0 reserved for other use)
+    ledc_timer_config_t ledc_timer_cfg = {};
+    ledc_timer_cfg.speed_mode      = LEDC_LOW_SPEED_MODE;
+    ledc_timer_cfg.timer_num       = ledc_timer;
+    ledc_timer_cfg.duty_resolution = LEDC_TIMER_8_BIT;
+    ledc_timer_cfg.freq_hz         = 52000;
+    ledc_timer_cfg.clk_cfg         = LEDC_AUTO_CLK;
+    ledc_timer_config(&ledc_timer_cfg);
+
+    // Channel config — per-bus LEDC channel, duty=0 (carrier off initially)
+    ledc_channel_config_t ledc_ch_cfg = {};
+    ledc_ch_cfg.speed_mode = LEDC_LOW_SPEED_MODE;
+    ledc_ch_cfg.channel    = ledc_ch;
+    ledc_ch_cfg.timer_sel  = ledc_timer;
+    ledc_ch_cfg.intr_type  = LEDC_INTR_DISABLE;
+    ledc_ch_cfg.gpio_num   = (int)pin_tx;
+    ledc_ch_cfg.duty       = 0;
+    ledc_ch_cfg.hpoint     = 0;
+    ledc_channel_config(&ledc_ch_cfg);
+
+    // --- GPTIMER: 60 kHz resolution → fires ISR every 16.67 µs ---
+    gptimer_config_t timer_config = {};
+    timer_config.clk_src     = GPTIMER_CLK_SRC_DEFAULT;
+    timer_config.direction   = GPTIMER_COUNT_UP;
+    timer_config.resolution_hz = TIMER_FREQ_TX; // 60 kHz
+    esp_err_t err = gptimer_new_timer(&timer_config, &timer_60khz);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "No free GPTIMER for TX on GPIO %u: %d", pin_tx, err);
+        timer_60khz = nullptr;
+        return false;
     }
 
-    // -------------------------------------------------------------------------
-    // send (byte buffer) — called from main context
-    // -------------------------------------------------------------------------
-    void send(uint8_t *data, uint16_t len) {
-        if ((tx_state & STATE_SENDING) || len >= MAX_WORDLEN) return;
-
-        bits_ptr  = 0;
-        pulse_cnt = 0;
-
-        // Build 9-bit words (8 data + 1 odd-parity), LSB-first
-        for (uint16_t i = 0; i < len; i++) {
-            tx_words[i] = byte2word(data[i]);
-        }
-        // Append CRC (sum of all data bytes) as the final word
-        uint8_t crc = GDOOR_UTILS::crc(data, len);
-        tx_words[len] = byte2word(crc);
+    // Integer prescaler: 80 MHz / 1333 = 60015 Hz, timed sends count with that
+    tick_hz = TIMER_FREQ_TX;
+    gptimer_get_resolution(timer_60khz, &tick_hz);
+    rx_clock = rx->clock();
+
+    gptimer_event_callbacks_t cbs = {};
+    cbs.on_alarm = isr_timer_60khz;
+    gptimer_register_event_callbacks(timer_60khz, &cbs, this);
+
+    gptimer_alarm_config_t alarm_config = {};
+    alarm_config.alarm_count  = 1;   // alarm every 1 tick = every 16.67 µs
+    alarm_config.reload_count = 0;
+    alarm_config.flags.auto_reload_on_alarm = true;
+    gptimer_set_alarm_action(timer_60khz, &alarm_config);
+
+    // Enable and start — timer runs always; ISR returns immediately when
+    // tx_active == false, keeping idle overhead negligible (~3 µs/ms).
+    gptimer_enable(timer_60khz);
+    gptimer_start(timer_60khz);
+
+    // Initial state
+    tx_active    = false;
+    tx_just_done = false;
+    tx_state     = 0;
+    bits_len     = 0;
+
+    ESP_LOGCONFIG(TAG, "GDoor TX setup:");
+    ESP_LOGCONFIG(TAG, "  TX pin      : GPIO %u", pin_tx);
+    ESP_LOGCONFIG(TAG, "  TX EN pin   : GPIO %u", pin_tx_en);
+    ESP_LOGCONFIG(TAG, "  Carrier     : 52000 Hz");
+    ESP_LOGCONFIG(TAG, "  Timer       : 60000 Hz (GPTIMER)");
+    ESP_LOGCONFIG(TAG, "  LEDC ch     : %u", (uint8_t)ledc_ch);
+    ESP_LOGCONFIG(TAG, "  LEDC timer  : %u", (uint8_t)ledc_timer);
+    return true;
+}
+
+// -------------------------------------------------------------------------
+// load — build the TX words of a frame, called from main context
+// @return false if the frame was dropped (TX busy or too long)
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+bool GDOOR_TX_T<WORDS>::load(const uint8_t *data, uint16_t len) {
+    // The CRC word takes the last slot of tx_words
+    if ((tx_state & STATE_SENDING) || len >= WORDS) {
+        tx_stats.dropped++;
+        return false;
+    }
 
-        // bits_len = data words + CRC word, each 9 bits.
-        // The start bit is NOT counted here; the ISR handles it separately
-        // via startbit_send, matching the original gdoor-alt design.
-        bits_len = (uint16_t)((len + 1) * 9);
+    bits_ptr  = 0;
+    pulse_cnt = 0;
 
-        ESP_LOGV(TAG, "TX send: %u bytes + CRC 0x%02X, bits_len=%u", len, (unsigned)crc, bits_len);
-        start_timer();
+    // Build 9-bit words (8 data + 1 odd-parity), LSB-first
+    for (uint16_t i = 0; i < len; i++) {
+        tx_words[i] = byte2word(data[i]);
     }
-
-    // -------------------------------------------------------------------------
-    // send (hex string) — accepts a C string of hex pairs (e.g. "A1B2C3")
-    // -------------------------------------------------------------------------
-    static uint8_t tx_strbuffer[MAX_WORDLEN * 2]; // module-level parse buffer
-
-    void send(const char *str) {
-        if (!str || *str == '\0') return;
-        size_t slen = strlen(str);
-        if (slen >= (size_t)(MAX_WORDLEN * 2)) return;
-
-        uint16_t index = 0;
-        for (size_t i = 0; i + 1 < slen; i += 2) {
-            int high = hex_digit(str[i]);
-            int low  = hex_digit(str[i + 1]);
-            if (high < 0 || low < 0) {
-                index = 0;
-                break;
-            }
-            tx_strbuffer[index++] = (uint8_t)((high << 4) | low);
-        }
-        if (index > 0) {
-            send(tx_strbuffer, index);
-        }
+    // Append CRC (sum of all data bytes) as the final word
+    uint8_t crc = GDOOR_UTILS::crc(data, len);
+    tx_words[len] = byte2word(crc);
+
+    // bits_len = data words + CRC word, each 9 bits.
+    // The start bit is NOT counted here; the ISR handles it separately
+    // via startbit_send, matching the original gdoor-alt design.
+    bits_len = (uint16_t)((len + 1) * 9);
+
+    ESP_LOGV(TAG, "TX send: %u bytes + CRC 0x%02X, bits_len=%u", len, (unsigned)crc, bits_len);
+    tx_stats.sent++;
+    return true;
+}
+
+// -------------------------------------------------------------------------
+// send (byte buffer) — called from main context
+// @return false if the frame was dropped (TX busy or too long)
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+bool GDOOR_TX_T<WORDS>::send(const uint8_t *data, uint16_t len) {
+    if (!load(data, len)) return false;
+    timed = false;
+    start_timer(0);
+    return true;
+}
+
+// -------------------------------------------------------------------------
+// send_at — called from main context
+// The wait is counted down by the TX ISR, so the main loop only has to arm
+// the send before the target time; a target already passed starts on the
+// next tick. Achieved vs requested offset is recorded when TX completes.
+// @return false if the frame was dropped (TX busy, too long, or the target
+//         more than SEND_AT_AHEAD_MAX_US ahead)
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+bool GDOOR_TX_T<WORDS>::send_at(const uint8_t *data, uint16_t len, int64_t reference_us, uint32_t offset_us) {
+    int64_t target = reference_us + offset_us;
+    int64_t wait_us = target - rx->now_us();
+    if (wait_us > (int64_t)SEND_AT_AHEAD_MAX_US) {
+        tx_stats.dropped++;
+        return false;
+    }
+    if (!load(data, len)) return false;
+    timed = true;
+    timed_reference_us = reference_us;
+    timed_target_us    = target;
+    // Round up to whole ticks, at least one so the ISR stamps the start
+    uint32_t ticks = wait_us > 0 ? (uint32_t)((wait_us * tick_hz + 999999) / 1000000) : 0;
+    start_timer(ticks > 0 ? ticks : 1);
+    return true;
+}
+
+// -------------------------------------------------------------------------
+// send (hex string) — accepts a C string of hex pairs (e.g. "A1B2C3")
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+bool GDOOR_TX_T<WORDS>::send(const char *str) {
+    if (!str || *str == '\0') return false;
+    size_t slen = strlen(str);
+    if (slen >= (size_t)WORDS * 2) {
+        tx_stats.dropped++;
+        return false;
     }
 
-    // -------------------------------------------------------------------------
-    // loop — must be called from GdoorComponent::loop() / GDOOR::loop()
-    // Deferred RX re-enable after TX completes (attachInterrupt not ISR-safe).
-    // -------------------------------------------------------------------------
-    void loop() {
-        if (tx_just_done) {
-            tx_just_done = false;
-            // enable() clears state + disables pending timer alarms + re-attaches interrupt.
-            // Discards any stale RX data that was captured from our own TX signal.
-            GDOOR_RX::enable();
-            ESP_LOGV(TAG, "TX done, RX re-enabled");
+    uint16_t index = 0;
+    for (size_t i = 0; i + 1 < slen; i += 2) {
+        int high = hex_digit(str[i]);
+        int low  = hex_digit(str[i + 1]);
+        if (high < 0 || low < 0) {
+            index = 0;
+            break;
         }
+        tx_strbuffer[index++] = (uint8_t)((high << 4) | low);
     }
-
-    // -------------------------------------------------------------------------
-    // busy — replaces tx_state extern used in gdoor-alt's active() check
-    // -------------------------------------------------------------------------
-    bool busy() {
-        return (tx_state & STATE_SENDING) != 0;
+    if (index > 0) {
+        return send(tx_strbuffer, index);
     }
-
-} // namespace GDOOR_TX
+    tx_stats.dropped++;
+    return false;
+}
+
+// -------------------------------------------------------------------------
+// loop — must be called from GDOOR::loop()
+// Deferred RX re-enable after TX completes (attachInterrupt not ISR-safe).
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+void GDOOR_TX_T<WORDS>::loop() {
+    if (tx_just_done) {
+        tx_just_done = false;
+        // enable() clears state + disables pending timer alarms + re-attaches interrupt.
+        // Discards any stale RX data that was captured from our own TX signal.
+        rx->enable();
+        ESP_LOGV(TAG, "TX done, RX re-enabled");
+        if (timed) {
+            timed = false;
+            int32_t requested = (int32_t)(timed_target_us - timed_reference_us);
+            int32_t achieved  = (int32_t)(rx->ticks_to_us(started_ticks) - timed_reference_us);
+            tx_stats.timed_requested_us = requested;
+            tx_stats.timed_achieved_us  = achieved;
+            tx_stats.timed_error.add((uint32_t)(achieved > requested ? achieved - requested : requested - achieved));
+            ESP_LOGD(TAG, "Timed TX: requested offset %" PRId32 " us, achieved %" PRId32 " us", requested, achieved);
+        }
+    }
+}
+
+// -------------------------------------------------------------------------
+// busy — replaces tx_state extern used in gdoor-alt's active() check
+// -------------------------------------------------------------------------
+template<uint16_t WORDS>
+bool GDOOR_TX_T<WORDS>::busy() {
+    return (tx_state & STATE_SENDING) != 0;
+}
+
+// IRAM_ATTR only takes on the explicit instantiation, see gdoor_rx.cpp
+template void IRAM_ATTR GDOOR_TX_T<MAX_WORDLEN>::stop_timer_from_isr();
+template bool IRAM_ATTR GDOOR_TX_T<MAX_WORDLEN>::isr_timer_60khz(
+    gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx);
+template class GDOOR_TX_T<MAX_WORDLEN>;
@@ -21,13 +21,75 @@
 #include "driver/gptimer.h"
 #include "driver/ledc.h"
 #include "driver/gpio.h"
+#include "defines.h"
+#include "gdoor_capacity.h"
+#include "gdoor_stats.h"
 
-namespace GDOOR_TX { //Namespace as we can only use it once
-    void loop();    // checks for TX completion, re-enables RX in main context
-    void send(uint8_t *words, uint16_t len);
-    void send(const char *str);
-    void setup(uint8_t txpin, uint8_t txenpin);
-    bool busy();
+template<uint16_t WORDS> class GDOOR_RX_T;
+
+template<uint16_t WORDS>
+class GDOOR_TX_T { // One instance per bus; the ISR reaches it through its user context
+    public:
+        typedef GDOOR_CAPACITY<WORDS> CAPACITY;
+
+        bool setup(uint8_t txpin, uint8_t txenpin, GDOOR_RX_T<WORDS> *rx,
+                   ledc_channel_t channel, ledc_timer_t timer);
+        void loop();    // checks for TX completion, re-enables RX in main context
+        bool send(const uint8_t *words, uint16_t len);
+        bool send(const char *str);
+        // Send offset_us after reference_us, a time on the RX clock (the
+        // end_us of a received frame, or GDOOR_RX::now_us()), timed by the
+        // TX GPTIMER tick
+        bool send_at(const uint8_t *words, uint16_t len, int64_t reference_us, uint32_t offset_us);
+        bool busy();
+        const GDOOR_TX_STATS &stats() const { return tx_stats; }
+
+        // Timed sends may be armed at most this far ahead; RX is off meanwhile
+        static const uint32_t SEND_AT_AHEAD_MAX_US = 50000;
+
+    private:
+        static bool isr_timer_60khz(gptimer_handle_t timer, const gptimer_alarm_event_data_t *edata, void *user_ctx);
+        bool load(const uint8_t *data, uint16_t len);
+        void start_timer(uint32_t delay_ticks);
+        void stop_timer_from_isr();
+
+        volatile uint16_t tx_state    = 0;
+        volatile uint16_t tx_words[WORDS]; // data words + CRC word, 9 bits each
+        volatile uint16_t bits_len    = 0;
+        volatile uint16_t bits_ptr    = 0;
+        volatile uint16_t pulse_cnt   = 0;
+        volatile uint8_t  startbit_send = 0;
+        volatile uint8_t  timer_oc_state = 0;
+
+        // GPTIMER design: timer runs always; ISR is gated by tx_active flag.
+        // tx_just_done signals loop() to call rx->enable() in main context.
+        volatile bool tx_active    = false;
+        volatile bool tx_just_done = false;
+
+        // Timed send: ticks left before the ISR keys the bus, and the RX
+        // GPTIMER count when it did, so the achieved offset is measured on
+        // the clock of the received frame
+        volatile uint32_t start_delay   = 0;
+        volatile uint64_t started_ticks = 0;
+        gptimer_handle_t rx_clock       = nullptr;
+        uint32_t tick_hz                = TIMER_FREQ_TX; // real rate of the TX timer
+        bool    timed              = false;
+        int64_t timed_reference_us = 0;
+        int64_t timed_target_us    = 0;
+
+        gptimer_handle_t timer_60khz = nullptr;
+        ledc_channel_t   ledc_ch     = LEDC_CHANNEL_0;
+        ledc_timer_t     ledc_timer  = LEDC_TIMER_1;
+        GDOOR_RX_T<WORDS> *rx        = nullptr;
+
+        uint8_t pin_tx    = 0;
+        uint8_t pin_tx_en = 0;
+
+        uint8_t tx_strbuffer[WORDS]; // hex string parse buffer, at most WORDS - 1 bytes
+        GDOOR_TX_STATS tx_stats;
 };
 
+// TX engine of this build, sized by MAX_WORDLEN
+typedef GDOOR_TX_T<MAX_WORDLEN> GDOOR_TX;
+
 #endif
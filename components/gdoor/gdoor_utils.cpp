@@ -17,7 +17,7 @@
 #include "gdoor_utils.h"
 
 namespace GDOOR_UTILS {
-    uint8_t crc(uint8_t *words, uint16_t len) {
+    uint8_t crc(const uint8_t *words, uint16_t len) {
         uint8_t crc = 0;
         for(uint16_t i=0; i<len; i++) {//iterate over all words
             crc = crc + words[i];
@@ -38,6 +38,18 @@ namespace GDOOR_UTILS {
         return ones &0x01;
     }
 
+    /*
+    * 32-bit FNV-1a hash over a frame, used to recognise repeated telegrams.
+    */
+    uint32_t hash(const uint8_t *words, uint16_t len) {
+        uint32_t h = 2166136261u;
+        for(uint16_t i=0; i<len; i++) {
+            h ^= words[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
     size_t print_json_string(Print& p, const char *keyname, const char *value) {
         size_t r = 0;
         r+= p.print("\"");
@@ -16,18 +16,77 @@
  */
 #ifndef GDOOR_UTILS_H
 #define GDOOR_UTILS_H
+#include <string.h>
 #include "gdoor_print.h"
 
 namespace GDOOR_UTILS {
-    uint8_t crc(uint8_t *words, uint16_t len);
+    static const char HEX_CHARS[] = "0123456789ABCDEF";
+
+    uint8_t crc(const uint8_t *words, uint16_t len);
     uint8_t parity_odd(uint8_t word);
+    uint32_t hash(const uint8_t *words, uint16_t len);
 
     // Print an integer as uppercase hex without leading zeros.
     static inline size_t _print_hex_upper(Print& p, uint32_t v) {
-        static const char HC[] = "0123456789ABCDEF";
-        char buf[9]; buf[8] = '\0'; int i = 8;
-        do { buf[--i] = HC[v & 0xF]; v >>= 4; } while (v);
-        return p.print(&buf[i]);
+        char buf[8]; int i = 8;
+        do { buf[--i] = HEX_CHARS[v & 0xF]; v >>= 4; } while (v);
+        return p.write(&buf[i], (size_t)(8 - i));
+    }
+
+    /*
+    * Direct serializer helpers: write into a caller-sized char buffer
+    * and return the advanced output pointer. Paired *_len() functions
+    * give the exact number of chars written, so a whole JSON object
+    * can be sized up front and rendered in a single pass.
+    */
+    static inline char *put_str(char *out, const char *s, size_t n) {
+        memcpy(out, s, n);
+        return out + n;
+    }
+
+    template<size_t N> static inline char *put_lit(char *out, const char (&s)[N]) {
+        return put_str(out, s, N - 1);
+    }
+
+    // Fixed-width, two chars per byte ("0A1B...")
+    static inline char *put_hexbytes(char *out, const uint8_t *data, uint16_t len) {
+        for (uint16_t i = 0; i < len; i++) {
+            *out++ = HEX_CHARS[data[i] >> 4];
+            *out++ = HEX_CHARS[data[i] & 0xF];
+        }
+        return out;
+    }
+
+    // Number of hex digits without leading zeros (at least one)
+    static inline uint8_t hex_len(uint32_t v) {
+        uint8_t n = 1;
+        while (v >>= 4) n++;
+        return n;
+    }
+
+    static inline char *put_hex(char *out, uint32_t v) {
+        uint8_t n = hex_len(v);
+        for (uint8_t i = n; i > 0; i--) {
+            out[i - 1] = HEX_CHARS[v & 0xF];
+            v >>= 4;
+        }
+        return out + n;
+    }
+
+    // Number of decimal digits (at least one)
+    static inline uint8_t dec_len(uint32_t v) {
+        uint8_t n = 1;
+        while (v >= 10) { v /= 10; n++; }
+        return n;
+    }
+
+    static inline char *put_dec(char *out, uint32_t v) {
+        uint8_t n = dec_len(v);
+        for (uint8_t i = n; i > 0; i--) {
+            out[i - 1] = (char)('0' + v % 10);
+            v /= 10;
+        }
+        return out + n;
     }
 
     uint16_t divider(uint32_t frequency);
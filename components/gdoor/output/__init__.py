@@ -3,6 +3,7 @@ import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import output
 from esphome.const import CONF_NAME
+from esphome.core import ID
 from .. import DOMAIN, GdoorComponent, gdoor_esphome_ns
 
 CODEOWNERS = ["@dtill"]
@@ -64,7 +65,11 @@ async def to_code(config):
     await cg.register_component(var, config)
     await output.register_output(var, config)
     cg.add(var.set_parent(parent))
-    cg.add(var.set_payload(config[CONF_PAYLOAD]))
+    # Payload bytes live in flash, nothing is copied at boot
+    payload = list(bytes.fromhex(config[CONF_PAYLOAD]))
+    payload_id = ID(f"{config[cv.GenerateID()].id}_payload", is_declaration=True, type=cg.uint8)
+    table = cg.static_const_array(payload_id, payload)
+    cg.add(var.set_payload(table, len(payload)))
     cg.add(var.set_require_response(config[CONF_REQUIRE_RESPONSE]))
     if CONF_TX_EVENT_ID in config:
         tx_event = await cg.get_variable(config[CONF_TX_EVENT_ID])
@@ -4,6 +4,7 @@
 #include "esphome/components/output/binary_output.h"
 #include "../gdoor_component.h"
 #include "../gdoor_bus_listener.h"
+#include "../gdoor_frame_table.h"
 
 namespace esphome {
 namespace gdoor_esphome {
@@ -11,18 +12,22 @@ namespace gdoor_esphome {
 class GDoorBusWrite : public output::BinaryOutput, public Component {
  public:
   void dump_config() override;
-  void loop() override {};
   void write_state(bool state) override;
 
   void set_parent(GdoorComponent *parent) { this->parent_ = parent; }
-  void set_payload(const std::string &payload) { this->payload_ = payload; }
+  // Flash-resident payload bytes (incl. CRC) emitted by the Python codegen
+  void set_payload(const uint8_t *payload, uint16_t len) {
+    this->payload_ = payload;
+    this->payload_len_ = len;
+  }
   void set_require_response(bool require_response) { this->require_response_ = require_response; }
   void set_tx_event(GDoorTxTarget *event) { this->tx_event_ = event; }
   void set_tx_event_type(const std::string &event_type) { this->tx_event_type_ = event_type; }
 
  protected:
   GdoorComponent *parent_{nullptr};
-  std::string payload_;
+  const uint8_t *payload_{nullptr};
+  uint16_t payload_len_{0};
   bool require_response_{false};
   GDoorTxTarget *tx_event_{nullptr};
   std::string tx_event_type_;
@@ -0,0 +1,106 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome.components import sensor
+from esphome.const import (
+    CONF_ID,
+    DEVICE_CLASS_VOLTAGE,
+    ENTITY_CATEGORY_DIAGNOSTIC,
+    STATE_CLASS_MEASUREMENT,
+    STATE_CLASS_TOTAL_INCREASING,
+    UNIT_VOLT,
+)
+from .. import DOMAIN, GdoorComponent, gdoor_esphome_ns
+
+CODEOWNERS = ["@dtill"]
+DEPENDENCIES = [DOMAIN]
+
+GDoorStatsSensor = gdoor_esphome_ns.class_("GDoorStatsSensor", cg.PollingComponent)
+
+# Totals since boot
+COUNTERS = [
+    "frames_received",
+    "parity_errors",
+    "crc_errors",
+    "filtered_pulses",
+    "startbits_rejected",
+    "buffer_overruns",
+    "tx_sent",
+    "tx_dropped",
+    "suppressed_repeats",
+]
+
+# Average duration per frame over the last update interval
+TIMINGS = [
+    "parse_time",
+    "render_time",
+    "dispatch_time",
+    "tx_timing_error",  # |achieved - requested| offset of timed replies
+]
+
+# 99th percentile ISR duration since boot; configuring any of these turns on
+# the ISR profiling build (same as profile_isr on the gdoor component)
+ISR_PROFILES = [
+    "isr_rx_edge",
+    "isr_rx_bit",
+    "isr_rx_frame",
+    "isr_tx_tick",
+]
+
+# 90th percentile time from the first bus edge to a stage, over the most recent
+# frames; configuring any of these turns on latency tracing (trace_latency)
+LATENCY_TRACES = [
+    "latency_parsed",
+    "latency_dispatched",
+    "latency_published",
+]
+
+# RX comparator threshold in use, moves with rx_sens: auto
+CONF_RX_THRESHOLD = "rx_threshold"
+
+COUNTER_SCHEMA = sensor.sensor_schema(
+    accuracy_decimals=0,
+    state_class=STATE_CLASS_TOTAL_INCREASING,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    icon="mdi:counter",
+)
+
+TIMING_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement="µs",
+    accuracy_decimals=1,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+    icon="mdi:timer-outline",
+)
+
+THRESHOLD_SCHEMA = sensor.sensor_schema(
+    unit_of_measurement=UNIT_VOLT,
+    device_class=DEVICE_CLASS_VOLTAGE,
+    accuracy_decimals=2,
+    state_class=STATE_CLASS_MEASUREMENT,
+    entity_category=ENTITY_CATEGORY_DIAGNOSTIC,
+)
+
+CONFIG_SCHEMA = cv.Schema({
+    cv.GenerateID(): cv.declare_id(GDoorStatsSensor),
+    cv.Required("gdoor_id"): cv.use_id(GdoorComponent),
+    **{cv.Optional(key): COUNTER_SCHEMA for key in COUNTERS},
+    **{cv.Optional(key): TIMING_SCHEMA for key in TIMINGS},
+    **{cv.Optional(key): TIMING_SCHEMA for key in ISR_PROFILES},
+    **{cv.Optional(key): TIMING_SCHEMA for key in LATENCY_TRACES},
+    cv.Optional(CONF_RX_THRESHOLD): THRESHOLD_SCHEMA,
+}).extend(cv.polling_component_schema("60s"))
+
+
+async def to_code(config):
+    parent = await cg.get_variable(config["gdoor_id"])
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    cg.add(var.set_parent(parent))
+    if any(key in config for key in ISR_PROFILES):
+        cg.add_define("USE_GDOOR_ISR_PROFILING")
+    if any(key in config for key in LATENCY_TRACES):
+        cg.add_define("USE_GDOOR_LATENCY_TRACE")
+    for key in COUNTERS + TIMINGS + ISR_PROFILES + LATENCY_TRACES + [CONF_RX_THRESHOLD]:
+        if key in config:
+            sens = await sensor.new_sensor(config[key])
+            cg.add(getattr(var, f"set_{key}_sensor")(sens))
@@ -0,0 +1,118 @@
+#include "esphome/core/log.h"
+#include "gdoor_stats_sensor.h"
+#ifdef USE_GDOOR_ISR_PROFILING
+#include "esp_rom_sys.h"
+#endif
+
+namespace esphome {
+namespace gdoor_esphome {
+
+static const char *TAG = "gdoor_esphome.stats_sensor";
+
+void GDoorStatsSensor::publish_timing_(sensor::Sensor *sens, const GDOOR_TIMING &timing, TimingSnapshot &prev) {
+  uint32_t samples = timing.samples - prev.samples;
+  uint64_t total_us = timing.total_us - prev.total_us;
+  prev.samples = timing.samples;
+  prev.total_us = timing.total_us;
+  // No frames in this interval: keep the last average instead of reporting 0
+  if (sens == nullptr || samples == 0) {
+    return;
+  }
+  sens->publish_state((float) total_us / (float) samples);
+}
+
+#ifdef USE_GDOOR_ISR_PROFILING
+static void publish_isr_p99(sensor::Sensor *sens, const GDOOR_ISR_HISTOGRAM &hist) {
+  if (sens == nullptr || hist.count == 0) {
+    return;
+  }
+  sens->publish_state((float) hist.percentile(99) / (float) esp_rom_get_cpu_ticks_per_us());
+}
+#endif
+
+#ifdef USE_GDOOR_LATENCY_TRACE
+static void publish_latency_p90(sensor::Sensor *sens, const GDOOR_TRACE_RING &ring, GDOOR_TRACE_STAGE stage) {
+  uint32_t us;
+  if (sens == nullptr || !ring.percentile(stage, 90, &us)) {
+    return;
+  }
+  sens->publish_state((float) us);
+}
+#endif
+
+void GDoorStatsSensor::update() {
+  if (this->parent_ == nullptr) {
+    return;
+  }
+  const GDOOR_RX_STATS &rx = this->parent_->rx_stats();
+  const GDOOR_TX_STATS &tx = this->parent_->tx_stats();
+
+  if (this->frames_received_sensor_ != nullptr)
+    this->frames_received_sensor_->publish_state(rx.frames);
+  if (this->parity_errors_sensor_ != nullptr)
+    this->parity_errors_sensor_->publish_state(rx.parity_errors);
+  if (this->crc_errors_sensor_ != nullptr)
+    this->crc_errors_sensor_->publish_state(rx.crc_errors);
+  if (this->filtered_pulses_sensor_ != nullptr)
+    this->filtered_pulses_sensor_->publish_state(rx.filtered_pulses);
+  if (this->startbits_rejected_sensor_ != nullptr)
+    this->startbits_rejected_sensor_->publish_state(rx.startbits_rejected);
+  if (this->buffer_overruns_sensor_ != nullptr)
+    this->buffer_overruns_sensor_->publish_state(rx.overruns);
+  if (this->tx_sent_sensor_ != nullptr)
+    this->tx_sent_sensor_->publish_state(tx.sent);
+  if (this->tx_dropped_sensor_ != nullptr)
+    this->tx_dropped_sensor_->publish_state(tx.dropped);
+  if (this->suppressed_repeats_sensor_ != nullptr)
+    this->suppressed_repeats_sensor_->publish_state(this->parent_->get_suppressed_repeats());
+
+  this->publish_timing_(this->parse_time_sensor_, rx.parse, this->parse_prev_);
+  this->publish_timing_(this->render_time_sensor_, this->parent_->render_timing(), this->render_prev_);
+  this->publish_timing_(this->dispatch_time_sensor_, this->parent_->dispatch_timing(), this->dispatch_prev_);
+  this->publish_timing_(this->tx_timing_error_sensor_, tx.timed_error, this->tx_timing_error_prev_);
+
+  if (this->rx_threshold_sensor_ != nullptr)
+    this->rx_threshold_sensor_->publish_state(this->parent_->rx_threshold());
+
+#ifdef USE_GDOOR_ISR_PROFILING
+  publish_isr_p99(this->isr_rx_edge_sensor_, rx.isr_edge);
+  publish_isr_p99(this->isr_rx_bit_sensor_, rx.isr_bit);
+  publish_isr_p99(this->isr_rx_frame_sensor_, rx.isr_frame);
+  publish_isr_p99(this->isr_tx_tick_sensor_, tx.isr_tick);
+#endif
+#ifdef USE_GDOOR_LATENCY_TRACE
+  const GDOOR_TRACE_RING &trace = this->parent_->latency_trace();
+  publish_latency_p90(this->latency_parsed_sensor_, trace, TRACE_PARSED);
+  publish_latency_p90(this->latency_dispatched_sensor_, trace, TRACE_DISPATCHED);
+  publish_latency_p90(this->latency_published_sensor_, trace, TRACE_PUBLISHED);
+#endif
+}
+
+void GDoorStatsSensor::dump_config() {
+  ESP_LOGCONFIG(TAG, "GDoor Stats Sensor");
+  LOG_UPDATE_INTERVAL(this);
+  LOG_SENSOR("  ", "Frames received", this->frames_received_sensor_);
+  LOG_SENSOR("  ", "Parity errors", this->parity_errors_sensor_);
+  LOG_SENSOR("  ", "CRC errors", this->crc_errors_sensor_);
+  LOG_SENSOR("  ", "Filtered pulses", this->filtered_pulses_sensor_);
+  LOG_SENSOR("  ", "Start bits rejected", this->startbits_rejected_sensor_);
+  LOG_SENSOR("  ", "Buffer overruns", this->buffer_overruns_sensor_);
+  LOG_SENSOR("  ", "TX sent", this->tx_sent_sensor_);
+  LOG_SENSOR("  ", "TX dropped", this->tx_dropped_sensor_);
+  LOG_SENSOR("  ", "Suppressed repeats", this->suppressed_repeats_sensor_);
+  LOG_SENSOR("  ", "Parse time", this->parse_time_sensor_);
+  LOG_SENSOR("  ", "Render time", this->render_time_sensor_);
+  LOG_SENSOR("  ", "Dispatch time", this->dispatch_time_sensor_);
+  LOG_SENSOR("  ", "TX timing error", this->tx_timing_error_sensor_);
+  LOG_SENSOR("  ", "ISR RX edge p99", this->isr_rx_edge_sensor_);
+  LOG_SENSOR("  ", "ISR RX bit p99", this->isr_rx_bit_sensor_);
+  LOG_SENSOR("  ", "ISR RX frame p99", this->isr_rx_frame_sensor_);
+  LOG_SENSOR("  ", "ISR TX tick p99", this->isr_tx_tick_sensor_);
+  LOG_SENSOR("  ", "Latency parsed p90", this->latency_parsed_sensor_);
+  LOG_SENSOR("  ", "Latency dispatched p90", this->latency_dispatched_sensor_);
+  LOG_SENSOR("  ", "Latency published p90", this->latency_published_sensor_);
+  LOG_SENSOR("  ", "RX threshold", this->rx_threshold_sensor_);
+}
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
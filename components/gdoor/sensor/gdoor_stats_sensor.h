@@ -0,0 +1,54 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/components/sensor/sensor.h"
+#include "../gdoor_component.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+class GDoorStatsSensor : public PollingComponent {
+  SUB_SENSOR(frames_received)
+  SUB_SENSOR(parity_errors)
+  SUB_SENSOR(crc_errors)
+  SUB_SENSOR(filtered_pulses)
+  SUB_SENSOR(startbits_rejected)
+  SUB_SENSOR(buffer_overruns)
+  SUB_SENSOR(tx_sent)
+  SUB_SENSOR(tx_dropped)
+  SUB_SENSOR(suppressed_repeats)
+  SUB_SENSOR(parse_time)
+  SUB_SENSOR(render_time)
+  SUB_SENSOR(dispatch_time)
+  SUB_SENSOR(tx_timing_error)
+  SUB_SENSOR(isr_rx_edge)
+  SUB_SENSOR(isr_rx_bit)
+  SUB_SENSOR(isr_rx_frame)
+  SUB_SENSOR(isr_tx_tick)
+  SUB_SENSOR(latency_parsed)
+  SUB_SENSOR(latency_dispatched)
+  SUB_SENSOR(latency_published)
+  SUB_SENSOR(rx_threshold)
+
+ public:
+  void update() override;
+  void dump_config() override;
+  void set_parent(GdoorComponent *parent) { this->parent_ = parent; }
+
+ protected:
+  // Snapshot of a GDOOR_TIMING at the previous update, to average per interval
+  struct TimingSnapshot {
+    uint64_t total_us{0};
+    uint32_t samples{0};
+  };
+  void publish_timing_(sensor::Sensor *sens, const GDOOR_TIMING &timing, TimingSnapshot &prev);
+
+  GdoorComponent *parent_{nullptr};
+  TimingSnapshot parse_prev_;
+  TimingSnapshot render_prev_;
+  TimingSnapshot dispatch_prev_;
+  TimingSnapshot tx_timing_error_prev_;
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
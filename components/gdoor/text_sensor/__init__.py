@@ -1,23 +1,49 @@
 import esphome.codegen as cg
 import esphome.config_validation as cv
 from esphome.components import text_sensor
-from esphome.const import CONF_NAME
-from .. import DOMAIN, GdoorComponent, gdoor_esphome_ns
+from esphome.const import CONF_NAME, CONF_TYPE
+from .. import CONF_SESSION_TIMEOUT, DOMAIN, GdoorComponent, gdoor_esphome_ns
 
 CODEOWNERS = ["@dtill"]
 DEPENDENCIES = [DOMAIN]
 
+CONF_COALESCE_WINDOW = "coalesce_window"
+
+# Every frame as JSON (default), or one update per call state change
+TYPE_MESSAGE = "message"
+TYPE_SESSION = "session"
+
 # Define the text sensor class for gdoor
 GDoorBusMessage = gdoor_esphome_ns.class_("GDoorBusMessage", text_sensor.TextSensor, cg.Component)
+GDoorCallSessionSensor = gdoor_esphome_ns.class_("GDoorCallSessionSensor", text_sensor.TextSensor, cg.Component)
 
-CONFIG_SCHEMA = text_sensor.text_sensor_schema(GDoorBusMessage).extend({
+BASE_SCHEMA = cv.Schema({
     cv.Required(CONF_NAME): cv.string,
     cv.Required("gdoor_id"): cv.use_id(GdoorComponent),
 }).extend(cv.COMPONENT_SCHEMA)
 
+CONFIG_SCHEMA = cv.typed_schema(
+    {
+        TYPE_MESSAGE: text_sensor.text_sensor_schema(GDoorBusMessage).extend(BASE_SCHEMA).extend({
+            cv.Optional(CONF_COALESCE_WINDOW, default="500ms"): cv.positive_time_period_milliseconds,
+        }),
+        TYPE_SESSION: text_sensor.text_sensor_schema(GDoorCallSessionSensor, icon="mdi:doorbell-video").extend(
+            BASE_SCHEMA
+        ).extend({
+            # One call table per bus, so the timeout is a gdoor: option
+            cv.Optional(CONF_SESSION_TIMEOUT): cv.invalid("session_timeout moved to the gdoor: block"),
+        }),
+    },
+    key=CONF_TYPE,
+    default_type=TYPE_MESSAGE,
+    lower=True,
+)
+
 async def to_code(config):
     parent = await cg.get_variable(config["gdoor_id"])
     var = cg.new_Pvariable(config[cv.GenerateID()])
     await cg.register_component(var, config)
     await text_sensor.register_text_sensor(var, config)
     cg.add(var.set_parent(parent))
+    if config[CONF_TYPE] == TYPE_MESSAGE:
+        cg.add(var.set_coalesce_window(config[CONF_COALESCE_WINDOW]))
@@ -9,38 +9,50 @@ static const char *TAG = "gdoor_esphome.bus_message";
 
 void GDoorBusMessage::setup() {
   ESP_LOGI(TAG, "Setting up GDoorBusMessage text_sensor");
+  this->window_timer_.set_callback([this]() { this->close_window_(); });
   if (this->parent_ != nullptr) {
-    this->parent_->setup();
+    this->parent_->register_message_listener(this);
+  } else {
+    ESP_LOGW(TAG, "Parent component is null!");
   }
   publish_state("BUS_IDLE");
 }
 
-void GDoorBusMessage::loop() {
-  const uint32_t now = millis();
-  if (this->parent_ != nullptr) {
-    uint32_t parent_timestamp = this->parent_->get_last_bus_update();
-    if (parent_timestamp != this->last_bus_update_) {
-      std::string current_message = this->parent_->get_last_rx_data_str();
-      publish_state(current_message.c_str());
-      ESP_LOGVV("GDoorBusMessage", "Published bus message: %s", current_message.c_str());
-      // Schedule BUS_IDLE state after 500ms
-      this->last_publish_time_ = now;
-      this->pending_idle_ = true;
-      this->last_bus_update_ = parent_timestamp;
-    }
-  } else {
-    ESP_LOGW("GDoorBusMessage", "Parent component is null!");
+void GDoorBusMessage::on_bus_json(const std::string &json) {
+  if (this->window_open_) {
+    // Inside a burst: keep only the latest frame, published when the window closes
+    this->pending_message_ = json;
+    this->has_pending_ = true;
+    ESP_LOGVV(TAG, "Coalesced bus message: %s", json.c_str());
+    return;
   }
-  // Handle delayed BUS_IDLE publish
-  if (this->pending_idle_ && now - this->last_publish_time_ >= 500) {
-    publish_state("BUS_IDLE");
-    ESP_LOGVV("GDoorBusMessage", "Switched to BUS_IDLE.");
-    this->pending_idle_ = false;
+  publish_state(json);
+  ESP_LOGVV(TAG, "Published bus message: %s", json.c_str());
+  this->open_window_();
+}
+
+void GDoorBusMessage::open_window_() {
+  this->window_open_ = true;
+  this->parent_->timer_wheel().schedule(&this->window_timer_, millis(), this->coalesce_window_);
+}
+
+void GDoorBusMessage::close_window_() {
+  this->window_open_ = false;
+  if (this->has_pending_) {
+    // Another frame arrived within the window: publish it instead of BUS_IDLE
+    this->has_pending_ = false;
+    publish_state(this->pending_message_);
+    ESP_LOGVV(TAG, "Published coalesced bus message: %s", this->pending_message_.c_str());
+    this->open_window_();
+    return;
   }
+  publish_state("BUS_IDLE");
+  ESP_LOGVV(TAG, "Switched to BUS_IDLE.");
 }
 
 void GDoorBusMessage::dump_config() {
   ESP_LOGCONFIG(TAG, "GDoor Bus Message text sensor");
+  ESP_LOGCONFIG(TAG, "  Coalesce window: %" PRIu32 " ms", this->coalesce_window_);
 }
 
 }  // namespace gdoor_esphome
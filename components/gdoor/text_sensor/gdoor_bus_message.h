@@ -3,23 +3,32 @@
 #include "esphome/core/component.h"
 #include "esphome/components/text_sensor/text_sensor.h"
 #include "../gdoor_component.h"
+#include "../gdoor_bus_listener.h"
 
 namespace esphome {
 namespace gdoor_esphome {
 
-class GDoorBusMessage : public text_sensor::TextSensor, public Component {
+class GDoorBusMessage : public text_sensor::TextSensor, public Component, public GDoorMessageListener {
  public:
   void setup() override;
-  void loop() override;
   void dump_config() override;
   void set_parent(GdoorComponent *parent) { this->parent_ = parent; }
+  void set_coalesce_window(uint32_t coalesce_window) { this->coalesce_window_ = coalesce_window; }
+
+  // Called by GdoorComponent::loop() for every decoded frame
+  void on_bus_json(const std::string &json) override;
 
  protected:
+  void open_window_();
+  void close_window_();
+
   GdoorComponent *parent_{nullptr};
-  uint32_t last_bus_update_{0};
-  uint32_t last_publish_time_{0};
-  bool pending_idle_ = false;
+  uint32_t coalesce_window_{500};
+  GDoorTimer window_timer_;
+  bool window_open_{false};
+  bool has_pending_{false};
+  std::string pending_message_;
 };
 
 }  // namespace gdoor_esphome
-}  // namespace esphome
\ No newline at end of file
+}  // namespace esphome
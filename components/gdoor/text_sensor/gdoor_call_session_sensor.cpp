@@ -0,0 +1,36 @@
+#include "esphome/core/log.h"
+#include "gdoor_call_session_sensor.h"
+#include <cinttypes>
+#include <cstdio>
+
+namespace esphome {
+namespace gdoor_esphome {
+
+static const char *TAG = "gdoor_esphome.call_session";
+
+static const char *json_bool(bool value) { return value ? "true" : "false"; }
+
+void GDoorCallSessionSensor::setup() {
+  if (this->parent_ == nullptr) {
+    ESP_LOGW(TAG, "Parent component is null!");
+    return;
+  }
+  this->parent_->register_session_listener(this);
+  publish_state("{\"state\": \"idle\"}");
+}
+
+void GDoorCallSessionSensor::on_session(const GDoorCallSession &session) {
+  char buf[160];
+  snprintf(buf, sizeof(buf),
+           "{\"state\": \"%s\", \"station\": \"%06" PRIX32 "\", \"answered_by\": \"%06" PRIX32
+           "\", \"video\": %s, \"door_opened\": %s, \"timed_out\": %s, \"duration\": %" PRIu32 "}",
+           GDoorCallSession::state_name(session.state), session.station, session.answered_by, json_bool(session.video),
+           json_bool(session.door_opened), json_bool(session.timed_out), session.duration_ms() / 1000);
+  publish_state(buf);
+  this->parent_->trace_publish();
+}
+
+void GDoorCallSessionSensor::dump_config() { LOG_TEXT_SENSOR("", "GDoor Call Session", this); }
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/components/text_sensor/text_sensor.h"
+#include "../gdoor_component.h"
+#include "../gdoor_bus_listener.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+/// One entity for whole calls: publishes once per call state change instead
+/// of once per frame, e.g.
+/// {"state": "connected", "station": "A286FD", "answered_by": "A1B14A",
+///  "video": true, "door_opened": false, "timed_out": false, "duration": 7}
+class GDoorCallSessionSensor : public text_sensor::TextSensor, public Component, public GDoorSessionListener {
+ public:
+  void setup() override;
+  void dump_config() override;
+  void set_parent(GdoorComponent *parent) { this->parent_ = parent; }
+
+  // Called by GdoorComponent for every call state change
+  void on_session(const GDoorCallSession &session) override;
+
+ protected:
+  GdoorComponent *parent_{nullptr};
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
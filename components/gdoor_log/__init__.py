@@ -0,0 +1,60 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+from esphome import automation
+from esphome.automation import maybe_simple_id
+from esphome.components import time as time_
+from esphome.components.esp32 import include_builtin_idf_component
+from esphome.const import CONF_ID, CONF_TIME_ID
+from esphome.components.gdoor import (
+    DOMAIN as GDOOR_DOMAIN,
+    GdoorComponent,
+    gdoor_esphome_ns,
+)
+
+CODEOWNERS = ["@dtill"]
+DEPENDENCIES = [GDOOR_DOMAIN]
+
+CONF_GDOOR_ID = "gdoor_id"
+CONF_PARTITION = "partition"
+CONF_BATCH_SIZE = "batch_size"
+CONF_FLUSH_INTERVAL = "flush_interval"
+
+GDoorFrameLogger = gdoor_esphome_ns.class_("GDoorFrameLogger", cg.Component)
+GDoorFrameLogDumpAction = gdoor_esphome_ns.class_("GDoorFrameLogDumpAction", automation.Action)
+
+CONFIG_SCHEMA = cv.Schema({
+    cv.GenerateID(): cv.declare_id(GDoorFrameLogger),
+    cv.GenerateID(CONF_GDOOR_ID): cv.use_id(GdoorComponent),
+    # Label of a data partition in the custom partition table
+    cv.Optional(CONF_PARTITION, default="gdoor_log"): cv.All(cv.string_strict, cv.Length(min=1, max=15)),
+    # Records are programmed once this many bytes are queued ...
+    cv.Optional(CONF_BATCH_SIZE, default=256): cv.int_range(min=16, max=2048),
+    # ... or once the oldest queued record is this old
+    cv.Optional(CONF_FLUSH_INTERVAL, default="60s"): cv.positive_time_period_milliseconds,
+    cv.Optional(CONF_TIME_ID): cv.use_id(time_.RealTimeClock),
+}).extend(cv.COMPONENT_SCHEMA)
+
+
+@automation.register_action(
+    "gdoor_log.dump",
+    GDoorFrameLogDumpAction,
+    maybe_simple_id({cv.GenerateID(): cv.use_id(GDoorFrameLogger)}),
+)
+async def gdoor_log_dump_to_code(config, action_id, template_arg, args):
+    var = cg.new_Pvariable(action_id, template_arg)
+    await cg.register_parented(var, config[CONF_ID])
+    return var
+
+
+async def to_code(config):
+    include_builtin_idf_component("esp_partition")
+    parent = await cg.get_variable(config[CONF_GDOOR_ID])
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    cg.add(var.set_parent(parent))
+    cg.add(var.set_partition(config[CONF_PARTITION]))
+    cg.add(var.set_batch_size(config[CONF_BATCH_SIZE]))
+    cg.add(var.set_flush_interval(config[CONF_FLUSH_INTERVAL]))
+    if CONF_TIME_ID in config:
+        clock = await cg.get_variable(config[CONF_TIME_ID])
+        cg.add(var.set_time(clock))
@@ -0,0 +1,192 @@
+#include "gdoor_frame_log.h"
+#include <algorithm>
+
+namespace esphome {
+namespace gdoor_esphome {
+
+static void put_u32(uint8_t *out, uint32_t value) {
+  out[0] = value;
+  out[1] = value >> 8;
+  out[2] = value >> 16;
+  out[3] = value >> 24;
+}
+
+static uint32_t get_u32(const uint8_t *in) {
+  return in[0] | (in[1] << 8) | (in[2] << 16) | ((uint32_t) in[3] << 24);
+}
+
+// Inverted byte sum: an all-0xFF tail of a torn write does not pass
+uint8_t GDoorFrameLog::check_(const uint8_t *record, uint16_t len) {
+  uint8_t sum = 0;
+  for (uint16_t i = 0; i < len; i++) {
+    sum += record[i];
+  }
+  return ~sum;
+}
+
+GDoorLogRecord GDoorFrameLog::decode_(const uint8_t *record) {
+  return GDoorLogRecord{get_u32(record + 2), record[1], record[0], record + RECORD_HEADER};
+}
+
+bool GDoorFrameLog::begin() {
+  if (!this->storage_->open()) {
+    return false;
+  }
+  this->sector_size_ = this->storage_->sector_size();
+  uint32_t sectors = this->sector_size_ == 0 ? 0 : this->storage_->size() / this->sector_size_;
+  // Two sectors at least, one is always erased ahead of the oldest records
+  if (sectors < 2 || sectors > UINT16_MAX) {
+    return false;
+  }
+  this->sectors_ = sectors;
+  this->buffer_.reserve(this->batch_bytes_ + RECORD_HEADER + UINT8_MAX);
+
+  bool found = false;
+  for (uint16_t sector = 0; sector < this->sectors_; sector++) {
+    uint32_t sequence;
+    if (this->read_sector_header_(sector, &sequence) && (!found || sequence > this->sequence_)) {
+      found = true;
+      this->head_sector_ = sector;
+      this->sequence_ = sequence;
+    }
+  }
+  if (!found) {
+    // Fresh partition: start the ring in sector 0
+    this->head_sector_ = this->sectors_ - 1;
+    return this->advance_sector_();
+  }
+  if (!this->scan_sector_(this->head_sector_, nullptr, &this->offset_)) {
+    return this->advance_sector_();
+  }
+  return true;
+}
+
+bool GDoorFrameLog::read_sector_header_(uint16_t sector, uint32_t *sequence) {
+  uint8_t header[SECTOR_HEADER];
+  if (!this->storage_->read((uint32_t) sector * this->sector_size_, header, sizeof(header)) ||
+      get_u32(header) != SECTOR_MAGIC) {
+    return false;
+  }
+  *sequence = get_u32(header + 4);
+  return *sequence != UINT32_MAX;
+}
+
+bool GDoorFrameLog::advance_sector_() {
+  this->head_sector_ = (this->head_sector_ + 1) % this->sectors_;
+  uint32_t base = (uint32_t) this->head_sector_ * this->sector_size_;
+  // Until the header is written the sector is ignored, a reset in between is harmless
+  this->offset_ = this->sector_size_;
+  if (!this->storage_->erase_sector(base)) {
+    this->write_errors_++;
+    return false;
+  }
+  this->erases_++;
+  this->sequence_++;
+  uint8_t header[SECTOR_HEADER];
+  put_u32(header, SECTOR_MAGIC);
+  put_u32(header + 4, this->sequence_);
+  if (!this->storage_->write(base, header, sizeof(header))) {
+    this->write_errors_++;
+    return false;
+  }
+  this->offset_ = SECTOR_HEADER;
+  return true;
+}
+
+bool GDoorFrameLog::append(uint32_t timestamp, uint8_t flags, const uint8_t *data, uint8_t len) {
+  if (len == 0 || len == UINT8_MAX) {
+    return false;
+  }
+  uint16_t total = RECORD_HEADER + len + 1;
+  if (this->offset_ + this->buffer_.size() + total > this->sector_size_) {
+    // A failed flush has moved on to a fresh sector already
+    if (this->flush() && !this->advance_sector_()) {
+      return false;
+    }
+    if (this->offset_ + total > this->sector_size_) {
+      return false;  // no fresh sector to write to
+    }
+  }
+  size_t start = this->buffer_.size();
+  this->buffer_.resize(start + total);
+  uint8_t *record = &this->buffer_[start];
+  record[0] = len;
+  record[1] = flags;
+  put_u32(record + 2, timestamp);
+  std::copy(data, data + len, record + RECORD_HEADER);
+  record[RECORD_HEADER + len] = check_(record, RECORD_HEADER + len);
+  this->records_++;
+
+  if (this->buffer_.size() >= this->batch_bytes_) {
+    return this->flush();
+  }
+  return true;
+}
+
+bool GDoorFrameLog::flush() {
+  if (this->buffer_.empty()) {
+    return true;
+  }
+  uint32_t base = (uint32_t) this->head_sector_ * this->sector_size_;
+  bool ok = this->offset_ + this->buffer_.size() <= this->sector_size_ &&
+            this->storage_->write(base + this->offset_, this->buffer_.data(), this->buffer_.size());
+  size_t len = this->buffer_.size();
+  this->buffer_.clear();
+  if (!ok) {
+    // The batch may be partly programmed, which ends the scan of this sector
+    // like a torn record: anything behind it would be invisible and, after a
+    // reset, programmed over. Continue in the next sector as begin() does.
+    this->write_errors_++;
+    this->advance_sector_();
+    return false;
+  }
+  this->offset_ += len;
+  return true;
+}
+
+bool GDoorFrameLog::scan_sector_(uint16_t sector, const RecordCallback *f, uint32_t *end) {
+  uint32_t base = (uint32_t) sector * this->sector_size_;
+  uint32_t pos = SECTOR_HEADER;
+  uint8_t record[RECORD_HEADER + UINT8_MAX + 1];
+  bool intact = true;
+  while (pos + RECORD_HEADER + 1 <= this->sector_size_) {
+    if (!this->storage_->read(base + pos, record, RECORD_HEADER)) {
+      intact = false;
+      break;
+    }
+    uint8_t len = record[0];
+    if (len == UINT8_MAX) {
+      break;  // erased, end of data
+    }
+    uint16_t total = RECORD_HEADER + len + 1;
+    if (len == 0 || pos + total > this->sector_size_ ||
+        !this->storage_->read(base + pos + RECORD_HEADER, record + RECORD_HEADER, len + 1) ||
+        check_(record, RECORD_HEADER + len) != record[RECORD_HEADER + len]) {
+      intact = false;
+      break;
+    }
+    if (f != nullptr) {
+      (*f)(decode_(record));
+    }
+    pos += total;
+  }
+  *end = pos;
+  return intact;
+}
+
+void GDoorFrameLog::for_each(const RecordCallback &f) {
+  uint32_t end;
+  for (uint16_t i = 1; i <= this->sectors_; i++) {
+    uint16_t sector = (this->head_sector_ + i) % this->sectors_;
+    uint32_t sequence;
+    if (this->read_sector_header_(sector, &sequence) && sequence <= this->sequence_) {
+      this->scan_sector_(sector, &f, &end);
+    }
+  }
+  for (size_t pos = 0; pos < this->buffer_.size(); pos += RECORD_HEADER + this->buffer_[pos] + 1) {
+    f(decode_(&this->buffer_[pos]));
+  }
+}
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
@@ -0,0 +1,91 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "gdoor_log_storage.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+/// One logged telegram. data points into a scratch buffer that is only
+/// valid during the callback.
+struct GDoorLogRecord {
+  uint32_t timestamp;  // epoch seconds, or millis() since boot if FLAG_UPTIME is set
+  uint8_t flags;
+  uint8_t len;
+  const uint8_t *data;
+};
+
+/*
+ * Frame log as a ring of flash sectors.
+ *
+ * Every sector starts with {u32 magic, u32 sequence}; the sector with the
+ * highest sequence is the one being written, the next one is the oldest.
+ * Records follow back to back and never cross a sector:
+ *
+ *   u8 len | u8 flags | u32 timestamp | data[len] | u8 check
+ *
+ * A len of 0xFF (erased flash) ends the sector. Records are collected in RAM
+ * and programmed in batches; a sector is erased only when the ring enters
+ * it, so wear is spread evenly over the partition. After a reset the ring is
+ * found again from the sector headers. A record torn by a power cut fails
+ * its check byte and ends the scan of that sector; writing resumes in the
+ * next sector instead of behind it. A failed batch write is handled the
+ * same way.
+ */
+class GDoorFrameLog {
+ public:
+  static const uint8_t FLAG_VALID = 0x01;
+  static const uint8_t FLAG_CRC_ERROR = 0x02;
+  static const uint8_t FLAG_PARITY_ERROR = 0x04;
+  static const uint8_t FLAG_UPTIME = 0x80;
+
+  typedef std::function<void(const GDoorLogRecord &)> RecordCallback;
+
+  GDoorFrameLog(GDoorLogStorage *storage, uint16_t batch_bytes) : storage_(storage), batch_bytes_(batch_bytes) {}
+
+  // Open the storage and find the write position; false if unusable
+  bool begin();
+  // Queue a record, programs the batch once it holds batch_bytes
+  bool append(uint32_t timestamp, uint8_t flags, const uint8_t *data, uint8_t len);
+  // Program all queued records now
+  bool flush();
+  // Every record, oldest first, including those not programmed yet
+  void for_each(const RecordCallback &f);
+
+  size_t pending() const { return this->buffer_.size(); }
+  uint16_t sectors() const { return this->sectors_; }
+  uint32_t capacity() const { return (uint32_t) this->sectors_ * this->sector_size_; }
+  uint32_t records_written() const { return this->records_; }
+  uint32_t sector_erases() const { return this->erases_; }
+  uint32_t write_errors() const { return this->write_errors_; }
+  uint32_t sequence() const { return this->sequence_; }
+
+ protected:
+  static const uint32_t SECTOR_MAGIC = 0x314C4447;  // "GDL1"
+  static const uint8_t SECTOR_HEADER = 8;
+  static const uint8_t RECORD_HEADER = 6;
+
+  static uint8_t check_(const uint8_t *record, uint16_t len);
+  static GDoorLogRecord decode_(const uint8_t *record);
+  bool read_sector_header_(uint16_t sector, uint32_t *sequence);
+  bool advance_sector_();
+  // Calls f for every intact record of a sector; *end is the offset behind the
+  // last one. Returns false if the scan stopped at a damaged record.
+  bool scan_sector_(uint16_t sector, const RecordCallback *f, uint32_t *end);
+
+  GDoorLogStorage *storage_;
+  uint16_t batch_bytes_;
+  uint32_t sector_size_{0};
+  uint16_t sectors_{0};
+  uint16_t head_sector_{0};  // sector being written
+  uint32_t offset_{0};       // programmed bytes in the head sector
+  uint32_t sequence_{0};     // sequence of the head sector
+  std::vector<uint8_t> buffer_;
+  uint32_t records_{0};
+  uint32_t erases_{0};
+  uint32_t write_errors_{0};
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
@@ -0,0 +1,99 @@
+#include "gdoor_frame_logger.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/helpers.h"
+#include "esphome/core/time.h"
+#include "esphome/components/gdoor/gdoor_frame_table.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+static const char *TAG = "gdoor_log";
+
+void GDoorFrameLogger::setup() {
+  this->storage_ = new GDoorLogPartitionStorage(this->partition_);  // NOLINT
+  this->log_ = new GDoorFrameLog(this->storage_, this->batch_size_);  // NOLINT
+  if (!this->log_->begin()) {
+    ESP_LOGE(TAG, "Data partition '%s' not found or too small (2 sectors at least)", this->partition_);
+    this->mark_failed();
+    return;
+  }
+  this->parent_->register_frame_listener(this);
+}
+
+void GDoorFrameLogger::on_frame(const GDOOR_DATA &frame) {
+  if (frame.len == 0) {
+    return;
+  }
+  uint8_t flags = 0;
+  if (frame.valid) {
+    flags |= GDoorFrameLog::FLAG_VALID;
+  }
+  if (frame.crc_error) {
+    flags |= GDoorFrameLog::FLAG_CRC_ERROR;
+  }
+  if (frame.parity_errors) {
+    flags |= GDoorFrameLog::FLAG_PARITY_ERROR;
+  }
+#ifdef USE_TIME
+  if (this->time_ != nullptr) {
+    ESPTime now = this->time_->now();
+    if (now.is_valid()) {
+      this->log_->append((uint32_t) now.timestamp, flags, frame.data, frame.len);
+      return;
+    }
+  }
+#endif
+  // Uptime of the frame end, not of its dispatch
+  this->log_->append((uint32_t) (frame.end_us / 1000), flags | GDoorFrameLog::FLAG_UPTIME, frame.data, frame.len);
+}
+
+void GDoorFrameLogger::loop() {
+  uint32_t now = millis();
+  if (this->log_->pending() == 0) {
+    this->last_flush_ = now;
+  } else if (now - this->last_flush_ >= this->flush_interval_) {
+    this->log_->flush();
+    this->last_flush_ = now;
+  }
+}
+
+void GDoorFrameLogger::on_shutdown() {
+  if (this->log_ != nullptr) {
+    this->log_->flush();
+  }
+}
+
+void GDoorFrameLogger::dump() {
+  uint32_t count = 0;
+  ESP_LOGI(TAG, "Frame log, oldest first:");
+  this->log_->for_each([&count](const GDoorLogRecord &record) {
+    const char *state = (record.flags & GDoorFrameLog::FLAG_VALID) ? "valid"
+                        : (record.flags & GDoorFrameLog::FLAG_CRC_ERROR) ? "crc error"
+                        : (record.flags & GDoorFrameLog::FLAG_PARITY_ERROR) ? "parity error"
+                                                                              : "invalid";
+    std::string when;
+    if (record.flags & GDoorFrameLog::FLAG_UPTIME) {
+      when = str_sprintf("uptime %" PRIu32 "ms", record.timestamp);
+    } else {
+      when = ESPTime::from_epoch_local(record.timestamp).strftime("%Y-%m-%d %H:%M:%S");
+    }
+    ESP_LOGI(TAG, "  %s %s %s", when.c_str(), GDoorFrameTable::to_hex(record.data, record.len).c_str(), state);
+    count++;
+  });
+  ESP_LOGI(TAG, "%" PRIu32 " records", count);
+}
+
+void GDoorFrameLogger::dump_config() {
+  ESP_LOGCONFIG(TAG, "GDoor Frame Log:");
+  ESP_LOGCONFIG(TAG, "  Partition: %s", this->partition_);
+  if (this->is_failed()) {
+    return;
+  }
+  ESP_LOGCONFIG(TAG, "  Size: %" PRIu32 " bytes in %u sectors", this->log_->capacity(), this->log_->sectors());
+  ESP_LOGCONFIG(TAG, "  Batch: %u bytes / %" PRIu32 "ms", this->batch_size_, this->flush_interval_);
+  ESP_LOGCONFIG(TAG, "  Sequence: %" PRIu32, this->log_->sequence());
+}
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
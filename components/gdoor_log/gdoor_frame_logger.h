@@ -0,0 +1,66 @@
+#pragma once
+
+#include "esphome/core/automation.h"
+#include "esphome/core/component.h"
+#include "esphome/core/defines.h"
+#include "esphome/components/gdoor/gdoor_component.h"
+#include "esphome/components/gdoor/gdoor_bus_listener.h"
+#include "gdoor_frame_log.h"
+#include "gdoor_log_storage.h"
+
+#ifdef USE_TIME
+#include "esphome/components/time/real_time_clock.h"
+#endif
+
+namespace esphome {
+namespace gdoor_esphome {
+
+/// Keeps every decoded telegram in the frame log partition, so bus traffic
+/// can be reviewed after the fact.
+class GDoorFrameLogger : public Component, public GDoorFrameListener {
+ public:
+  void set_parent(GdoorComponent *parent) { this->parent_ = parent; }
+  void set_partition(const char *label) { this->partition_ = label; }
+  void set_batch_size(uint16_t batch_size) { this->batch_size_ = batch_size; }
+  void set_flush_interval(uint32_t flush_interval) { this->flush_interval_ = flush_interval; }
+#ifdef USE_TIME
+  // Log wall clock time instead of uptime once the clock is valid
+  void set_time(time::RealTimeClock *time) { this->time_ = time; }
+#endif
+
+  float get_setup_priority() const override { return setup_priority::DATA; }
+  void setup() override;
+  void loop() override;
+  void dump_config() override;
+  void on_shutdown() override;
+
+  // Called by GdoorComponent::loop() for every decoded frame
+  void on_frame(const GDOOR_DATA &frame) override;
+
+  // Write every record to the log, oldest first
+  void dump();
+  // Every record, oldest first; for other consumers of the log
+  void for_each(const GDoorFrameLog::RecordCallback &f) { this->log_->for_each(f); }
+  bool flush() { return this->log_->flush(); }
+
+ protected:
+  GdoorComponent *parent_{nullptr};
+  const char *partition_{"gdoor_log"};
+  uint16_t batch_size_{256};
+  uint32_t flush_interval_{60000};
+#ifdef USE_TIME
+  time::RealTimeClock *time_{nullptr};
+#endif
+
+  GDoorLogPartitionStorage *storage_{nullptr};
+  GDoorFrameLog *log_{nullptr};
+  uint32_t last_flush_{0};
+};
+
+template<typename... Ts> class GDoorFrameLogDumpAction : public Action<Ts...>, public Parented<GDoorFrameLogger> {
+ public:
+  void play(Ts... x) override { this->parent_->dump(); }
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
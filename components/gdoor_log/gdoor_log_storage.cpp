@@ -0,0 +1,116 @@
+#include "gdoor_log_storage.h"
+#include <cstdio>
+#include <cstring>
+#include "esphome/core/defines.h"
+
+#ifdef USE_ESP32
+#include "esp_partition.h"
+#endif
+
+namespace esphome {
+namespace gdoor_esphome {
+
+// --- Flash partition ------------------------------------------------------
+
+#ifdef USE_ESP32
+#define GDOOR_LOG_PARTITION ((const esp_partition_t *) this->partition_)
+
+bool GDoorLogPartitionStorage::open() {
+  this->partition_ = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, this->label_);
+  return this->partition_ != nullptr;
+}
+
+uint32_t GDoorLogPartitionStorage::size() const { return GDOOR_LOG_PARTITION->size; }
+
+uint32_t GDoorLogPartitionStorage::sector_size() const { return GDOOR_LOG_PARTITION->erase_size; }
+
+bool GDoorLogPartitionStorage::read(uint32_t offset, void *buf, size_t len) {
+  return esp_partition_read(GDOOR_LOG_PARTITION, offset, buf, len) == ESP_OK;
+}
+
+bool GDoorLogPartitionStorage::write(uint32_t offset, const void *buf, size_t len) {
+  return esp_partition_write(GDOOR_LOG_PARTITION, offset, buf, len) == ESP_OK;
+}
+
+bool GDoorLogPartitionStorage::erase_sector(uint32_t offset) {
+  return esp_partition_erase_range(GDOOR_LOG_PARTITION, offset, GDOOR_LOG_PARTITION->erase_size) == ESP_OK;
+}
+#else
+bool GDoorLogPartitionStorage::open() { return false; }
+uint32_t GDoorLogPartitionStorage::size() const { return 0; }
+uint32_t GDoorLogPartitionStorage::sector_size() const { return 0; }
+bool GDoorLogPartitionStorage::read(uint32_t offset, void *buf, size_t len) { return false; }
+bool GDoorLogPartitionStorage::write(uint32_t offset, const void *buf, size_t len) { return false; }
+bool GDoorLogPartitionStorage::erase_sector(uint32_t offset) { return false; }
+#endif
+
+// --- Image file -----------------------------------------------------------
+
+#define GDOOR_LOG_FILE ((FILE *) this->file_)
+
+GDoorLogFileStorage::~GDoorLogFileStorage() {
+  if (this->file_ != nullptr) {
+    fclose(GDOOR_LOG_FILE);
+  }
+}
+
+bool GDoorLogFileStorage::open() {
+  this->file_ = fopen(this->path_.c_str(), "r+b");
+  if (this->file_ == nullptr) {
+    this->file_ = fopen(this->path_.c_str(), "w+b");
+  }
+  if (this->file_ == nullptr || this->sector_size_ == 0 || fseek(GDOOR_LOG_FILE, 0, SEEK_END) != 0) {
+    return false;
+  }
+  long have = ftell(GDOOR_LOG_FILE);
+  for (long pos = have < 0 ? 0 : have; pos < (long) this->size_; pos++) {
+    fputc(0xFF, GDOOR_LOG_FILE);
+  }
+  return fflush(GDOOR_LOG_FILE) == 0;
+}
+
+bool GDoorLogFileStorage::read(uint32_t offset, void *buf, size_t len) {
+  if (offset + len > this->size_ || fseek(GDOOR_LOG_FILE, offset, SEEK_SET) != 0) {
+    return false;
+  }
+  return fread(buf, 1, len, GDOOR_LOG_FILE) == len;
+}
+
+bool GDoorLogFileStorage::write(uint32_t offset, const void *buf, size_t len) {
+  uint8_t chunk[256];
+  const uint8_t *src = (const uint8_t *) buf;
+  for (size_t done = 0; done < len;) {
+    size_t n = len - done < sizeof(chunk) ? len - done : sizeof(chunk);
+    if (!this->read(offset + done, chunk, n)) {
+      return false;
+    }
+    for (size_t i = 0; i < n; i++) {
+      chunk[i] &= src[done + i];  // programming only clears bits
+    }
+    if (fseek(GDOOR_LOG_FILE, offset + done, SEEK_SET) != 0 || fwrite(chunk, 1, n, GDOOR_LOG_FILE) != n) {
+      return false;
+    }
+    done += n;
+  }
+  return fflush(GDOOR_LOG_FILE) == 0;
+}
+
+bool GDoorLogFileStorage::erase_sector(uint32_t offset) {
+  uint8_t erased[256];
+  memset(erased, 0xFF, sizeof(erased));
+  offset -= offset % this->sector_size_;
+  if (offset + this->sector_size_ > this->size_ || fseek(GDOOR_LOG_FILE, offset, SEEK_SET) != 0) {
+    return false;
+  }
+  for (uint32_t done = 0; done < this->sector_size_;) {
+    size_t n = this->sector_size_ - done < sizeof(erased) ? this->sector_size_ - done : sizeof(erased);
+    if (fwrite(erased, 1, n, GDOOR_LOG_FILE) != n) {
+      return false;
+    }
+    done += n;
+  }
+  return fflush(GDOOR_LOG_FILE) == 0;
+}
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
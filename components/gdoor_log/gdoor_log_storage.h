@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace esphome {
+namespace gdoor_esphome {
+
+/// Raw NOR-flash-like storage under GDoorFrameLog: erased bytes read 0xFF,
+/// writes may only clear bits, erase works on whole sectors.
+class GDoorLogStorage {
+ public:
+  virtual ~GDoorLogStorage() = default;
+  virtual bool open() = 0;
+  virtual uint32_t size() const = 0;
+  virtual uint32_t sector_size() const = 0;
+  virtual bool read(uint32_t offset, void *buf, size_t len) = 0;
+  virtual bool write(uint32_t offset, const void *buf, size_t len) = 0;
+  virtual bool erase_sector(uint32_t offset) = 0;
+};
+
+/// Data partition found by its label in the partition table (ESP32).
+class GDoorLogPartitionStorage : public GDoorLogStorage {
+ public:
+  explicit GDoorLogPartitionStorage(const char *label) : label_(label) {}
+  bool open() override;
+  uint32_t size() const override;
+  uint32_t sector_size() const override;
+  bool read(uint32_t offset, void *buf, size_t len) override;
+  bool write(uint32_t offset, const void *buf, size_t len) override;
+  bool erase_sector(uint32_t offset) override;
+
+ protected:
+  const char *label_;
+  const void *partition_{nullptr};  // esp_partition_t, kept opaque for host builds
+};
+
+/// Image file on a regular file system, for running the log on Linux.
+/// Writes AND into the existing bytes like flash does, so record, rotate and
+/// recovery behave as on the device; a missing or short file is padded with 0xFF.
+class GDoorLogFileStorage : public GDoorLogStorage {
+ public:
+  GDoorLogFileStorage(std::string path, uint32_t size, uint32_t sector_size = 4096)
+      : path_(std::move(path)), size_(size), sector_size_(sector_size) {}
+  ~GDoorLogFileStorage() override;
+  bool open() override;
+  uint32_t size() const override { return this->size_; }
+  uint32_t sector_size() const override { return this->sector_size_; }
+  bool read(uint32_t offset, void *buf, size_t len) override;
+  bool write(uint32_t offset, const void *buf, size_t len) override;
+  bool erase_sector(uint32_t offset) override;
+
+ protected:
+  std::string path_;
+  uint32_t size_;
+  uint32_t sector_size_;
+  void *file_{nullptr};  // FILE *
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
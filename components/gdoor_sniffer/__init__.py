@@ -0,0 +1,121 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+import esphome.final_validate as fv
+from esphome.components import uart
+from esphome.components.esp32 import (
+    VARIANT_ESP32C3,
+    VARIANT_ESP32C6,
+    VARIANT_ESP32H2,
+    VARIANT_ESP32S3,
+    get_esp32_variant,
+)
+from esphome.const import CONF_BAUD_RATE, CONF_ID, CONF_PORT, CONF_UART_ID
+from esphome.components.gdoor import (
+    DOMAIN as GDOOR_DOMAIN,
+    CONF_MAX_WORDS,
+    CONF_RAW_CAPTURE,
+    GdoorComponent,
+    gdoor_esphome_ns,
+)
+
+CODEOWNERS = ["@dtill"]
+DEPENDENCIES = [GDOOR_DOMAIN]
+
+CONF_GDOOR_ID = "gdoor_id"
+CONF_BUFFER_SIZE = "buffer_size"
+CONF_STATUS_INTERVAL = "status_interval"
+CONF_HARDWARE_UART = "hardware_uart"
+
+# Header, TRAIN fields, start bit count and sum around the 9 counts and one
+# data byte per word
+TRAIN_RECORD_FIXED = 32
+TRAIN_RECORD_PER_WORD = 10
+
+# Slowest UART that keeps up with back-to-back full-length trains
+MIN_BAUD_RATE = 115200
+USB_SERIAL_JTAG_VARIANTS = [VARIANT_ESP32C3, VARIANT_ESP32C6, VARIANT_ESP32H2, VARIANT_ESP32S3]
+
+GDoorSniffer = gdoor_esphome_ns.class_("GDoorSniffer", cg.Component)
+Port = GDoorSniffer.enum("Port")
+PORTS = {
+    "uart": Port.PORT_UART,
+    "usb_serial_jtag": Port.PORT_USB_SERIAL_JTAG,
+}
+
+
+def validate_port(config):
+    if config[CONF_PORT] == "uart" and CONF_UART_ID not in config:
+        raise cv.Invalid(f"'{CONF_UART_ID}' is required for port uart")
+    if config[CONF_PORT] == "usb_serial_jtag":
+        if CONF_UART_ID in config:
+            raise cv.Invalid(f"'{CONF_UART_ID}' only applies to port uart")
+        if get_esp32_variant() not in USB_SERIAL_JTAG_VARIANTS:
+            raise cv.Invalid(
+                f"port usb_serial_jtag needs one of {', '.join(USB_SERIAL_JTAG_VARIANTS)}"
+            )
+    return config
+
+
+CONFIG_SCHEMA = cv.All(
+    cv.Schema({
+        cv.GenerateID(): cv.declare_id(GDoorSniffer),
+        cv.GenerateID(CONF_GDOOR_ID): cv.use_id(GdoorComponent),
+        cv.Optional(CONF_PORT, default="uart"): cv.enum(PORTS, lower=True),
+        cv.Optional(CONF_UART_ID): cv.use_id(uart.UARTComponent),
+        # Size of each half of the double buffer; fits several full trains
+        cv.Optional(CONF_BUFFER_SIZE, default=2048): cv.int_range(min=512, max=16384),
+        cv.Optional(CONF_STATUS_INTERVAL, default="1s"): cv.positive_time_period_milliseconds,
+    }).extend(cv.COMPONENT_SCHEMA),
+    validate_port,
+)
+
+
+def validate_sniffer(config):
+    """Counts need raw_capture, a buffer half must hold a full-length train,
+    the port has to be fast and not shared with the logger."""
+    full_config = fv.full_config.get()
+    bus_path = full_config.get_path_for_id(config[CONF_GDOOR_ID])[:-1]
+    bus = full_config.get_config_for_path(bus_path)
+    if not bus[CONF_RAW_CAPTURE]:
+        raise cv.Invalid(f"gdoor_sniffer needs '{CONF_RAW_CAPTURE}: true' on the gdoor bus")
+    record_len = TRAIN_RECORD_FIXED + TRAIN_RECORD_PER_WORD * bus[CONF_MAX_WORDS]
+    if config[CONF_BUFFER_SIZE] < record_len:
+        raise cv.Invalid(
+            f"'{CONF_BUFFER_SIZE}' must be at least {record_len} to hold a train "
+            f"of {CONF_MAX_WORDS} {bus[CONF_MAX_WORDS]}"
+        )
+    if CONF_UART_ID in config:
+        uart_path = full_config.get_path_for_id(config[CONF_UART_ID])[:-1]
+        uart_config = full_config.get_config_for_path(uart_path)
+        if uart_config[CONF_BAUD_RATE] < MIN_BAUD_RATE:
+            raise cv.Invalid(f"gdoor_sniffer needs a UART baud rate of at least {MIN_BAUD_RATE}")
+    logger = full_config.get("logger", {})
+    if (
+        config[CONF_PORT] == "usb_serial_jtag"
+        and logger.get(CONF_BAUD_RATE, 115200) != 0
+        and str(logger.get(CONF_HARDWARE_UART, "")).upper() == "USB_SERIAL_JTAG"
+    ):
+        raise cv.Invalid(
+            "The logger writes to USB_SERIAL_JTAG too; move it to another "
+            f"'{CONF_HARDWARE_UART}' or set its '{CONF_BAUD_RATE}: 0'"
+        )
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = validate_sniffer
+
+
+async def to_code(config):
+    parent = await cg.get_variable(config[CONF_GDOOR_ID])
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    cg.add(var.set_parent(parent))
+    cg.add(var.set_port(config[CONF_PORT]))
+    if CONF_UART_ID in config:
+        cg.add_define("USE_GDOOR_SNIFFER_UART")
+        bus = await cg.get_variable(config[CONF_UART_ID])
+        cg.add(var.set_uart(bus))
+    if config[CONF_PORT] == "usb_serial_jtag":
+        cg.add_define("USE_GDOOR_SNIFFER_USB_SERIAL_JTAG")
+    cg.add(var.set_buffer_size(config[CONF_BUFFER_SIZE]))
+    cg.add(var.set_status_interval(config[CONF_STATUS_INTERVAL]))
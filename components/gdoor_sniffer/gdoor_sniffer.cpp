@@ -0,0 +1,227 @@
+#include "gdoor_sniffer.h"
+#include <algorithm>
+#include <cstring>
+#include "esp_heap_caps.h"
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+#ifdef USE_GDOOR_SNIFFER_USB_SERIAL_JTAG
+#include "driver/usb_serial_jtag.h"
+#endif
+
+namespace esphome {
+namespace gdoor_esphome {
+
+static const char *TAG = "gdoor_sniffer";
+
+static const uint16_t TRAIN_FIXED_LEN = 16;  // TRAIN payload before the counts
+static const uint16_t STATUS_LEN = 16;
+// Hardware TX FIFO of the ESP32 UARTs. Writes that fit into what it has
+// drained return at once, whether or not the driver has a TX ring buffer.
+static const size_t UART_TX_FIFO = 128;
+
+static uint8_t *put_u16(uint8_t *out, uint16_t value) {
+  *out++ = (uint8_t) (value >> 8);
+  *out++ = (uint8_t) value;
+  return out;
+}
+
+static uint8_t *put_u32(uint8_t *out, uint32_t value) {
+  *out++ = (uint8_t) (value >> 24);
+  *out++ = (uint8_t) (value >> 16);
+  *out++ = (uint8_t) (value >> 8);
+  *out++ = (uint8_t) value;
+  return out;
+}
+
+void GDoorSniffer::setup() {
+  // DMA-capable internal RAM, so the port driver can take the halves as they are
+  for (auto &buffer : this->buffers_) {
+    buffer = (uint8_t *) heap_caps_malloc(this->buffer_size_, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+    if (buffer == nullptr) {
+      ESP_LOGE(TAG, "Could not allocate 2 x %u bytes of DMA-capable RAM", this->buffer_size_);
+      this->mark_failed();
+      return;
+    }
+  }
+#ifdef USE_GDOOR_SNIFFER_USB_SERIAL_JTAG
+  if (this->port_ == PORT_USB_SERIAL_JTAG) {
+    usb_serial_jtag_driver_config_t config = {};
+    config.tx_buffer_size = this->buffer_size_;
+    config.rx_buffer_size = 64;  // nothing is read, the driver needs one anyway
+    if (usb_serial_jtag_driver_install(&config) != ESP_OK) {
+      ESP_LOGE(TAG, "Could not install the USB Serial/JTAG driver");
+      this->mark_failed();
+      return;
+    }
+  }
+#endif
+  this->parent_->register_train_listener(this);
+}
+
+uint8_t *GDoorSniffer::begin_record_(uint8_t type, uint8_t flags, uint32_t timestamp, uint16_t payload_len) {
+  uint32_t seq = this->seq_++;
+  size_t record_len = SNIFF_HEADER_LEN + payload_len + 1;
+  if (this->fill_len_ + record_len > this->buffer_size_) {
+    this->dropped_records_++;
+    return nullptr;
+  }
+  uint8_t *record = this->buffers_[this->fill_index_] + this->fill_len_;
+  uint8_t *out = record;
+  *out++ = SNIFF_SYNC[0];
+  *out++ = SNIFF_SYNC[1];
+  out = put_u16(out, record_len - 4);
+  *out++ = type;
+  *out++ = flags;
+  out = put_u32(out, seq);
+  put_u32(out, timestamp);
+  return record;
+}
+
+void GDoorSniffer::end_record_(uint8_t *record, uint16_t payload_len) {
+  // Sum over len through payload, the sync word is left out
+  uint16_t summed = SNIFF_HEADER_LEN - 2 + payload_len;
+  record[2 + summed] = GDOOR_UTILS::crc(record + 2, summed);
+  this->fill_len_ += SNIFF_HEADER_LEN + payload_len + 1;
+  this->records_++;
+}
+
+void GDoorSniffer::on_train(const GDOOR_DATA &train, bool parsed) {
+#ifdef USE_GDOOR_RAW_CAPTURE
+  uint16_t count_len = train.raw_len;
+  const uint8_t *counts = train.raw;
+#else
+  uint16_t count_len = 0;  // rejected by the codegen, kept buildable
+  const uint8_t *counts = nullptr;
+#endif
+  uint16_t data_len = parsed ? train.len : 0;
+  uint16_t payload_len = TRAIN_FIXED_LEN + count_len + data_len;
+  uint8_t flags = 0;
+  if (parsed) {
+    flags |= SNIFF_FLAG_PARSED;
+  }
+  if (train.valid) {
+    flags |= SNIFF_FLAG_VALID;
+  }
+  if (train.crc_error) {
+    flags |= SNIFF_FLAG_CRC_ERROR;
+  }
+  if (train.parity_errors) {
+    flags |= SNIFF_FLAG_PARITY_ERROR;
+  }
+  uint8_t *record = this->begin_record_(SNIFF_RECORD_TRAIN, flags, (uint32_t) train.end_us, payload_len);
+  if (record == nullptr) {
+    return;
+  }
+  // The RX engine counted this train just before calling out
+  uint8_t *out = record + SNIFF_HEADER_LEN;
+  out = put_u32(out, (uint32_t) train.start_us);
+  out = put_u32(out, this->parent_->rx_stats().trains);
+  *out++ = train.margin;
+  *out++ = train.parity_errors;
+  out = put_u16(out, train.filtered_pulses);
+  out = put_u16(out, train.startbits_rejected);
+  out = put_u16(out, count_len);
+  if (count_len > 0) {
+    memcpy(out, counts, count_len);
+    out += count_len;
+  }
+  if (data_len > 0) {
+    memcpy(out, train.data, data_len);
+  }
+  this->end_record_(record, payload_len);
+}
+
+void GDoorSniffer::put_status_() {
+  uint8_t *record = this->begin_record_(SNIFF_RECORD_STATUS, 0, micros(), STATUS_LEN);
+  if (record == nullptr) {
+    return;
+  }
+  const GDOOR_RX_STATS &stats = this->parent_->rx_stats();
+  uint8_t *out = record + SNIFF_HEADER_LEN;
+  out = put_u32(out, stats.trains);
+  out = put_u32(out, stats.frames);
+  out = put_u32(out, stats.overruns);
+  put_u32(out, this->dropped_records_);
+  this->end_record_(record, STATUS_LEN);
+}
+
+size_t GDoorSniffer::write_(const uint8_t *data, size_t len) {
+#ifdef USE_GDOOR_SNIFFER_USB_SERIAL_JTAG
+  if (this->port_ == PORT_USB_SERIAL_JTAG) {
+    // Never blocks; without a host on the port the driver buffer stays full
+    int written = usb_serial_jtag_write_bytes(data, len, 0);
+    return written > 0 ? (size_t) written : 0;
+  }
+#endif
+#ifdef USE_GDOOR_SNIFFER_UART
+  if (this->uart_ != nullptr) {
+    // write_array() waits until the FIFO has taken everything, so only hand
+    // over what went out on the wire since the last write (10 bits per byte)
+    uint32_t now = micros();
+    uint64_t drained = (uint64_t) (now - this->uart_checked_us_) * this->uart_->get_baud_rate() / 10000000;
+    if (drained > 0) {
+      this->uart_free_ = std::min<uint64_t>(UART_TX_FIFO, this->uart_free_ + drained);
+      this->uart_checked_us_ = now;
+    }
+    size_t n = std::min(len, this->uart_free_);
+    if (n > 0) {
+      this->uart_->write_array(data, n);
+      this->uart_free_ -= n;
+    }
+    return n;
+  }
+#endif
+  return len;
+}
+
+/*
+ * The out half is written as far as the port takes it. Once it is empty the
+ * halves swap, so records keep going into one half while the other drains;
+ * only when both are full are new records dropped (and counted).
+ */
+void GDoorSniffer::drain_() {
+  if (this->out_pos_ < this->out_len_) {
+    const uint8_t *out = this->buffers_[this->fill_index_ ^ 1];
+    this->out_pos_ += this->write_(out + this->out_pos_, this->out_len_ - this->out_pos_);
+    if (this->out_pos_ < this->out_len_) {
+      return;
+    }
+  }
+  if (this->fill_len_ == 0) {
+    return;
+  }
+  this->out_len_ = this->fill_len_;
+  this->out_pos_ = 0;
+  this->fill_index_ ^= 1;
+  this->fill_len_ = 0;
+  const uint8_t *out = this->buffers_[this->fill_index_ ^ 1];
+  this->out_pos_ += this->write_(out, this->out_len_);
+}
+
+void GDoorSniffer::loop() {
+  this->drain_();
+  // A half in flight goes out a FIFO at a time, so keep the loop coming
+  if (this->out_pos_ < this->out_len_ || this->fill_len_ > 0) {
+    this->high_freq_.start();
+  } else {
+    this->high_freq_.stop();
+  }
+  // After the drain, so a full buffer does not cost the status record
+  uint32_t now = millis();
+  if (now - this->last_status_ >= this->status_interval_) {
+    this->last_status_ = now;
+    this->put_status_();
+  }
+}
+
+void GDoorSniffer::dump_config() {
+  ESP_LOGCONFIG(TAG, "GDoor Sniffer:");
+  ESP_LOGCONFIG(TAG, "  Port: %s", this->port_ == PORT_UART ? "UART" : "USB Serial/JTAG");
+  ESP_LOGCONFIG(TAG, "  Buffer: 2 x %u bytes", this->buffer_size_);
+  ESP_LOGCONFIG(TAG, "  Status interval: %" PRIu32 "ms", this->status_interval_);
+  ESP_LOGCONFIG(TAG, "  Records: %" PRIu32 ", dropped %" PRIu32, this->records_, this->dropped_records_);
+}
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
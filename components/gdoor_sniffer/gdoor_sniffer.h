@@ -0,0 +1,116 @@
+#pragma once
+
+#include "esphome/core/component.h"
+#include "esphome/core/defines.h"
+#include "esphome/core/helpers.h"
+#include "esphome/components/gdoor/gdoor_component.h"
+#include "esphome/components/gdoor/gdoor_bus_listener.h"
+
+#ifdef USE_GDOOR_SNIFFER_UART
+#include "esphome/components/uart/uart.h"
+#endif
+
+namespace esphome {
+namespace gdoor_esphome {
+
+/*
+ * Wire format, all integers big-endian. Every record is
+ *
+ *   0xA5 0x5A | u16 len | u8 type | u8 flags | u32 seq | u32 timestamp_us | payload | u8 sum
+ *
+ * where len counts everything after the length field (11 + payload), seq
+ * counts every record since boot (dropped ones included, so a jump is a
+ * gap), timestamp is micros() and sum is GDOOR_UTILS::crc() over len
+ * through payload. The sync word lets a reader pick up mid-stream.
+ *
+ *   TRAIN   timestamp = bus time of the last edge; payload = u32 bus time of
+ *           the first edge, u32 train number (RX trains counter), u8 margin,
+ *           u8 parity errors, u16 filtered pulses, u16 rejected start bits,
+ *           u16 count len, counts[count len], then the decoded bytes incl.
+ *           CRC (none if nothing decoded); flags = SNIFF_FLAG_*
+ *   STATUS  periodic; payload = u32 trains, u32 frames, u32 overruns,
+ *           u32 dropped records (RX stats and sniffer totals since boot)
+ */
+enum GDoorSniffRecord : uint8_t {
+  SNIFF_RECORD_TRAIN = 0x01,
+  SNIFF_RECORD_STATUS = 0x02,
+};
+
+enum GDoorSniffFlag : uint8_t {
+  SNIFF_FLAG_PARSED = 0x01,  // decoded to at least one word
+  SNIFF_FLAG_VALID = 0x02,
+  SNIFF_FLAG_CRC_ERROR = 0x04,
+  SNIFF_FLAG_PARITY_ERROR = 0x08,
+};
+
+static const uint8_t SNIFF_SYNC[2] = {0xA5, 0x5A};
+static const uint8_t SNIFF_HEADER_LEN = 14;  // sync + len + type + flags + seq + timestamp
+
+/// Writes every pulse train of the bus, including the ones that do not
+/// decode, as binary records to a UART or the USB Serial/JTAG (CDC) port.
+/// Records are built in place in one half of a DMA-capable double buffer
+/// while the other half drains. Recording costs a memcpy per train and never
+/// formats text; draining never blocks loop(): the port only gets what it can
+/// take right away, the loop runs at high frequency until the half is out.
+class GDoorSniffer : public Component, public GDoorTrainListener {
+ public:
+  enum Port : uint8_t { PORT_UART, PORT_USB_SERIAL_JTAG };
+
+  void set_parent(GdoorComponent *parent) { this->parent_ = parent; }
+  void set_port(Port port) { this->port_ = port; }
+#ifdef USE_GDOOR_SNIFFER_UART
+  void set_uart(uart::UARTComponent *uart) { this->uart_ = uart; }
+#endif
+  void set_buffer_size(uint16_t buffer_size) { this->buffer_size_ = buffer_size; }
+  void set_status_interval(uint32_t status_interval) { this->status_interval_ = status_interval; }
+
+  float get_setup_priority() const override { return setup_priority::DATA; }
+  void setup() override;
+  void loop() override;
+  void dump_config() override;
+
+  // Called from the RX engine for every pulse train that reached frame end
+  void on_train(const GDOOR_DATA &train, bool parsed) override;
+
+  uint32_t get_dropped_records() const { return this->dropped_records_; }
+
+ protected:
+  // Reserve a record of payload_len bytes in the fill buffer and write its
+  // header; nullptr (and counted as dropped) if the buffer is full
+  uint8_t *begin_record_(uint8_t type, uint8_t flags, uint32_t timestamp, uint16_t payload_len);
+  // Append the sum over the record begun at record
+  void end_record_(uint8_t *record, uint16_t payload_len);
+  void put_status_();
+  // Hand as much of the drain buffer to the port as it takes, then swap
+  void drain_();
+  // Bytes the port accepted; never waits for the wire
+  size_t write_(const uint8_t *data, size_t len);
+
+  GdoorComponent *parent_{nullptr};
+  Port port_{PORT_UART};
+#ifdef USE_GDOOR_SNIFFER_UART
+  uart::UARTComponent *uart_{nullptr};
+  // TX FIFO bytes free as of uart_checked_us_; the line drains baud / 10
+  // bytes per second, write_() hands over no more than that
+  size_t uart_free_{0};
+  uint32_t uart_checked_us_{0};
+#endif
+  HighFrequencyLoopRequester high_freq_;
+  uint16_t buffer_size_{2048};
+  uint32_t status_interval_{1000};
+
+  // Double buffer: records go to fill, the port drains out
+  uint8_t *buffers_[2]{nullptr, nullptr};
+  uint8_t fill_index_{0};
+  size_t fill_len_{0};
+  size_t out_len_{0};
+  size_t out_pos_{0};
+
+  uint32_t seq_{0};
+  uint32_t records_{0};
+  uint32_t dropped_records_{0};
+  uint32_t last_status_{0};
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
@@ -0,0 +1,90 @@
+import esphome.codegen as cg
+import esphome.config_validation as cv
+import esphome.final_validate as fv
+from esphome.const import CONF_ID, CONF_PORT, CONF_PROTOCOL
+from esphome.components.gdoor import (
+    DOMAIN as GDOOR_DOMAIN,
+    CONF_RAW_CAPTURE,
+    GdoorComponent,
+    gdoor_esphome_ns,
+)
+
+CODEOWNERS = ["@dtill"]
+DEPENDENCIES = [GDOOR_DOMAIN, "network"]
+AUTO_LOAD = ["socket"]
+
+CONF_GDOOR_ID = "gdoor_id"
+CONF_UDP_TARGET = "udp_target"
+CONF_UDP_TARGET_PORT = "udp_target_port"
+CONF_BATCH_SIZE = "batch_size"
+CONF_BATCH_TIMEOUT = "batch_timeout"
+CONF_RAW = "raw"
+CONF_MAX_CLIENTS = "max_clients"
+CONF_ACCEPT_TX = "accept_tx"
+
+DEFAULT_PORT = 5555
+
+GDoorStreamServer = gdoor_esphome_ns.class_("GDoorStreamServer", cg.Component)
+Protocol = GDoorStreamServer.enum("Protocol")
+PROTOCOLS = {
+    "tcp": Protocol.PROTOCOL_TCP,
+    "udp": Protocol.PROTOCOL_UDP,
+}
+
+
+def validate_udp_target(config):
+    """UDP has no connections, frames go to a fixed receiver."""
+    if config[CONF_PROTOCOL] == "udp" and CONF_UDP_TARGET not in config:
+        raise cv.Invalid(f"'{CONF_UDP_TARGET}' is required for protocol udp")
+    if config[CONF_PROTOCOL] == "tcp" and CONF_UDP_TARGET in config:
+        raise cv.Invalid(f"'{CONF_UDP_TARGET}' only applies to protocol udp")
+    return config
+
+
+CONFIG_SCHEMA = cv.All(
+    cv.Schema({
+        cv.GenerateID(): cv.declare_id(GDoorStreamServer),
+        cv.GenerateID(CONF_GDOOR_ID): cv.use_id(GdoorComponent),
+        cv.Optional(CONF_PROTOCOL, default="tcp"): cv.enum(PROTOCOLS, lower=True),
+        cv.Optional(CONF_PORT, default=DEFAULT_PORT): cv.port,
+        cv.Optional(CONF_UDP_TARGET): cv.ipv4address,
+        cv.Optional(CONF_UDP_TARGET_PORT, default=DEFAULT_PORT): cv.port,
+        # Records are collected until the batch has this many bytes or is this old
+        cv.Optional(CONF_BATCH_SIZE, default=512): cv.int_range(min=1, max=1400),
+        cv.Optional(CONF_BATCH_TIMEOUT, default="20ms"): cv.positive_time_period_milliseconds,
+        cv.Optional(CONF_RAW, default=False): cv.boolean,
+        cv.Optional(CONF_MAX_CLIENTS, default=2): cv.int_range(min=1, max=4),
+        cv.Optional(CONF_ACCEPT_TX, default=True): cv.boolean,
+    }).extend(cv.COMPONENT_SCHEMA),
+    validate_udp_target,
+)
+
+
+def validate_raw_capture(config):
+    """Raw pulse trains only exist when the gdoor bus keeps them."""
+    if not config[CONF_RAW]:
+        return config
+    full_config = fv.full_config.get()
+    bus_path = full_config.get_path_for_id(config[CONF_GDOOR_ID])[:-1]
+    bus = full_config.get_config_for_path(bus_path)
+    if not bus[CONF_RAW_CAPTURE]:
+        raise cv.Invalid(f"'{CONF_RAW}' needs '{CONF_RAW_CAPTURE}: true' on the gdoor bus")
+    return config
+
+
+FINAL_VALIDATE_SCHEMA = validate_raw_capture
+
+
+async def to_code(config):
+    parent = await cg.get_variable(config[CONF_GDOOR_ID])
+    var = cg.new_Pvariable(config[CONF_ID])
+    await cg.register_component(var, config)
+    cg.add(var.set_parent(parent))
+    cg.add(var.set_protocol(config[CONF_PROTOCOL]))
+    cg.add(var.set_port(config[CONF_PORT]))
+    if CONF_UDP_TARGET in config:
+        cg.add(var.set_udp_target(str(config[CONF_UDP_TARGET]), config[CONF_UDP_TARGET_PORT]))
+    cg.add(var.set_batch(config[CONF_BATCH_SIZE], config[CONF_BATCH_TIMEOUT]))
+    cg.add(var.set_stream_raw(config[CONF_RAW]))
+    cg.add(var.set_max_clients(config[CONF_MAX_CLIENTS]))
+    cg.add(var.set_accept_tx(config[CONF_ACCEPT_TX]))
@@ -0,0 +1,273 @@
+#include "gdoor_stream_server.h"
+#include <cerrno>
+#include <cstring>
+#include "esphome/core/hal.h"
+#include "esphome/core/log.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+static const char *TAG = "gdoor_stream";
+
+// Longest record a client may send: TX header plus the largest frame
+static const uint16_t MAX_INPUT_RECORD = STREAM_HEADER_LEN + MAX_WORDLEN;
+
+void GDoorStreamServer::setup() {
+  int type = this->protocol_ == PROTOCOL_TCP ? SOCK_STREAM : SOCK_DGRAM;
+  this->socket_ = socket::socket_ip(type, 0);
+  if (this->socket_ == nullptr) {
+    ESP_LOGE(TAG, "Could not create socket");
+    this->mark_failed();
+    return;
+  }
+  int enable = 1;
+  this->socket_->setsockopt(SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(int));
+  if (this->socket_->setblocking(false) != 0) {
+    ESP_LOGE(TAG, "Could not make socket non-blocking");
+    this->mark_failed();
+    return;
+  }
+
+  struct sockaddr_storage server;
+  socklen_t sl = socket::set_sockaddr_any((struct sockaddr *) &server, sizeof(server), this->port_);
+  if (sl == 0 || this->socket_->bind((struct sockaddr *) &server, sl) != 0) {
+    ESP_LOGE(TAG, "Could not bind port %u: errno %d", this->port_, errno);
+    this->mark_failed();
+    return;
+  }
+  if (this->protocol_ == PROTOCOL_TCP && this->socket_->listen(this->max_clients_) != 0) {
+    ESP_LOGE(TAG, "Could not listen: errno %d", errno);
+    this->mark_failed();
+    return;
+  }
+
+  this->batch_.reserve(this->batch_size_ + STREAM_HEADER_LEN + 2 * MAX_WORDLEN);
+  this->parent_->register_frame_listener(this);
+}
+
+void GDoorStreamServer::put_record_(std::vector<uint8_t> &out, uint8_t type, uint8_t flags, uint32_t timestamp,
+                                    const uint8_t *payload, uint16_t len) {
+  uint16_t record_len = STREAM_HEADER_LEN - 2 + len;
+  const uint8_t header[STREAM_HEADER_LEN] = {
+      (uint8_t) (record_len >> 8), (uint8_t) record_len,   type, flags,
+      (uint8_t) (timestamp >> 24), (uint8_t) (timestamp >> 16), (uint8_t) (timestamp >> 8), (uint8_t) timestamp,
+  };
+  out.insert(out.end(), header, header + STREAM_HEADER_LEN);
+  out.insert(out.end(), payload, payload + len);
+}
+
+void GDoorStreamServer::on_frame(const GDOOR_DATA &frame) {
+  if (this->protocol_ == PROTOCOL_TCP && this->clients_.empty()) {
+    return;  // nobody listening, nothing to keep
+  }
+  if (this->batch_.empty()) {
+    this->batch_started_ = millis();
+  }
+  uint8_t flags = 0;
+  if (frame.valid) {
+    flags |= STREAM_FLAG_VALID;
+  }
+  if (frame.crc_error) {
+    flags |= STREAM_FLAG_CRC_ERROR;
+  }
+  if (frame.parity_errors) {
+    flags |= STREAM_FLAG_PARITY_ERROR;
+  }
+  // Stamped with the bus time of the frame end; the payload leads with its start
+  uint32_t end_us = (uint32_t) frame.end_us;
+  uint32_t start_us = (uint32_t) frame.start_us;
+  uint8_t payload[4 + MAX_WORDLEN] = {(uint8_t) (start_us >> 24), (uint8_t) (start_us >> 16), (uint8_t) (start_us >> 8),
+                                      (uint8_t) start_us};
+  memcpy(payload + 4, frame.data, frame.len);
+  put_record_(this->batch_, STREAM_RECORD_FRAME, flags, end_us, payload, 4 + frame.len);
+#ifdef USE_GDOOR_RAW_CAPTURE
+  if (this->stream_raw_) {
+    put_record_(this->batch_, STREAM_RECORD_RAW, 0, end_us, frame.raw, frame.raw_len);
+  }
+#endif
+  if (this->batch_.size() >= this->batch_size_) {
+    this->flush_batch_();
+  }
+}
+
+/*
+ * Hand the batch to every client as a whole. A client whose queue cannot take
+ * it loses this batch (counted), so a stalled reader never holds a half record
+ * and never grows memory.
+ */
+void GDoorStreamServer::flush_batch_() {
+  if (this->batch_.empty()) {
+    return;
+  }
+  if (this->protocol_ == PROTOCOL_UDP) {
+    struct sockaddr_storage target;
+    socklen_t sl = socket::set_sockaddr((struct sockaddr *) &target, sizeof(target), this->udp_target_,
+                                        this->udp_target_port_);
+    if (sl == 0 || this->socket_->sendto(this->batch_.data(), this->batch_.size(), 0, (struct sockaddr *) &target,
+                                         sl) < 0) {
+      this->dropped_batches_++;
+    }
+  } else {
+    for (auto &client : this->clients_) {
+      if (client.out.size() + this->batch_.size() > CLIENT_QUEUE_MAX) {
+        this->dropped_batches_++;
+        continue;
+      }
+      client.out.insert(client.out.end(), this->batch_.begin(), this->batch_.end());
+      this->write_client_(client);
+    }
+  }
+  this->batch_.clear();
+}
+
+void GDoorStreamServer::loop() {
+  if (!this->batch_.empty() && millis() - this->batch_started_ >= this->batch_timeout_) {
+    this->flush_batch_();
+  }
+
+  if (this->protocol_ == PROTOCOL_UDP) {
+    this->read_udp_();
+    return;
+  }
+
+  this->accept_clients_();
+  for (auto &client : this->clients_) {
+    this->read_client_(client);
+    this->write_client_(client);
+  }
+  for (auto it = this->clients_.begin(); it != this->clients_.end();) {
+    if (it->closed) {
+      ESP_LOGD(TAG, "Client disconnected");
+      it = this->clients_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void GDoorStreamServer::accept_clients_() {
+  while (true) {
+    struct sockaddr_storage source;
+    socklen_t sl = sizeof(source);
+    auto sock = this->socket_->accept((struct sockaddr *) &source, &sl);
+    if (sock == nullptr) {
+      return;
+    }
+    if (this->clients_.size() >= this->max_clients_) {
+      ESP_LOGW(TAG, "Rejected client, %u already connected", this->max_clients_);
+      continue;  // unique_ptr closes it
+    }
+    sock->setblocking(false);
+    int enable = 1;
+    sock->setsockopt(IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(int));
+    ESP_LOGD(TAG, "Client %s connected", sock->getpeername().c_str());
+    Client client;
+    client.socket = std::move(sock);
+    this->clients_.push_back(std::move(client));
+  }
+}
+
+void GDoorStreamServer::read_client_(Client &client) {
+  uint8_t buf[128];
+  while (!client.closed) {
+    ssize_t read = client.socket->read(buf, sizeof(buf));
+    if (read == 0 || (read < 0 && errno != EAGAIN && errno != EWOULDBLOCK)) {
+      client.closed = true;
+      return;
+    }
+    if (read < 0) {
+      return;
+    }
+    client.in.insert(client.in.end(), buf, buf + read);
+    this->handle_input_(client.in, client.out);
+    if (client.in.size() > MAX_INPUT_RECORD) {
+      ESP_LOGW(TAG, "Client sent an oversized record, disconnecting");
+      client.closed = true;
+    }
+  }
+}
+
+void GDoorStreamServer::write_client_(Client &client) {
+  if (client.closed || client.out.empty()) {
+    return;
+  }
+  ssize_t written = client.socket->write(client.out.data(), client.out.size());
+  if (written < 0) {
+    if (errno != EAGAIN && errno != EWOULDBLOCK) {
+      client.closed = true;
+    }
+    return;
+  }
+  client.out.erase(client.out.begin(), client.out.begin() + written);
+}
+
+void GDoorStreamServer::read_udp_() {
+  uint8_t buf[MAX_INPUT_RECORD * 4];
+  struct sockaddr_storage source;
+  socklen_t sl = sizeof(source);
+  ssize_t read = this->socket_->recvfrom(buf, sizeof(buf), (struct sockaddr *) &source, &sl);
+  if (read <= 0) {
+    return;
+  }
+  // A datagram carries whole records only, a partial tail is discarded
+  std::vector<uint8_t> in(buf, buf + read);
+  std::vector<uint8_t> reply;
+  this->handle_input_(in, reply);
+  if (!reply.empty()) {
+    this->socket_->sendto(reply.data(), reply.size(), 0, (struct sockaddr *) &source, sl);
+  }
+}
+
+void GDoorStreamServer::handle_input_(std::vector<uint8_t> &buf, std::vector<uint8_t> &reply) {
+  size_t pos = 0;
+  while (buf.size() - pos >= 2) {
+    uint16_t record_len = (buf[pos] << 8) | buf[pos + 1];
+    if (buf.size() - pos < 2u + record_len) {
+      break;
+    }
+    const uint8_t *record = &buf[pos];
+    pos += 2 + record_len;
+    if (record_len < STREAM_HEADER_LEN - 2 || record[2] != STREAM_RECORD_TX) {
+      ESP_LOGV(TAG, "Ignoring record of %u bytes, type 0x%02X", record_len, record_len >= 1 ? record[2] : 0);
+      continue;
+    }
+    const uint8_t *frame = record + STREAM_HEADER_LEN;
+    uint16_t len = record_len - (STREAM_HEADER_LEN - 2);
+    bool sent = false;
+    if (!this->accept_tx_) {
+      ESP_LOGW(TAG, "TX record rejected, accept_tx is off");
+    } else if (len < 2 || len >= MAX_WORDLEN || GDOOR_UTILS::crc(frame, len - 1) != frame[len - 1]) {
+      ESP_LOGW(TAG, "TX record rejected, bad length or CRC");
+    } else {
+      sent = this->parent_->send_bus_frame(frame, len);
+    }
+    put_record_(reply, STREAM_RECORD_TX_RESULT, sent ? STREAM_FLAG_TX_SENT : 0, micros(), frame, len);
+  }
+  buf.erase(buf.begin(), buf.begin() + pos);
+}
+
+void GDoorStreamServer::on_shutdown() {
+  for (auto &client : this->clients_) {
+    client.socket->close();
+  }
+  this->clients_.clear();
+  if (this->socket_ != nullptr) {
+    this->socket_->close();
+  }
+}
+
+void GDoorStreamServer::dump_config() {
+  ESP_LOGCONFIG(TAG, "GDoor Stream Server:");
+  if (this->protocol_ == PROTOCOL_TCP) {
+    ESP_LOGCONFIG(TAG, "  Protocol: TCP, port %u, max %u clients", this->port_, this->max_clients_);
+  } else {
+    ESP_LOGCONFIG(TAG, "  Protocol: UDP, port %u -> %s:%u", this->port_, this->udp_target_.c_str(),
+                  this->udp_target_port_);
+  }
+  ESP_LOGCONFIG(TAG, "  Batch: %u bytes / %" PRIu32 "ms", this->batch_size_, this->batch_timeout_);
+  ESP_LOGCONFIG(TAG, "  Raw pulses: %s", YESNO(this->stream_raw_));
+  ESP_LOGCONFIG(TAG, "  Accept TX: %s", YESNO(this->accept_tx_));
+}
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include "esphome/core/component.h"
+#include "esphome/components/socket/socket.h"
+#include "esphome/components/gdoor/gdoor_component.h"
+#include "esphome/components/gdoor/gdoor_bus_listener.h"
+
+namespace esphome {
+namespace gdoor_esphome {
+
+/*
+ * Wire format, all integers big-endian. Every record is
+ *
+ *   u16 len | u8 type | u8 flags | u32 timestamp_us | payload[len - 6]
+ *
+ * where len counts everything after the length field and the timestamp is
+ * micros() (wraps after 71 minutes). A batch is simply several records back
+ * to back (one TCP write or one UDP datagram).
+ *
+ * Device → client:
+ *   FRAME      timestamp = bus time of the last edge; payload = u32 bus time
+ *              of the first edge, frame bytes incl. CRC; flags = STREAM_FLAG_*
+ *   RAW        payload = 8-bit pulse counts of the preceding FRAME
+ *   TX_RESULT  payload = the frame that was requested; flags bit 0 = sent
+ * Client → device:
+ *   TX         payload = frame bytes incl. CRC, as an output payload;
+ *              flags and timestamp are ignored
+ */
+enum GDoorStreamRecord : uint8_t {
+  STREAM_RECORD_FRAME = 0x01,
+  STREAM_RECORD_RAW = 0x02,
+  STREAM_RECORD_TX_RESULT = 0x03,
+  STREAM_RECORD_TX = 0x10,
+};
+
+enum GDoorStreamFlag : uint8_t {
+  STREAM_FLAG_VALID = 0x01,
+  STREAM_FLAG_CRC_ERROR = 0x02,
+  STREAM_FLAG_PARITY_ERROR = 0x04,
+  STREAM_FLAG_TX_SENT = 0x01,
+};
+
+static const uint8_t STREAM_HEADER_LEN = 8;  // len + type + flags + timestamp
+
+/// Streams every decoded frame (optionally with its raw pulse counts) to
+/// TCP clients or a UDP target, batched by size and age, and accepts TX
+/// records the same way.
+class GDoorStreamServer : public Component, public GDoorFrameListener {
+ public:
+  enum Protocol : uint8_t { PROTOCOL_TCP, PROTOCOL_UDP };
+
+  void set_parent(GdoorComponent *parent) { this->parent_ = parent; }
+  void set_protocol(Protocol protocol) { this->protocol_ = protocol; }
+  void set_port(uint16_t port) { this->port_ = port; }
+  void set_udp_target(const std::string &address, uint16_t port) {
+    this->udp_target_ = address;
+    this->udp_target_port_ = port;
+  }
+  void set_batch(uint16_t size, uint32_t timeout) {
+    this->batch_size_ = size;
+    this->batch_timeout_ = timeout;
+  }
+  void set_stream_raw(bool stream_raw) { this->stream_raw_ = stream_raw; }
+  void set_accept_tx(bool accept_tx) { this->accept_tx_ = accept_tx; }
+  void set_max_clients(uint8_t max_clients) { this->max_clients_ = max_clients; }
+
+  float get_setup_priority() const override { return setup_priority::AFTER_WIFI; }
+  void setup() override;
+  void loop() override;
+  void dump_config() override;
+  void on_shutdown() override;
+
+  // Called by GdoorComponent::loop() for every decoded frame
+  void on_frame(const GDOOR_DATA &frame) override;
+
+  uint32_t get_dropped_batches() const { return this->dropped_batches_; }
+
+ protected:
+  // Per TCP client: unsent output and a partial input record
+  struct Client {
+    std::unique_ptr<socket::Socket> socket;
+    std::vector<uint8_t> out;
+    std::vector<uint8_t> in;
+    bool closed{false};
+  };
+  // Output a slow client may have queued before new batches are dropped for it
+  static const size_t CLIENT_QUEUE_MAX = 4096;
+
+  static void put_record_(std::vector<uint8_t> &out, uint8_t type, uint8_t flags, uint32_t timestamp,
+                          const uint8_t *payload, uint16_t len);
+  void flush_batch_();
+  void accept_clients_();
+  void read_client_(Client &client);
+  void write_client_(Client &client);
+  void read_udp_();
+  // Handle all complete records in buf, remove them; replies go to reply
+  void handle_input_(std::vector<uint8_t> &buf, std::vector<uint8_t> &reply);
+
+  GdoorComponent *parent_{nullptr};
+  Protocol protocol_{PROTOCOL_TCP};
+  uint16_t port_{5555};
+  std::string udp_target_;
+  uint16_t udp_target_port_{5555};
+  uint16_t batch_size_{512};
+  uint32_t batch_timeout_{20};
+  bool stream_raw_{false};
+  bool accept_tx_{true};
+  uint8_t max_clients_{2};
+
+  std::unique_ptr<socket::Socket> socket_;
+  std::vector<Client> clients_;
+  std::vector<uint8_t> batch_;
+  uint32_t batch_started_{0};
+  uint32_t dropped_batches_{0};
+};
+
+}  // namespace gdoor_esphome
+}  // namespace esphome
@@ -0,0 +1,1382 @@
+/*
+ * This file is part of the GDoor distribution (https://github.com/gdoor-org).
+ * Copyright (c) 2024 GDoor authors.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * gdoor_archive: decodes bus captures into an indexed, memory-mapped archive
+ * and queries it. Linux only.
+ *
+ *   gdoor_archive build [-j N] [--append] OUT.gda INPUT...
+ *   gdoor_archive query ARCHIVE [--from T] [--to T] [--action A] [--source S]
+ *                       [--valid | --invalid] [--json | --count] [--counts]
+ *   gdoor_archive info ARCHIVE
+ *   gdoor_archive bench [json | view] [FRAMES]
+ *   gdoor_archive bench registry
+ *
+ * Inputs are gdoor_sniffer captures (pulse trains, re-decoded here with the
+ * firmware's GDOOR_DATA::parse()) and text logs holding the JSON bus message
+ * (ESPHome logs, MQTT dumps), one file per thread. See README.md.
+ */
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "gdoor_data.h"
+#include "gdoor_data_batch.h"
+#include "gdoor_device_registry.h"
+#include "gdoor_utils.h"
+#include "gdoor_archive.h"
+
+// Pulse trains and decoded records of one input file
+struct FILE_RESULT {
+    std::string name;
+    std::vector<GDA_RECORD> records; // blob_off relative to blob
+    std::vector<uint8_t> blob;
+    std::vector<uint32_t> order;     // input order, keeps the sort stable
+    std::string error;
+    uint32_t skipped = 0;            // bytes / lines that held no record
+};
+
+// A mapped archive
+struct ARCHIVE {
+    const uint8_t *base = nullptr;
+    size_t size = 0;
+    const GDA_HEADER *header = nullptr;
+    const GDA_RECORD *records = nullptr;
+    const GDA_INDEX *by_action = nullptr;
+    const GDA_INDEX *by_source = nullptr;
+    const GDA_INDEX *by_valid = nullptr;
+    const uint8_t *blob = nullptr;
+    std::vector<const char *> files;
+};
+
+static const uint32_t KEY_NONE = 0xFFFFFFFF; // action of an undecoded frame
+
+// ---------------------------------------------------------------------------
+// Helpers
+// ---------------------------------------------------------------------------
+static bool read_file(const char *path, std::vector<uint8_t> &out, int64_t *mtime_us) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    out.resize((size_t)st.st_size);
+    size_t pos = 0;
+    while (pos < out.size()) {
+        ssize_t n = read(fd, out.data() + pos, out.size() - pos);
+        if (n <= 0) break;
+        pos += (size_t)n;
+    }
+    close(fd);
+    out.resize(pos);
+    *mtime_us = (int64_t)st.st_mtim.tv_sec * 1000000 + st.st_mtim.tv_nsec / 1000;
+    return true;
+}
+
+static uint32_t be32(const uint8_t *p) {
+    return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | p[3];
+}
+
+static uint16_t be16(const uint8_t *p) {
+    return (uint16_t)(p[0] << 8 | p[1]);
+}
+
+// Decoded fields of a frame, as the firmware's GDOOR_DATA_VIEW sees them
+static void fill_record(GDA_RECORD &rec, const GDOOR_DATA &frame, bool parsed) {
+    GDOOR_DATA_VIEW view(&frame);
+    rec.len = parsed ? (uint8_t)frame.len : 0;
+    rec.flags = (uint8_t)(rec.flags
+              | (parsed ? GDA_FLAG_PARSED : 0)
+              | (frame.valid ? GDA_FLAG_VALID : 0)
+              | (frame.crc_error ? GDA_FLAG_CRC_ERROR : 0)
+              | (frame.parity_errors ? GDA_FLAG_PARITY_ERROR : 0));
+    rec.action = view.decoded() ? view.action_code() : 0;
+    rec.type = view.decoded() ? view.type_code() : 0;
+    rec.source = view.source();
+    rec.destination = view.destination();
+}
+
+static void add_record(FILE_RESULT &result, GDA_RECORD rec, const uint8_t *data,
+                       const uint8_t *counts, uint16_t counts_len) {
+    rec.blob_off = result.blob.size();
+    rec.counts_len = counts_len;
+    result.blob.insert(result.blob.end(), data, data + rec.len);
+    if (counts_len > 0) {
+        result.blob.insert(result.blob.end(), counts, counts + counts_len);
+    }
+    result.order.push_back((uint32_t)result.records.size());
+    result.records.push_back(rec);
+}
+
+// "2024-05-01T12:34:56.789Z", "2024-05-01 12:34:56" (local time) or unix
+// seconds; *us = unix µs. Returns the chars consumed, 0 if none matched.
+static size_t parse_time(const char *s, int64_t *us) {
+    struct tm tm = {};
+    int year, mon, day, hour, min, sec, consumed = 0;
+    if (sscanf(s, "%4d-%2d-%2d%*1[T ]%2d:%2d:%2d%n", &year, &mon, &day, &hour, &min, &sec, &consumed) == 6) {
+        tm.tm_year = year - 1900;
+        tm.tm_mon = mon - 1;
+        tm.tm_mday = day;
+        tm.tm_hour = hour;
+        tm.tm_min = min;
+        tm.tm_sec = sec;
+        tm.tm_isdst = -1;
+        int64_t frac = 0;
+        size_t pos = (size_t)consumed;
+        if (s[pos] == '.') {
+            int64_t scale = 100000;
+            for (pos++; s[pos] >= '0' && s[pos] <= '9'; pos++) {
+                frac += (s[pos] - '0') * scale;
+                scale /= 10;
+            }
+        }
+        time_t t;
+        if (s[pos] == 'Z') {
+            t = timegm(&tm);
+            pos++;
+        } else {
+            t = mktime(&tm);
+        }
+        *us = (int64_t)t * 1000000 + frac;
+        return pos;
+    }
+    char *end;
+    long long seconds = strtoll(s, &end, 10);
+    if (end != s && *end == '\0') {
+        *us = (int64_t)seconds * 1000000;
+        return (size_t)(end - s);
+    }
+    return 0;
+}
+
+static void format_time(int64_t us, char *out, size_t size) {
+    time_t t = (time_t)(us / 1000000);
+    struct tm tm;
+    gmtime_r(&t, &tm);
+    size_t n = strftime(out, size, "%Y-%m-%dT%H:%M:%S", &tm);
+    snprintf(out + n, size - n, ".%06" PRId64 "Z", us % 1000000);
+}
+
+// ---------------------------------------------------------------------------
+// Importers
+// ---------------------------------------------------------------------------
+
+/*
+ * gdoor_sniffer capture. Trains with counts are decoded again with the
+ * firmware's decoder, so a capture improves with the decoder; they go through
+ * GDOOR_DATA_BATCH in blocks of SNIFF_BATCH, which decodes exactly like
+ * GDOOR_DATA::parse(). The device time (micros(), wraps every 71 min) is
+ * unwrapped and anchored so the last record lands on the file's modification
+ * time, which is when the capture was last appended to.
+ */
+static const size_t SNIFF_BATCH = 256;
+
+// TRAIN record of a capture, pointing into the file buffer
+struct SNIFF_TRAIN {
+    int64_t time_us;
+    const uint8_t *counts;
+    const uint8_t *data; // as decoded on the device
+    uint16_t counts_len;
+    uint16_t data_len;
+    uint8_t flags;
+};
+
+static void import_sniffer_batch(const SNIFF_TRAIN *trains, size_t n, FILE_RESULT &result,
+                                 std::vector<uint8_t> &soa, std::vector<GDOOR_DATA> &frames) {
+    // Structure of arrays: count i of train f at soa[i * n + f]
+    uint16_t lens[SNIFF_BATCH];
+    bool parsed[SNIFF_BATCH];
+    uint16_t max_len = 0;
+    for (size_t f = 0; f < n; f++) {
+        lens[f] = trains[f].counts_len;
+        max_len = std::max(max_len, lens[f]);
+    }
+    soa.assign((size_t)max_len * n, 0);
+    // A train without a word leaves len and valid alone; start from zero
+    std::fill(frames.begin(), frames.begin() + n, GDOOR_DATA{});
+    for (size_t f = 0; f < n; f++) {
+        for (uint16_t i = 0; i < lens[f]; i++) soa[(size_t)i * n + f] = trains[f].counts[i];
+    }
+    GDOOR_DATA_BATCH::parse(soa.data(), n, lens, n, frames.data(), parsed);
+
+    for (size_t f = 0; f < n; f++) {
+        const SNIFF_TRAIN &train = trains[f];
+        GDOOR_DATA &frame = frames[f];
+        if (train.counts_len == 0) {
+            // No counts captured, keep what the device decoded
+            frame.len = std::min<uint16_t>(train.data_len, MAX_WORDLEN);
+            memcpy(frame.data, train.data, frame.len);
+            frame.valid = (train.flags & 0x02) != 0;
+            frame.crc_error = (train.flags & 0x04) != 0;
+            frame.parity_errors = (train.flags & 0x08) != 0;
+            parsed[f] = frame.len > 0;
+        }
+        GDA_RECORD rec = {};
+        rec.time_us = train.time_us;
+        fill_record(rec, frame, parsed[f]);
+        add_record(result, rec, frame.data, train.counts, train.counts_len);
+    }
+}
+
+static void import_sniffer(const std::vector<uint8_t> &buf, int64_t mtime_us, FILE_RESULT &result) {
+    std::vector<SNIFF_TRAIN> trains;
+    int64_t unwrapped = 0;
+    uint32_t last_ts = 0;
+    bool first = true;
+    size_t pos = 0;
+    while (pos + 4 <= buf.size()) {
+        if (buf[pos] != 0xA5 || buf[pos + 1] != 0x5A) {
+            pos++;
+            result.skipped++;
+            continue;
+        }
+        uint16_t len = be16(&buf[pos + 2]);
+        if (len < 11 || pos + 4 + len > buf.size()
+            || GDOOR_UTILS::crc(&buf[pos + 2], (uint16_t)(len + 1)) != buf[pos + 3 + len]) {
+            pos++;
+            result.skipped++;
+            continue;
+        }
+        const uint8_t *record = &buf[pos];
+        pos += 4 + len;
+        uint8_t type = record[4];
+        uint32_t ts = be32(record + 10);
+        // Records leave the device in time order; a step back is a wrap
+        unwrapped = first ? ts : unwrapped + (int32_t)(ts - last_ts);
+        last_ts = ts;
+        first = false;
+        const uint8_t *payload = record + 14;
+        uint16_t payload_len = (uint16_t)(len - 11);
+        if (type != 0x01 || payload_len < 16) {
+            continue; // STATUS and unknown records carry no train
+        }
+        uint16_t counts_len = be16(payload + 14);
+        if (16u + counts_len > payload_len) {
+            result.skipped += len;
+            continue;
+        }
+        SNIFF_TRAIN train;
+        train.time_us = unwrapped;
+        train.counts = payload + 16;
+        train.data = train.counts + counts_len;
+        train.counts_len = counts_len;
+        train.data_len = (uint16_t)(payload_len - 16 - counts_len);
+        train.flags = record[5];
+        trains.push_back(train);
+    }
+
+    // Importers run on several threads, so the buffers are per call
+    std::vector<uint8_t> soa;
+    std::vector<GDOOR_DATA> frames(SNIFF_BATCH);
+    int64_t offset = mtime_us - unwrapped;
+    for (size_t f = 0; f < trains.size(); f += SNIFF_BATCH) {
+        size_t n = std::min(SNIFF_BATCH, trains.size() - f);
+        for (size_t t = f; t < f + n; t++) trains[t].time_us += offset;
+        import_sniffer_batch(&trains[f], n, result, soa, frames);
+    }
+}
+
+/*
+ * Text log with the JSON bus message, one per line. The frame comes from
+ * "busdata" (validity from its CRC byte, parity is not in the message); the
+ * time from an ISO date and time at the start of the line, or from an
+ * ESPHome "[HH:MM:SS]" prefix on the file's modification date.
+ */
+static void import_json(const std::vector<uint8_t> &buf, int64_t mtime_us, FILE_RESULT &result) {
+    GDOOR_DATA frame{};
+    time_t mtime = (time_t)(mtime_us / 1000000);
+    struct tm day;
+    localtime_r(&mtime, &day);
+    std::string line;
+    size_t pos = 0;
+    while (pos < buf.size()) {
+        const uint8_t *nl = (const uint8_t *)memchr(&buf[pos], '\n', buf.size() - pos);
+        size_t end = nl != nullptr ? (size_t)(nl - buf.data()) : buf.size();
+        line.assign((const char *)&buf[pos], end - pos);
+        pos = end + 1;
+
+        const char *busdata = strstr(line.c_str(), "\"busdata\": \"");
+        if (busdata == nullptr) {
+            result.skipped++;
+            continue;
+        }
+        const char *hex = busdata + strlen("\"busdata\": \"");
+        const char *hex_end = strchr(hex, '"');
+        size_t hex_len = hex_end != nullptr ? (size_t)(hex_end - hex) : 0;
+        if (hex_len == 0 || hex_len % 2 != 0 || hex_len / 2 > MAX_WORDLEN) {
+            result.skipped++;
+            continue;
+        }
+        bool ok = true;
+        for (size_t i = 0; i < hex_len / 2; i++) {
+            unsigned int byte;
+            ok = ok && sscanf(hex + 2 * i, "%2x", &byte) == 1;
+            frame.data[i] = (uint8_t)byte;
+        }
+        if (!ok) {
+            result.skipped++;
+            continue;
+        }
+        frame.len = (uint16_t)(hex_len / 2);
+        frame.crc_error = frame.len < 2 || GDOOR_UTILS::crc(frame.data, frame.len - 1) != frame.data[frame.len - 1];
+        frame.valid = !frame.crc_error;
+        frame.parity_errors = 0;
+
+        GDA_RECORD rec = {};
+        rec.flags = GDA_FLAG_FROM_JSON;
+        const char *s = line.c_str();
+        int hour, min, sec, consumed = 0;
+        if (parse_time(s, &rec.time_us) > 0) {
+            // ISO prefix
+        } else if (sscanf(s, "[%2d:%2d:%2d%n", &hour, &min, &sec, &consumed) == 3) {
+            struct tm tm = day;
+            tm.tm_hour = hour;
+            tm.tm_min = min;
+            tm.tm_sec = sec;
+            tm.tm_isdst = -1;
+            int64_t frac = 0;
+            if (s[consumed] == '.') {
+                frac = strtol(s + consumed + 1, nullptr, 10) * 1000; // ms
+            }
+            rec.time_us = (int64_t)mktime(&tm) * 1000000 + frac;
+        } else {
+            rec.flags |= GDA_FLAG_NO_TIME;
+        }
+        fill_record(rec, frame, true);
+        add_record(result, rec, frame.data, nullptr, 0);
+    }
+}
+
+static void import_file(FILE_RESULT &result) {
+    std::vector<uint8_t> buf;
+    int64_t mtime_us;
+    if (!read_file(result.name.c_str(), buf, &mtime_us)) {
+        result.error = strerror(errno);
+        return;
+    }
+    if (buf.size() >= 2 && buf[0] == 0xA5 && buf[1] == 0x5A) {
+        import_sniffer(buf, mtime_us, result);
+    } else {
+        import_json(buf, mtime_us, result);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Archive files
+// ---------------------------------------------------------------------------
+// count elements of elem bytes at off lie inside the mapping, without overflow
+static bool in_archive(const ARCHIVE &archive, uint64_t off, uint64_t count, uint64_t elem) {
+    return off <= archive.size && count <= (archive.size - off) / elem;
+}
+
+static bool map_archive(const char *path, ARCHIVE &archive) {
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+    archive.size = (size_t)st.st_size;
+    void *base = archive.size >= sizeof(GDA_HEADER)
+               ? mmap(nullptr, archive.size, PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+    close(fd);
+    if (base == MAP_FAILED) {
+        fprintf(stderr, "%s: not a gdoor archive\n", path);
+        return false;
+    }
+    archive.base = (const uint8_t *)base;
+    const GDA_HEADER *h = archive.header = (const GDA_HEADER *)base;
+    bool ok = memcmp(h->magic, GDA_MAGIC, sizeof(h->magic)) == 0 && h->version == GDA_VERSION
+           && in_archive(archive, h->records_off, h->records, sizeof(GDA_RECORD))
+           && in_archive(archive, h->by_action_off, h->records, sizeof(GDA_INDEX))
+           && in_archive(archive, h->by_source_off, h->records, sizeof(GDA_INDEX))
+           && in_archive(archive, h->by_valid_off, h->records, sizeof(GDA_INDEX))
+           && in_archive(archive, h->blob_off, h->blob_len, 1)
+           && in_archive(archive, h->names_off, 0, 1);
+    // Names are NUL-terminated back to back; none may run off the end
+    const char *name = ok ? (const char *)(archive.base + h->names_off) : nullptr;
+    const char *names_end = (const char *)(archive.base + archive.size);
+    for (uint32_t i = 0; ok && i < h->files; i++) {
+        const char *nul = (const char *)memchr(name, '\0', (size_t)(names_end - name));
+        if (nul == nullptr) {
+            ok = false;
+            break;
+        }
+        archive.files.push_back(name);
+        name = nul + 1;
+    }
+    if (!ok) {
+        fprintf(stderr, "%s: not a gdoor archive or truncated\n", path);
+        munmap(base, archive.size);
+        archive = ARCHIVE();
+        return false;
+    }
+    archive.records = (const GDA_RECORD *)(archive.base + h->records_off);
+    archive.by_action = (const GDA_INDEX *)(archive.base + h->by_action_off);
+    archive.by_source = (const GDA_INDEX *)(archive.base + h->by_source_off);
+    archive.by_valid = (const GDA_INDEX *)(archive.base + h->by_valid_off);
+    archive.blob = archive.base + h->blob_off;
+    // Queries walk the indexes front to back
+    madvise(base, archive.size, MADV_WILLNEED);
+    return true;
+}
+
+static bool write_all(FILE *f, const void *data, size_t len) {
+    return len == 0 || fwrite(data, 1, len, f) == len;
+}
+
+/*
+ * Merge the per-file results by time (input order breaks ties), build the
+ * three indexes and write the archive in one pass.
+ */
+static bool write_archive(const char *path, std::vector<FILE_RESULT> &results) {
+    struct ENTRY {
+        int64_t time_us;
+        uint32_t file;
+        uint32_t order;
+    };
+    std::vector<ENTRY> entries;
+    size_t total = 0;
+    for (auto &r : results) total += r.records.size();
+    if (total > UINT32_MAX) {
+        fprintf(stderr, "More than %" PRIu32 " records\n", UINT32_MAX);
+        return false;
+    }
+    entries.reserve(total);
+    for (uint32_t f = 0; f < results.size(); f++) {
+        for (uint32_t i : results[f].order) entries.push_back({results[f].records[i].time_us, f, i});
+    }
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const ENTRY &a, const ENTRY &b) { return a.time_us < b.time_us; });
+
+    std::vector<uint64_t> blob_base(results.size());
+    uint64_t blob_len = 0;
+    for (size_t f = 0; f < results.size(); f++) {
+        blob_base[f] = blob_len;
+        blob_len += results[f].blob.size();
+    }
+    std::vector<GDA_RECORD> records(total);
+    std::vector<GDA_INDEX> by_action(total), by_source(total), by_valid(total);
+    GDA_HEADER header = {};
+    memcpy(header.magic, GDA_MAGIC, sizeof(header.magic));
+    header.version = GDA_VERSION;
+    header.first_us = INT64_MAX;
+    header.last_us = INT64_MIN;
+    for (uint32_t i = 0; i < total; i++) {
+        GDA_RECORD rec = results[entries[i].file].records[entries[i].order];
+        rec.blob_off += blob_base[entries[i].file];
+        rec.file = (uint16_t)entries[i].file;
+        records[i] = rec;
+        bool decoded = (rec.flags & GDA_FLAG_VALID) && rec.len >= 9;
+        by_action[i] = {decoded ? rec.action : KEY_NONE, i};
+        by_source[i] = {rec.source, i};
+        by_valid[i] = {(uint32_t)(rec.flags & GDA_FLAG_VALID), i};
+        if (!(rec.flags & GDA_FLAG_NO_TIME)) {
+            header.first_us = std::min(header.first_us, rec.time_us);
+            header.last_us = std::max(header.last_us, rec.time_us);
+        }
+    }
+    auto by_key = [](const GDA_INDEX &a, const GDA_INDEX &b) {
+        return a.key != b.key ? a.key < b.key : a.record < b.record;
+    };
+    std::sort(by_action.begin(), by_action.end(), by_key);
+    std::sort(by_source.begin(), by_source.end(), by_key);
+    std::sort(by_valid.begin(), by_valid.end(), by_key);
+
+    std::string names;
+    for (auto &r : results) names.append(r.name.c_str(), r.name.size() + 1);
+    uint64_t index_len = total * sizeof(GDA_INDEX);
+    header.files = (uint32_t)results.size();
+    header.records = total;
+    header.names_off = sizeof(GDA_HEADER);
+    header.records_off = (header.names_off + names.size() + 7) & ~(uint64_t)7;
+    header.by_action_off = header.records_off + total * sizeof(GDA_RECORD);
+    header.by_source_off = header.by_action_off + index_len;
+    header.by_valid_off = header.by_source_off + index_len;
+    header.blob_off = header.by_valid_off + index_len;
+    header.blob_len = blob_len;
+
+    std::string tmp = std::string(path) + ".tmp";
+    FILE *f = fopen(tmp.c_str(), "wb");
+    if (f == nullptr) {
+        fprintf(stderr, "%s: %s\n", tmp.c_str(), strerror(errno));
+        return false;
+    }
+    static const uint8_t PAD[8] = {};
+    bool ok = write_all(f, &header, sizeof(header))
+           && write_all(f, names.data(), names.size())
+           && write_all(f, PAD, header.records_off - header.names_off - names.size())
+           && write_all(f, records.data(), total * sizeof(GDA_RECORD))
+           && write_all(f, by_action.data(), index_len)
+           && write_all(f, by_source.data(), index_len)
+           && write_all(f, by_valid.data(), index_len);
+    for (auto &r : results) ok = ok && write_all(f, r.blob.data(), r.blob.size());
+    ok = fclose(f) == 0 && ok;
+    // Replace only a complete archive, so --append never loses the old one
+    if (!ok || rename(tmp.c_str(), path) != 0) {
+        fprintf(stderr, "%s: %s\n", path, strerror(errno));
+        unlink(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+// Records of an existing archive as one more input (build --append)
+static void load_archive(const ARCHIVE &archive, std::vector<FILE_RESULT> &results) {
+    size_t first = results.size();
+    for (const char *name : archive.files) {
+        results.emplace_back();
+        results.back().name = name;
+    }
+    for (uint64_t i = 0; i < archive.header->records; i++) {
+        const GDA_RECORD &rec = archive.records[i];
+        FILE_RESULT &r = results[first + rec.file];
+        const uint8_t *data = archive.blob + rec.blob_off;
+        add_record(r, rec, data, data + rec.len, rec.counts_len);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// Commands
+// ---------------------------------------------------------------------------
+static int cmd_build(int argc, char **argv) {
+    unsigned threads = std::max(1u, std::thread::hardware_concurrency());
+    bool append = false;
+    int i = 0;
+    for (; i < argc && argv[i][0] == '-'; i++) {
+        if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            threads = (unsigned)std::max(1, atoi(argv[++i]));
+        } else if (strcmp(argv[i], "--append") == 0) {
+            append = true;
+        } else {
+            fprintf(stderr, "Unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+    if (argc - i < 2) {
+        fprintf(stderr, "build needs an archive and at least one input\n");
+        return 2;
+    }
+    const char *out = argv[i++];
+
+    std::vector<FILE_RESULT> results;
+    ARCHIVE old;
+    if (append && access(out, F_OK) == 0) {
+        if (!map_archive(out, old)) return 1;
+        load_archive(old, results);
+    }
+    size_t first_new = results.size();
+    for (; i < argc; i++) {
+        bool known = false;
+        for (size_t f = 0; f < first_new && !known; f++) known = results[f].name == argv[i];
+        if (known) {
+            fprintf(stderr, "%s: already in %s, skipped\n", argv[i], out);
+            continue;
+        }
+        results.emplace_back();
+        results.back().name = argv[i];
+    }
+    if (results.size() > UINT16_MAX) {
+        fprintf(stderr, "More than %u input files\n", UINT16_MAX);
+        return 2;
+    }
+
+    // One file per task, files are independent
+    std::atomic<size_t> next{first_new};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < std::min<size_t>(threads, results.size() - first_new); t++) {
+        pool.emplace_back([&]() {
+            for (size_t f; (f = next++) < results.size();) import_file(results[f]);
+        });
+    }
+    for (auto &t : pool) t.join();
+
+    int status = 0;
+    for (size_t f = first_new; f < results.size(); f++) {
+        const FILE_RESULT &r = results[f];
+        if (!r.error.empty()) {
+            fprintf(stderr, "%s: %s\n", r.name.c_str(), r.error.c_str());
+            status = 1;
+        } else {
+            fprintf(stderr, "%s: %zu records, %" PRIu32 " skipped\n", r.name.c_str(), r.records.size(), r.skipped);
+        }
+    }
+    if (!write_archive(out, results)) return 1;
+    return status;
+}
+
+struct QUERY {
+    int64_t from = INT64_MIN;
+    int64_t to = INT64_MAX; // exclusive
+    bool has_action = false, has_source = false, has_valid = false;
+    uint32_t action = 0, source = 0, valid = 0;
+    bool json = false, count = false, counts = false;
+
+    bool matches(const GDA_RECORD &rec) const {
+        bool decoded = (rec.flags & GDA_FLAG_VALID) && rec.len >= 9;
+        return !(has_action && (!decoded || rec.action != action))
+            && !(has_source && rec.source != source)
+            && !(has_valid && (uint32_t)(rec.flags & GDA_FLAG_VALID) != valid);
+    }
+};
+
+static bool parse_action(const char *s, uint32_t *action) {
+    for (auto &entry : GDOOR_DATA_ACTION) {
+        if (strcasecmp(entry.second, s) == 0) {
+            *action = (uint32_t)entry.first;
+            return true;
+        }
+    }
+    char *end;
+    unsigned long value = strtoul(s, &end, 16);
+    *action = (uint32_t)value;
+    return end != s && *end == '\0' && value <= 0xFF;
+}
+
+// Records [lo, hi) of one key, narrowed to the record range [first, last)
+static std::pair<const GDA_INDEX *, const GDA_INDEX *> key_range(const GDA_INDEX *index, uint64_t n, uint32_t key,
+                                                                uint32_t first, uint32_t last) {
+    const GDA_INDEX *lo = std::lower_bound(index, index + n, GDA_INDEX{key, first},
+                                           [](const GDA_INDEX &a, const GDA_INDEX &b) {
+                                               return a.key != b.key ? a.key < b.key : a.record < b.record;
+                                           });
+    const GDA_INDEX *hi = std::lower_bound(lo, index + n, GDA_INDEX{key, last},
+                                           [](const GDA_INDEX &a, const GDA_INDEX &b) {
+                                               return a.key != b.key ? a.key < b.key : a.record < b.record;
+                                           });
+    return {lo, hi};
+}
+
+static void print_record(const ARCHIVE &archive, const QUERY &query, uint32_t i) {
+    static GDOOR_DATA frame;
+    const GDA_RECORD &rec = archive.records[i];
+    const uint8_t *data = archive.blob + rec.blob_off;
+    char when[40];
+    if (rec.flags & GDA_FLAG_NO_TIME) {
+        snprintf(when, sizeof(when), "-");
+    } else {
+        format_time(rec.time_us, when, sizeof(when));
+    }
+    if (query.json) {
+        // Same message as the firmware renders, event_id = record number
+        frame.len = rec.len;
+        memcpy(frame.data, data, rec.len);
+        frame.valid = (rec.flags & GDA_FLAG_VALID) != 0;
+        GDOOR_DATA_VIEW view(&frame);
+        std::string json(view.json_length(i), '\0');
+        view.write_json(&json[0], i);
+        printf("{\"time\": \"%s\", %s}\n", when, json.c_str());
+        return;
+    }
+    printf("%s %-20s ", when, (rec.flags & GDA_FLAG_VALID) && rec.len >= 9
+                              ? (GDOOR_DATA_ACTION.count(rec.action) ? GDOOR_DATA_ACTION.at(rec.action)
+                                                                     : "ACTION_UNKOWN")
+                              : "-");
+    for (uint8_t b = 0; b < rec.len; b++) printf("%02X", data[b]);
+    if (rec.len == 0) printf("-");
+    printf(" %s %s\n", rec.flags & GDA_FLAG_VALID ? "valid" : "invalid", archive.files[rec.file]);
+    if (query.counts && rec.counts_len > 0) {
+        printf("    counts");
+        for (uint16_t c = 0; c < rec.counts_len; c++) printf(" %u", data[rec.len + c]);
+        printf("\n");
+    }
+}
+
+static int cmd_query(int argc, char **argv) {
+    if (argc < 1) {
+        fprintf(stderr, "query needs an archive\n");
+        return 2;
+    }
+    QUERY query;
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *value = i + 1 < argc ? argv[i + 1] : "";
+        bool ok = true;
+        if (strcmp(arg, "--from") == 0) {
+            ok = parse_time(value, &query.from) > 0;
+            i++;
+        } else if (strcmp(arg, "--to") == 0) {
+            ok = parse_time(value, &query.to) > 0;
+            i++;
+        } else if (strcmp(arg, "--action") == 0) {
+            ok = query.has_action = parse_action(value, &query.action);
+            i++;
+        } else if (strcmp(arg, "--source") == 0) {
+            char *end;
+            query.source = (uint32_t)strtoul(value, &end, 16);
+            ok = query.has_source = end != value && *end == '\0';
+            i++;
+        } else if (strcmp(arg, "--valid") == 0 || strcmp(arg, "--invalid") == 0) {
+            query.has_valid = true;
+            query.valid = arg[2] == 'v' ? GDA_FLAG_VALID : 0;
+        } else if (strcmp(arg, "--json") == 0) {
+            query.json = true;
+        } else if (strcmp(arg, "--count") == 0) {
+            query.count = true;
+        } else if (strcmp(arg, "--counts") == 0) {
+            query.counts = true;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            fprintf(stderr, "Bad option %s %s\n", arg, value);
+            return 2;
+        }
+    }
+
+    ARCHIVE archive;
+    if (!map_archive(argv[0], archive)) return 1;
+    uint64_t n = archive.header->records;
+
+    // Time range by binary search; untimed records sort first (time 0)
+    auto by_time = [](const GDA_RECORD &rec, int64_t t) { return rec.time_us < t; };
+    uint32_t first = (uint32_t)(std::lower_bound(archive.records, archive.records + n, query.from, by_time)
+                                - archive.records);
+    uint32_t last = (uint32_t)(std::lower_bound(archive.records, archive.records + n, query.to, by_time)
+                               - archive.records);
+
+    // Walk the smallest candidate list, check the other filters per record
+    const GDA_INDEX *lo = nullptr, *hi = nullptr;
+    auto narrow = [&](const GDA_INDEX *index, uint32_t key) {
+        auto range = key_range(index, n, key, first, last);
+        if (lo == nullptr || range.second - range.first < hi - lo) {
+            lo = range.first;
+            hi = range.second;
+        }
+    };
+    if (query.has_action) narrow(archive.by_action, query.action);
+    if (query.has_source) narrow(archive.by_source, query.source);
+    if (query.has_valid) narrow(archive.by_valid, query.valid);
+
+    uint64_t matched = 0;
+    auto visit = [&](uint32_t i) {
+        if (!query.matches(archive.records[i])) return;
+        matched++;
+        if (!query.count) print_record(archive, query, i);
+    };
+    if (lo != nullptr) {
+        for (const GDA_INDEX *e = lo; e < hi; e++) visit(e->record);
+    } else {
+        for (uint32_t i = first; i < last; i++) visit(i);
+    }
+    if (query.count) printf("%" PRIu64 "\n", matched);
+    return 0;
+}
+
+static int cmd_info(int argc, char **argv) {
+    if (argc < 1) {
+        fprintf(stderr, "info needs an archive\n");
+        return 2;
+    }
+    ARCHIVE archive;
+    if (!map_archive(argv[0], archive)) return 1;
+    const GDA_HEADER &h = *archive.header;
+    uint64_t valid = 0, from_json = 0, with_counts = 0;
+    for (uint64_t i = 0; i < h.records; i++) {
+        const GDA_RECORD &rec = archive.records[i];
+        valid += (rec.flags & GDA_FLAG_VALID) != 0;
+        from_json += (rec.flags & GDA_FLAG_FROM_JSON) != 0;
+        with_counts += rec.counts_len > 0;
+    }
+    printf("Archive:  %s, %zu bytes\n", argv[0], archive.size);
+    printf("Records:  %" PRIu64 " (%" PRIu64 " valid, %" PRIu64 " with pulse counts, %" PRIu64 " from JSON)\n",
+           h.records, valid, with_counts, from_json);
+    if (h.first_us <= h.last_us) {
+        char from[40], to[40];
+        format_time(h.first_us, from, sizeof(from));
+        format_time(h.last_us, to, sizeof(to));
+        printf("Time:     %s .. %s\n", from, to);
+    }
+    printf("Files:    %" PRIu32 "\n", h.files);
+    for (const char *name : archive.files) printf("  %s\n", name);
+    return 0;
+}
+
+// ---------------------------------------------------------------------------
+// bench
+// ---------------------------------------------------------------------------
+
+/*
+ * Synthetic pulse trains: a start bit of 55-100 counts, then words of 8 data
+ * bits (LSB first) and the odd parity bit, the last word the CRC sum; 1 bits
+ * shorter than the threshold, 0 bits longer, now and then right on it.
+ * Some trains get leading noise, short pulses in between, a flipped bit, a
+ * wrong CRC or are cut short; some are pure noise or empty. With extreme
+ * set, lengths run up to (and claim beyond) CAPACITY::counts.
+ */
+static uint32_t bench_rand(uint32_t &state) {
+    state ^= state << 13;
+    state ^= state >> 17;
+    state ^= state << 5;
+    return state;
+}
+
+static uint16_t bench_train(uint32_t &rng, bool extreme, uint8_t *counts, uint16_t *claimed) {
+    const uint16_t cap = GDOOR_DATA::CAPACITY::counts;
+    uint16_t n = 0;
+    uint32_t kind = bench_rand(rng) % 16;
+    *claimed = 0;
+    if (kind == 0) {
+        return 0;
+    }
+    if (kind == 1) { // noise
+        n = (uint16_t)(bench_rand(rng) % (extreme ? cap : 60));
+        for (uint16_t i = 0; i < n; i++) counts[i] = (uint8_t)bench_rand(rng);
+        *claimed = n;
+        return n;
+    }
+    uint16_t max_words = extreme ? MAX_WORDLEN : std::min(12, MAX_WORDLEN);
+    uint16_t words = (uint16_t)(1 + bench_rand(rng) % max_words);
+    uint8_t data[MAX_WORDLEN];
+    for (uint16_t w = 0; w + 1 < words; w++) data[w] = (uint8_t)bench_rand(rng);
+    data[words - 1] = GDOOR_UTILS::crc(data, (uint16_t)(words - 1));
+    if (kind == 2) data[words - 1] ^= (uint8_t)(1 + bench_rand(rng) % 255);
+
+    auto put = [&](uint8_t cnt) {
+        if (n < cap) counts[n++] = cnt;
+    };
+    for (uint32_t k = bench_rand(rng) % 4; k > 0; k--) put((uint8_t)(bench_rand(rng) % BIT_MIN_LEN));
+    for (uint32_t k = bench_rand(rng) % 3; k > 0; k--) {
+        put((uint8_t)(BIT_MIN_LEN + bench_rand(rng) % (STARTBIT_MIN_LEN - BIT_MIN_LEN)));
+    }
+    uint8_t start = (uint8_t)(55 + bench_rand(rng) % 46);
+    uint16_t thres = (uint16_t)(2 * start / 5);
+    put(start);
+    for (uint16_t w = 0; w < words; w++) {
+        uint16_t word = (uint16_t)(data[w] | GDOOR_UTILS::parity_odd(data[w]) << 8);
+        for (uint8_t b = 0; b < 9; b++) {
+            bool one = (word >> b) & 1;
+            if (kind == 3 && bench_rand(rng) % 64 == 0) one = !one;
+            uint32_t r = bench_rand(rng);
+            uint16_t cnt;
+            if (r % 97 == 0) {
+                cnt = thres; // on the threshold, a 0 with margin 0
+            } else if (one) {
+                cnt = (uint16_t)(BIT_MIN_LEN + (r >> 8) % (thres - BIT_MIN_LEN));
+            } else {
+                cnt = (uint16_t)(thres + 1 + (r >> 8) % thres);
+            }
+            put((uint8_t)std::min<uint16_t>(cnt, 255));
+            if (r % 89 == 0) put((uint8_t)((r >> 16) % BIT_MIN_LEN));
+        }
+    }
+    if (kind == 4 && n > 0) n = (uint16_t)(bench_rand(rng) % n); // cut short
+    *claimed = n;
+    if (extreme && kind == 5) {
+        while (n < cap) counts[n++] = (uint8_t)bench_rand(rng);
+        *claimed = (uint16_t)(cap + bench_rand(rng) % 100); // beyond capacity, clamped
+    }
+    return n;
+}
+
+// Corpus as the importer hands it to GDOOR_DATA_BATCH: blocks of
+// SNIFF_BATCH trains, count i of train f of a block at soa[off + i * n + f]
+struct BENCH_BLOCK {
+    size_t off;
+    size_t first;
+    size_t n;
+};
+
+struct BENCH_CORPUS {
+    size_t frames = 0;
+    uint16_t rows = 0;            // longest train
+    std::vector<BENCH_BLOCK> blocks;
+    std::vector<uint8_t> soa;
+    std::vector<uint8_t> aos;     // train f at aos[f * CAPACITY::counts], for parse()
+    std::vector<uint16_t> lens;
+};
+
+static void bench_corpus(BENCH_CORPUS &corpus, size_t frames, bool extreme, uint32_t seed) {
+    const uint16_t cap = GDOOR_DATA::CAPACITY::counts;
+    corpus.frames = frames;
+    corpus.rows = 0;
+    corpus.blocks.clear();
+    corpus.soa.clear();
+    corpus.aos.assign(frames * cap, 0);
+    corpus.lens.resize(frames);
+    for (size_t first = 0; first < frames; first += SNIFF_BATCH) {
+        BENCH_BLOCK block = {corpus.soa.size(), first, std::min(SNIFF_BATCH, frames - first)};
+        uint16_t rows = 0;
+        for (size_t f = first; f < first + block.n; f++) {
+            rows = std::max(rows, bench_train(seed, extreme, &corpus.aos[f * cap], &corpus.lens[f]));
+        }
+        corpus.soa.resize(block.off + (size_t)rows * block.n);
+        for (size_t f = 0; f < block.n; f++) {
+            for (uint16_t i = 0; i < rows; i++) {
+                corpus.soa[block.off + (size_t)i * block.n + f] = corpus.aos[(first + f) * cap + i];
+            }
+        }
+        corpus.blocks.push_back(block);
+        corpus.rows = std::max(corpus.rows, rows);
+    }
+}
+
+static void bench_batch(const BENCH_CORPUS &corpus, GDOOR_DATA *out, bool *parsed, GDOOR_DATA_BATCH::ISA isa) {
+    for (const BENCH_BLOCK &block : corpus.blocks) {
+        GDOOR_DATA_BATCH::parse(&corpus.soa[block.off], block.n, &corpus.lens[block.first], block.n,
+                                out + block.first, parsed + block.first, isa);
+    }
+}
+
+static bool bench_same(const GDOOR_DATA &a, bool a_parsed, const GDOOR_DATA &b, bool b_parsed) {
+    return a_parsed == b_parsed && a.len == b.len && a.valid == b.valid && a.margin == b.margin
+        && a.parity_errors == b.parity_errors && a.crc_error == b.crc_error
+        && a.filtered_pulses == b.filtered_pulses && a.startbits_rejected == b.startbits_rejected
+        && memcmp(a.data, b.data, sizeof(a.data)) == 0
+        && a.raw_len == b.raw_len && memcmp(a.raw, b.raw, a.raw_len) == 0;
+}
+
+// Every ISA against parse() on its own copy of the counts; false on a mismatch
+static bool bench_verify(const BENCH_CORPUS &corpus) {
+    const uint16_t cap = GDOOR_DATA::CAPACITY::counts;
+    std::vector<GDOOR_DATA> expect(corpus.frames), got(corpus.frames);
+    std::unique_ptr<bool[]> expect_parsed(new bool[corpus.frames]), got_parsed(new bool[corpus.frames]);
+    for (size_t f = 0; f < corpus.frames; f++) {
+        expect_parsed[f] = expect[f].parse(&corpus.aos[f * cap], corpus.lens[f]);
+    }
+    for (int isa = GDOOR_DATA_BATCH::ISA_SCALAR; isa <= GDOOR_DATA_BATCH::best_isa(); isa++) {
+        std::fill(got.begin(), got.end(), GDOOR_DATA{});
+        bench_batch(corpus, got.data(), got_parsed.get(), (GDOOR_DATA_BATCH::ISA)isa);
+        for (size_t f = 0; f < corpus.frames; f++) {
+            if (!bench_same(expect[f], expect_parsed[f], got[f], got_parsed[f])) {
+                fprintf(stderr, "%s: train %zu differs from parse()\n",
+                        GDOOR_DATA_BATCH::isa_name((GDOOR_DATA_BATCH::ISA)isa), f);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Frames per second of fn(), run over the corpus for about half a second
+template<typename FN>
+static double bench_rate(size_t frames, FN fn) {
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    size_t done = 0;
+    double elapsed;
+    do {
+        fn();
+        done += frames;
+        clock_gettime(CLOCK_MONOTONIC, &t1);
+        elapsed = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+    } while (elapsed < 0.5);
+    return (double)done / elapsed;
+}
+
+/*
+ * Decoded frames for the JSON benches: 1-13 bytes, mostly with a correct CRC,
+ * bus codes from the lookup tables or unknown, and pulse counts for raw.
+ */
+static void bench_frame(uint32_t &rng, GDOOR_DATA &frame) {
+    static std::vector<uint8_t> actions, types;
+    if (actions.empty()) {
+        for (auto &a : GDOOR_DATA_ACTION) actions.push_back((uint8_t)a.first);
+        for (auto &t : GDOOR_DATA_HWTYPE) types.push_back((uint8_t)t.first);
+    }
+    frame = GDOOR_DATA{};
+    frame.len = (uint16_t)(1 + bench_rand(rng) % 13);
+    for (uint16_t i = 0; i < frame.len; i++) frame.data[i] = (uint8_t)bench_rand(rng);
+    if (frame.len > 2 && bench_rand(rng) % 4 != 0) frame.data[2] = actions[bench_rand(rng) % actions.size()];
+    if (frame.len > 8 && bench_rand(rng) % 4 != 0) frame.data[8] = types[bench_rand(rng) % types.size()];
+    if (bench_rand(rng) % 8 != 0) frame.data[frame.len - 1] = GDOOR_UTILS::crc(frame.data, frame.len - 1);
+    frame.valid = GDOOR_UTILS::crc(frame.data, frame.len - 1) == frame.data[frame.len - 1];
+    frame.raw_len = (uint16_t)(frame.len * 9 + 1);
+    for (uint16_t i = 0; i < frame.raw_len; i++) frame.raw[i] = (uint8_t)bench_rand(rng);
+}
+
+/*
+ * Frames the JSON benches time: the device renders one frame at a time, and
+ * a host frame (max_words 128, raw counts) is over 1 KB, so timing the whole
+ * corpus would mostly measure memory bandwidth
+ */
+static const size_t BENCH_HOT = 1024;
+
+// Print into a fixed buffer one byte per call, like PrintToBuffer did
+struct BENCH_PRINT : public Print {
+    char buf[4096];
+    size_t n = 0;
+    size_t write(uint8_t c) override {
+        if (n < sizeof(buf)) buf[n++] = (char)c;
+        return 1;
+    }
+};
+
+/*
+ * The JSON messages as printTo() streamed them before json_length() and
+ * write_json(): field by field through the GDOOR_UTILS Print helpers.
+ */
+static void bench_json_reference(const GDOOR_DATA_PROTOCOL &p, Print &out) {
+    GDOOR_UTILS::print_json_string(out, "action", p.action);
+    out.print(", ");
+    GDOOR_UTILS::print_json_hexstring<uint8_t>(out, "parameters", p.parameters, 2);
+    out.print(", ");
+    GDOOR_UTILS::print_json_hexstring<uint8_t>(out, "source", p.source, 3);
+    out.print(", ");
+    GDOOR_UTILS::print_json_hexstring<uint8_t>(out, "destination", p.destination, 3);
+    out.print(", ");
+    GDOOR_UTILS::print_json_string(out, "type", p.type);
+    out.print(", ");
+    if (p.raw != NULL) {
+        GDOOR_UTILS::print_json_hexstring<uint8_t>(out, "busdata", p.raw->data, p.raw->len);
+        out.print(", ");
+    }
+    GDOOR_UTILS::print_json_value<uint32_t>(out, "event_id", p.event_id);
+}
+
+static void bench_json_reference(const GDOOR_DATA &d, Print &out) {
+    GDOOR_UTILS::print_json_hexstring<uint8_t>(out, "busdata", d.data, d.len);
+    out.print(", ");
+    GDOOR_UTILS::print_json_hexarray<uint8_t>(out, "raw", d.raw, d.len * 9);
+    out.print(", ");
+    GDOOR_UTILS::print_json_bool<uint8_t>(out, "valid", d.valid);
+}
+
+// write_json() of x equals the reference and json_length() its length
+template<typename T>
+static bool bench_json_same(const T &x, size_t length, char *end, const char *buf) {
+    BENCH_PRINT expect;
+    bench_json_reference(x, expect);
+    return length == (size_t)(end - buf) && length == expect.n && memcmp(buf, expect.buf, length) == 0;
+}
+
+static int cmd_bench_json(int argc, char **argv) {
+    size_t frames = argc >= 1 ? (size_t)strtoul(argv[0], nullptr, 10) : 65536;
+    if (frames == 0) {
+        fprintf(stderr, "bench needs a frame count above 0\n");
+        return 2;
+    }
+    std::vector<GDOOR_DATA> corpus(frames);
+    uint32_t rng = 0x6A09E667u;
+    for (GDOOR_DATA &frame : corpus) bench_frame(rng, frame);
+
+    char buf[4096];
+    for (size_t f = 0; f < frames; f++) {
+        GDOOR_DATA_PROTOCOL p(&corpus[f]);
+        if (!bench_json_same(p, p.json_length(), p.write_json(buf), buf)
+            || !bench_json_same(corpus[f], corpus[f].json_length(), corpus[f].write_json(buf), buf)) {
+            fprintf(stderr, "frame %zu: write_json() differs from the Print helpers\n", f);
+            return 1;
+        }
+    }
+    GDOOR_DATA_PROTOCOL idle(nullptr, true);
+    if (!bench_json_same(idle, idle.json_length(), idle.write_json(buf), buf)) {
+        fprintf(stderr, "BUS_IDLE: write_json() differs from the Print helpers\n");
+        return 1;
+    }
+    size_t hot = std::min(frames, BENCH_HOT);
+    printf("%zu frames of 1-13 bytes, write_json() equal to the Print helpers; %zu timed, one thread:\n", frames,
+           hot);
+
+    volatile size_t sink = 0;
+    BENCH_PRINT out;
+    auto row = [&](const char *name, double rate) { printf("  %-30s %8.1f ns/frame\n", name, 1e9 / rate); };
+    row("protocol, Print helpers", bench_rate(hot, [&]() {
+        for (size_t f = 0; f < hot; f++) {
+            GDOOR_DATA_PROTOCOL p(&corpus[f]);
+            out.n = 0;
+            bench_json_reference(p, out);
+            sink = sink + out.n;
+        }
+    }));
+    row("protocol, write_json()", bench_rate(hot, [&]() {
+        for (size_t f = 0; f < hot; f++) {
+            GDOOR_DATA_PROTOCOL p(&corpus[f]);
+            if (p.json_length() <= sizeof(buf)) sink = sink + (size_t)(p.write_json(buf) - buf);
+        }
+    }));
+    row("frame + raw, Print helpers", bench_rate(hot, [&]() {
+        for (size_t f = 0; f < hot; f++) {
+            out.n = 0;
+            bench_json_reference(corpus[f], out);
+            sink = sink + out.n;
+        }
+    }));
+    row("frame + raw, write_json()", bench_rate(hot, [&]() {
+        for (size_t f = 0; f < hot; f++) {
+            if (corpus[f].json_length() <= sizeof(buf)) sink = sink + (size_t)(corpus[f].write_json(buf) - buf);
+        }
+    }));
+    return 0;
+}
+
+static uint32_t bench_address(const uint8_t *a) {
+    return (uint32_t)a[0] << 16 | a[1] << 8 | a[2];
+}
+
+// The view decodes like GDOOR_DATA_PROTOCOL and renders the same JSON
+static bool bench_view_same(GDOOR_DATA *frame) {
+    GDOOR_DATA_PROTOCOL p(frame);
+    GDOOR_DATA_VIEW v(frame);
+    char expect[4096], got[4096];
+    size_t n = p.json_length();
+    if (strcmp(p.action, v.action()) != 0 || strcmp(p.type, v.type()) != 0
+        || bench_address(p.source) != v.source() || bench_address(p.destination) != v.destination()
+        || (uint16_t)(p.parameters[0] << 8 | p.parameters[1]) != v.parameters()
+        || n > sizeof(expect) || v.json_length(p.event_id) != n) {
+        return false;
+    }
+    p.write_json(expect);
+    return v.write_json(got, p.event_id) == got + n && memcmp(expect, got, n) == 0;
+}
+
+static int cmd_bench_view(int argc, char **argv) {
+    size_t frames = argc >= 1 ? (size_t)strtoul(argv[0], nullptr, 10) : 65536;
+    if (frames == 0) {
+        fprintf(stderr, "bench needs a frame count above 0\n");
+        return 2;
+    }
+    std::vector<GDOOR_DATA> corpus(frames);
+    uint32_t rng = 0x3C6EF372u;
+    for (GDOOR_DATA &frame : corpus) bench_frame(rng, frame);
+    for (size_t f = 0; f < frames; f++) {
+        if (!bench_view_same(&corpus[f])) {
+            fprintf(stderr, "frame %zu: GDOOR_DATA_VIEW differs from GDOOR_DATA_PROTOCOL\n", f);
+            return 1;
+        }
+    }
+    size_t hot = std::min(frames, BENCH_HOT);
+    std::vector<GDOOR_DATA> timed(corpus.begin(), corpus.begin() + hot);
+    printf("%zu frames of 1-13 bytes, view fields and JSON equal to GDOOR_DATA_PROTOCOL; %zu timed, one thread:\n",
+           frames, hot);
+
+    volatile uintptr_t sink = 0;
+    char buf[4096];
+    auto row = [&](const char *name, double rate) { printf("  %-36s %8.1f ns/frame\n", name, 1e9 / rate); };
+    row("PROTOCOL ctor", bench_rate(hot, [&]() {
+        for (GDOOR_DATA &frame : timed) {
+            GDOOR_DATA_PROTOCOL p(&frame);
+            sink = sink + p.source[0];
+        }
+    }));
+    row("view, raw bytes / addresses", bench_rate(hot, [&]() {
+        for (GDOOR_DATA &frame : timed) {
+            GDOOR_DATA_VIEW v(&frame);
+            sink = sink + v.len() + v.data()[0] + v.source() + v.destination();
+        }
+    }));
+    // What a per-frame consumer such as GDoorFrame::from reads
+    row("PROTOCOL ctor + all fields", bench_rate(hot, [&]() {
+        for (GDOOR_DATA &frame : timed) {
+            GDOOR_DATA_PROTOCOL p(&frame);
+            sink = sink + (uintptr_t)p.action + (uintptr_t)p.type + bench_address(p.source)
+                 + bench_address(p.destination) + p.parameters[0];
+        }
+    }));
+    row("view, all fields", bench_rate(hot, [&]() {
+        for (GDOOR_DATA &frame : timed) {
+            GDOOR_DATA_VIEW v(&frame);
+            sink = sink + (uintptr_t)v.action() + (uintptr_t)v.type() + v.source() + v.destination()
+                 + v.parameters();
+        }
+    }));
+    row("PROTOCOL ctor + JSON", bench_rate(hot, [&]() {
+        for (GDOOR_DATA &frame : timed) {
+            GDOOR_DATA_PROTOCOL p(&frame);
+            if (p.json_length() <= sizeof(buf)) sink = sink + (uintptr_t)(p.write_json(buf) - buf);
+        }
+    }));
+    row("view JSON", bench_rate(hot, [&]() {
+        for (GDOOR_DATA &frame : timed) {
+            GDOOR_DATA_VIEW v(&frame);
+            uint32_t event_id = GDOOR_DATA_VIEW::next_event_id();
+            if (v.json_length(event_id) <= sizeof(buf)) sink = sink + (uintptr_t)(v.write_json(buf, event_id) - buf);
+        }
+    }));
+    return 0;
+}
+
+// Device registry with its table open for probe statistics
+struct BENCH_REGISTRY : public esphome::gdoor_esphome::GDoorDeviceRegistry {
+    // Probes a lookup of each device takes: its distance from the home slot + 1
+    void probes(double *mean, uint16_t *max) const {
+        uint32_t sum = 0;
+        *max = 0;
+        for (uint16_t i = 0; i < CAPACITY; i++) {
+            if (this->slots_[i].address == 0) continue;
+            uint16_t n = (uint16_t)(((i - slot_(this->slots_[i].address)) & (CAPACITY - 1)) + 1);
+            sum += n;
+            *max = std::max(*max, n);
+        }
+        *mean = this->count_ > 0 ? (double)sum / this->count_ : 0;
+    }
+};
+
+// Valid frame from source (announcing type) to destination, 0 for none
+static void bench_device_frame(GDOOR_DATA &frame, uint32_t source, uint8_t type, uint32_t destination) {
+    frame = GDOOR_DATA{};
+    frame.len = destination != 0 ? 13 : 10;
+    frame.data[0] = 0x01;
+    frame.data[2] = 0x11;
+    for (int i = 0; i < 3; i++) {
+        frame.data[3 + i] = (uint8_t)(source >> (16 - 8 * i));
+        frame.data[9 + i] = (uint8_t)(destination >> (16 - 8 * i));
+    }
+    frame.data[8] = type;
+    frame.data[frame.len - 1] = GDOOR_UTILS::crc(frame.data, frame.len - 1);
+    frame.valid = 1;
+}
+
+/*
+ * Addresses as in an installation: a few blocks of nearby addresses (stations
+ * of one series), unique and non-zero
+ */
+static std::vector<uint32_t> bench_addresses(uint32_t &rng, size_t n) {
+    std::vector<uint32_t> out;
+    uint32_t base = 0;
+    while (out.size() < n) {
+        if (out.size() % 32 == 0) base = (bench_rand(rng) & 0xFFF000) | 0x800000;
+        uint32_t address = base + bench_rand(rng) % 0x1000;
+        if (std::find(out.begin(), out.end(), address) == out.end()) out.push_back(address);
+    }
+    return out;
+}
+
+static int cmd_bench_registry() {
+    typedef esphome::gdoor_esphome::GDoorDeviceRegistry REGISTRY;
+    uint32_t rng = 0xBB67AE85u;
+    std::vector<uint32_t> all = bench_addresses(rng, REGISTRY::MAX_DEVICES + 1 + 1024);
+    std::vector<uint32_t> misses(all.begin() + REGISTRY::MAX_DEVICES + 1, all.end());
+    const uint8_t types[] = {0x01, 0x02, 0x10, 0x11, 0x20};
+    printf("Clustered addresses in %u slots, every device found with its type, device %u rejected; one thread:\n",
+           REGISTRY::CAPACITY, REGISTRY::MAX_DEVICES + 1);
+    printf("  %7s %11s %10s %12s %12s %12s\n", "devices", "mean probes", "max probes", "hit", "miss", "on_frame");
+    const size_t loads[] = {50, 100, 150, REGISTRY::MAX_DEVICES};
+    for (size_t n : loads) {
+        BENCH_REGISTRY registry;
+        registry.setup(0);
+        GDOOR_DATA frame;
+        for (size_t i = 0; i < n; i++) {
+            bench_device_frame(frame, all[i], types[i % sizeof(types)], 0);
+            registry.on_frame(GDOOR_DATA_VIEW(&frame), 1);
+        }
+        bool ok = registry.size() == n;
+        for (size_t i = 0; ok && i < n; i++) {
+            const REGISTRY::Device *device = registry.find(all[i]);
+            ok = device != nullptr && device->type == types[i % sizeof(types)];
+        }
+        for (size_t i = 0; ok && i < misses.size(); i++) ok = registry.find(misses[i]) == nullptr;
+        if (ok && n == REGISTRY::MAX_DEVICES) {
+            bench_device_frame(frame, all[n], types[0], 0);
+            ok = !registry.on_frame(GDOOR_DATA_VIEW(&frame), 1) && registry.size() == n
+              && registry.find(all[n]) == nullptr;
+        }
+        if (!ok) {
+            fprintf(stderr, "registry with %zu devices lost or misplaced one\n", n);
+            return 1;
+        }
+        double mean;
+        uint16_t max;
+        registry.probes(&mean, &max);
+
+        // Frames between known devices, as on the bus once everything is learned
+        std::vector<GDOOR_DATA> traffic(4096);
+        for (size_t i = 0; i < traffic.size(); i++) {
+            size_t from = bench_rand(rng) % n;
+            bench_device_frame(traffic[i], all[from], types[from % sizeof(types)], all[bench_rand(rng) % n]);
+        }
+        volatile uintptr_t sink = 0;
+        double hit = bench_rate(n, [&]() {
+            for (size_t i = 0; i < n; i++) sink = sink + (uintptr_t)registry.find(all[i]);
+        });
+        double miss = bench_rate(misses.size(), [&]() {
+            for (uint32_t address : misses) sink = sink + (uintptr_t)registry.find(address);
+        });
+        double learn = bench_rate(traffic.size(), [&]() {
+            for (const GDOOR_DATA &f : traffic) sink = sink + registry.on_frame(GDOOR_DATA_VIEW(&f), 2);
+        });
+        printf("  %7zu %11.2f %10u %9.1f ns %9.1f ns %9.1f ns\n", n, mean, max, 1e9 / hit, 1e9 / miss, 1e9 / learn);
+    }
+    return 0;
+}
+
+static int cmd_bench(int argc, char **argv) {
+    if (argc >= 1 && strcmp(argv[0], "json") == 0) return cmd_bench_json(argc - 1, argv + 1);
+    if (argc >= 1 && strcmp(argv[0], "registry") == 0) return cmd_bench_registry();
+    if (argc >= 1 && strcmp(argv[0], "view") == 0) return cmd_bench_view(argc - 1, argv + 1);
+    size_t frames = argc >= 1 ? (size_t)strtoul(argv[0], nullptr, 10) : 65536;
+    if (frames == 0) {
+        fprintf(stderr, "bench needs a frame count above 0\n");
+        return 2;
+    }
+    const uint16_t cap = GDOOR_DATA::CAPACITY::counts;
+    BENCH_CORPUS corpus;
+    // Corner cases first: long and over-long trains, lengths up to capacity
+    bench_corpus(corpus, 4096, true, 0x9E3779B9u);
+    bool ok = bench_verify(corpus);
+    bench_corpus(corpus, frames, false, 0x2545F491u);
+    ok = ok && bench_verify(corpus);
+    if (!ok) return 1;
+    printf("%zu trains of up to %u counts, every ISA equal to parse(); one thread:\n", frames, corpus.rows);
+
+    // Results go to one block of frames, reused like the importer does
+    std::vector<GDOOR_DATA> out(SNIFF_BATCH);
+    bool parsed[SNIFF_BATCH];
+    double rate = bench_rate(frames, [&]() {
+        for (size_t f = 0; f < frames; f++) {
+            parsed[f % SNIFF_BATCH] = out[f % SNIFF_BATCH].parse(&corpus.aos[f * cap], corpus.lens[f]);
+        }
+    });
+    printf("  %-16s %12.0f frames/s\n", "parse()", rate);
+    for (int isa = GDOOR_DATA_BATCH::ISA_SCALAR; isa <= GDOOR_DATA_BATCH::best_isa(); isa++) {
+        rate = bench_rate(frames, [&]() {
+            for (const BENCH_BLOCK &block : corpus.blocks) {
+                GDOOR_DATA_BATCH::parse(&corpus.soa[block.off], block.n, &corpus.lens[block.first], block.n,
+                                        out.data(), parsed, (GDOOR_DATA_BATCH::ISA)isa);
+            }
+        });
+        char name[32];
+        snprintf(name, sizeof(name), "batch %s", GDOOR_DATA_BATCH::isa_name((GDOOR_DATA_BATCH::ISA)isa));
+        printf("  %-16s %12.0f frames/s\n", name, rate);
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2 && strcmp(argv[1], "build") == 0) return cmd_build(argc - 2, argv + 2);
+    if (argc >= 2 && strcmp(argv[1], "query") == 0) return cmd_query(argc - 2, argv + 2);
+    if (argc >= 2 && strcmp(argv[1], "info") == 0) return cmd_info(argc - 2, argv + 2);
+    if (argc >= 2 && strcmp(argv[1], "bench") == 0) return cmd_bench(argc - 2, argv + 2);
+    fprintf(stderr,
+            "usage: gdoor_archive build [-j N] [--append] OUT.gda INPUT...\n"
+            "       gdoor_archive query ARCHIVE [--from T] [--to T] [--action NAME|HEX] [--source HEX]\n"
+            "                           [--valid | --invalid] [--json | --count] [--counts]\n"
+            "       gdoor_archive info ARCHIVE\n"
+            "       gdoor_archive bench [json | view] [FRAMES]\n"
+            "       gdoor_archive bench registry\n"
+            "T is 2024-05-01T12:00:00[.fff][Z] (local time without Z) or unix seconds\n");
+    return 2;
+}
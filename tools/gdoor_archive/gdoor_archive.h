@@ -0,0 +1,87 @@
+/*
+ * This file is part of the GDoor distribution (https://github.com/gdoor-org).
+ * Copyright (c) 2024 GDoor authors.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * On-disk layout of a gdoor_archive file. It is written once and then only
+ * memory-mapped, so every section is a flat array in host byte order
+ * (little-endian on x86-64 and aarch64):
+ *
+ *   GDA_HEADER
+ *   file names   '\0'-terminated, header.files of them
+ *   records      GDA_RECORD[header.records], sorted by time
+ *   by_action    GDA_INDEX[header.records], sorted by (key, record)
+ *   by_source    GDA_INDEX[header.records]
+ *   by_valid     GDA_INDEX[header.records]
+ *   blob         per record its frame bytes, then its pulse counts
+ *
+ * A time range is a binary search on the records; action, source and
+ * validity are equal_range() on their index, and since each key's records
+ * are in time order, the time range narrows that again by binary search.
+ * Nothing is rescanned.
+ */
+#ifndef GDOOR_ARCHIVE_H
+#define GDOOR_ARCHIVE_H
+#include <stdint.h>
+
+#define GDA_MAGIC "GDARCH\x00\x01"
+#define GDA_VERSION 1
+
+enum GDA_FLAG : uint8_t {
+    GDA_FLAG_VALID        = 0x01,
+    GDA_FLAG_CRC_ERROR    = 0x02,
+    GDA_FLAG_PARITY_ERROR = 0x04,
+    GDA_FLAG_PARSED       = 0x08, // decoded to at least one word
+    GDA_FLAG_FROM_JSON    = 0x10, // frame bytes from a JSON log, no pulse counts
+    GDA_FLAG_NO_TIME      = 0x20, // source had no usable timestamp, time_us is 0
+};
+
+struct GDA_HEADER {
+    char magic[8];
+    uint32_t version;
+    uint32_t files;
+    uint64_t records;
+    uint64_t names_off;
+    uint64_t records_off;
+    uint64_t by_action_off;
+    uint64_t by_source_off;
+    uint64_t by_valid_off;
+    uint64_t blob_off;
+    uint64_t blob_len;
+    int64_t first_us; // unix time of the first / last timed record
+    int64_t last_us;
+};
+
+struct GDA_RECORD {
+    int64_t time_us;      // unix time of the last carrier edge, µs
+    uint64_t blob_off;    // frame bytes, then counts_len pulse counts
+    uint32_t source;      // 3-byte addresses, 0 if not decoded / absent
+    uint32_t destination;
+    uint16_t counts_len;
+    uint16_t file;        // index into the file names
+    uint8_t len;          // frame bytes incl. CRC, 0 if nothing decoded
+    uint8_t action;       // bus codes, only meaningful with GDA_FLAG_VALID
+    uint8_t type;
+    uint8_t flags;        // GDA_FLAG_*
+};
+static_assert(sizeof(GDA_RECORD) == 32, "GDA_RECORD is part of the file format");
+
+struct GDA_INDEX {
+    uint32_t key;
+    uint32_t record;
+};
+
+#endif
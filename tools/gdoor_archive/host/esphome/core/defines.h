@@ -0,0 +1,6 @@
+#pragma once
+// Host build of the gdoor decoder for tools/gdoor_archive: room for the
+// longest frame any device can be configured for (max_words), and the raw
+// counts member, which the archive keeps
+#define GDOOR_MAX_WORDLEN 128
+#define USE_GDOOR_RAW_CAPTURE
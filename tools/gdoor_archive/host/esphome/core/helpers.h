@@ -0,0 +1,16 @@
+#pragma once
+// Host stand-in for the ESPHome helpers the device registry uses
+#include <cstdint>
+
+namespace esphome {
+
+inline uint32_t fnv1_hash(const char *str) {
+  uint32_t hash = 2166136261UL;
+  for (; *str != '\0'; str++) {
+    hash *= 16777619UL;
+    hash ^= (uint8_t) *str;
+  }
+  return hash;
+}
+
+}  // namespace esphome
@@ -0,0 +1,9 @@
+#pragma once
+// Host stand-in for ESPHome logging: the benches stay quiet
+#define ESP_LOGE(tag, ...) ((void) (tag))
+#define ESP_LOGW(tag, ...) ((void) (tag))
+#define ESP_LOGI(tag, ...) ((void) (tag))
+#define ESP_LOGCONFIG(tag, ...) ((void) (tag))
+#define ESP_LOGD(tag, ...) ((void) (tag))
+#define ESP_LOGV(tag, ...) ((void) (tag))
+#define ESP_LOGVV(tag, ...) ((void) (tag))
@@ -0,0 +1,22 @@
+#pragma once
+// Host stand-in for ESPHome's preferences store, for the device registry in
+// gdoor_archive bench: nothing is restored and saves go nowhere
+#include <cstdint>
+
+namespace esphome {
+
+class ESPPreferenceObject {
+ public:
+  template<typename T> bool save(const T *) { return true; }
+  template<typename T> bool load(T *) { return false; }
+};
+
+class ESPPreferences {
+ public:
+  template<typename T> ESPPreferenceObject make_preference(uint32_t) { return {}; }
+};
+
+inline ESPPreferences host_preferences;
+inline ESPPreferences *global_preferences = &host_preferences;
+
+}  // namespace esphome
@@ -0,0 +1,289 @@
+/*
+ * This file is part of the GDoor distribution (https://github.com/gdoor-org).
+ * Copyright (c) 2024 GDoor authors.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, version 3.
+ *
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/*
+ * gdoor_log_host: runs the gdoor_log frame log on an image file
+ * (GDoorLogFileStorage) on Linux.
+ *
+ *   gdoor_log_host test           record, rotate and recovery cases
+ *   gdoor_log_host bench [RECORDS]
+ *
+ * Images go to a fresh directory under $TMPDIR (or /tmp) and are removed
+ * afterwards. See README.md.
+ */
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "gdoor_frame_log.h"
+#include "gdoor_log_storage.h"
+
+using esphome::gdoor_esphome::GDoorFrameLog;
+using esphome::gdoor_esphome::GDoorLogFileStorage;
+using esphome::gdoor_esphome::GDoorLogRecord;
+
+static const uint32_t SECTOR = 4096;
+static const uint16_t BATCH = 256; // gdoor_log batch_size default
+
+/*
+ * Image file whose n-th write from now programs only the first half of its
+ * bytes and fails: a batch torn by a power cut, or a flash write error when
+ * the log carries on.
+ */
+class FAULTY_STORAGE : public GDoorLogFileStorage {
+    public:
+        using GDoorLogFileStorage::GDoorLogFileStorage;
+        int fail_in = -1;
+
+        bool write(uint32_t offset, const void *buf, size_t len) override {
+            if (fail_in >= 0 && fail_in-- == 0) {
+                GDoorLogFileStorage::write(offset, buf, len / 2);
+                return false;
+            }
+            return GDoorLogFileStorage::write(offset, buf, len);
+        }
+};
+
+// Record i: 9-12 telegram bytes derived from i, timestamp i
+static uint8_t make_frame(uint32_t i, uint8_t *data) {
+    uint8_t len = (uint8_t)(9 + i % 4);
+    for (uint8_t b = 0; b < len; b++) data[b] = (uint8_t)(i * 31 + b * 7 + (i >> 8));
+    return len;
+}
+
+static bool append(GDoorFrameLog &log, uint32_t i) {
+    uint8_t data[16];
+    uint8_t len = make_frame(i, data);
+    return log.append(i, GDoorFrameLog::FLAG_VALID, data, len);
+}
+
+static void append_range(GDoorFrameLog &log, uint32_t first, uint32_t end) {
+    for (uint32_t i = first; i < end; i++) append(log, i);
+}
+
+// Timestamps of every record, oldest first; a record not matching its
+// timestamp's frame is reported as UINT32_MAX
+static std::vector<uint32_t> collect(GDoorFrameLog &log) {
+    std::vector<uint32_t> seen;
+    log.for_each([&](const GDoorLogRecord &r) {
+        uint8_t data[16];
+        uint8_t len = make_frame(r.timestamp, data);
+        bool same = r.len == len && r.flags == GDoorFrameLog::FLAG_VALID && memcmp(r.data, data, len) == 0;
+        seen.push_back(same ? r.timestamp : UINT32_MAX);
+    });
+    return seen;
+}
+
+// seen is one run per {first, end} range, in order
+static bool runs_are(const std::vector<uint32_t> &seen, std::initializer_list<std::pair<uint32_t, uint32_t>> runs) {
+    std::vector<uint32_t> expect;
+    for (auto &run : runs) {
+        for (uint32_t i = run.first; i < run.second; i++) expect.push_back(i);
+    }
+    return seen == expect;
+}
+
+// Length of the run first, first + 1, ... at the start of seen
+static uint32_t run_from(const std::vector<uint32_t> &seen, uint32_t first) {
+    uint32_t n = 0;
+    while (n < seen.size() && seen[n] == first + n) n++;
+    return n;
+}
+
+static std::string g_dir;
+static int g_image = 0;
+
+static std::string new_image() {
+    return g_dir + "/image" + std::to_string(g_image++) + ".bin";
+}
+
+static bool check(const char *name, bool ok, const std::vector<uint32_t> &seen) {
+    printf("  %-28s %s, %zu records\n", name, ok ? "ok" : "FAILED", seen.size());
+    return ok;
+}
+
+// Appended records are visible before and after flush() and a reopen
+static bool test_record() {
+    std::string path = new_image();
+    GDoorLogFileStorage storage(path, 16 * SECTOR);
+    GDoorFrameLog log(&storage, BATCH);
+    if (!log.begin()) return check("record", false, {});
+    append_range(log, 0, 1000);
+    bool ok = log.pending() > 0 && runs_are(collect(log), {{0, 1000}});
+    log.flush();
+
+    GDoorLogFileStorage again_storage(path, 16 * SECTOR);
+    GDoorFrameLog again(&again_storage, BATCH);
+    std::vector<uint32_t> seen = again.begin() ? collect(again) : std::vector<uint32_t>();
+    return check("record and reopen", ok && runs_are(seen, {{0, 1000}}), seen);
+}
+
+// Many times the capacity: the newest records survive, oldest sector first
+static bool test_rotate() {
+    std::string path = new_image();
+    const uint32_t total = 50000;
+    GDoorLogFileStorage storage(path, 16 * SECTOR);
+    GDoorFrameLog log(&storage, BATCH);
+    if (!log.begin()) return check("rotate", false, {});
+    append_range(log, 0, total);
+    log.flush();
+
+    GDoorLogFileStorage again_storage(path, 16 * SECTOR);
+    GDoorFrameLog again(&again_storage, BATCH);
+    std::vector<uint32_t> seen = again.begin() ? collect(again) : std::vector<uint32_t>();
+    // 14 full sectors at least, one is always erased ahead of the oldest
+    const uint32_t per_sector = (SECTOR - 8) / (6 + 12 + 1);
+    uint32_t first = seen.empty() ? 0 : seen.front();
+    bool ok = !seen.empty() && first > 0 && run_from(seen, first) == seen.size() && seen.back() == total - 1 &&
+              seen.size() >= 14 * per_sector && log.sector_erases() > total / (SECTOR / 12);
+    return check("rotate and reopen", ok, seen);
+}
+
+// A batch torn by a power cut ends its sector; the log resumes in the next
+// one and keeps everything programmed before the tear
+static bool test_torn() {
+    std::string path = new_image();
+    {
+        FAULTY_STORAGE storage(path, 16 * SECTOR);
+        GDoorFrameLog log(&storage, BATCH);
+        if (!log.begin()) return check("torn batch", false, {});
+        append_range(log, 0, 100);
+        log.flush();
+        storage.fail_in = 0;
+        append_range(log, 100, 110);
+        log.flush();
+        // Power cut: the log object is gone, nothing else reaches the flash
+    }
+    GDoorLogFileStorage storage(path, 16 * SECTOR);
+    GDoorFrameLog log(&storage, BATCH);
+    if (!log.begin()) return check("torn batch", false, {});
+    std::vector<uint32_t> seen = collect(log);
+    uint32_t kept = run_from(seen, 0);
+    bool ok = kept >= 100 && kept < 110 && kept == seen.size();
+    append_range(log, 200, 300);
+    log.flush();
+
+    GDoorLogFileStorage again_storage(path, 16 * SECTOR);
+    GDoorFrameLog again(&again_storage, BATCH);
+    seen = again.begin() ? collect(again) : std::vector<uint32_t>();
+    return check("torn batch and reopen", ok && runs_are(seen, {{0, kept}, {200, 300}}), seen);
+}
+
+// A failed batch write without a reset: later records stay visible, and a
+// reopen does not program over them
+static bool test_failed_write() {
+    std::string path = new_image();
+    FAULTY_STORAGE storage(path, 16 * SECTOR);
+    GDoorFrameLog log(&storage, BATCH);
+    if (!log.begin()) return check("failed write", false, {});
+    append_range(log, 0, 100);
+    log.flush();
+    storage.fail_in = 0;
+    append_range(log, 100, 110);
+    bool ok = !log.flush() && log.write_errors() == 1;
+    append_range(log, 200, 300);
+    log.flush();
+    std::vector<uint32_t> seen = collect(log);
+    uint32_t kept = run_from(seen, 0);
+    ok = ok && kept >= 100 && kept < 110 && runs_are(seen, {{0, kept}, {200, 300}});
+
+    GDoorLogFileStorage again_storage(path, 16 * SECTOR);
+    GDoorFrameLog again(&again_storage, BATCH);
+    if (!again.begin()) return check("failed write", false, {});
+    append_range(again, 300, 400);
+    again.flush();
+    GDoorLogFileStorage last_storage(path, 16 * SECTOR);
+    GDoorFrameLog last(&last_storage, BATCH);
+    seen = last.begin() ? collect(last) : std::vector<uint32_t>();
+    return check("failed write and reopen", ok && runs_are(seen, {{0, kept}, {200, 400}}), seen);
+}
+
+static int cmd_test() {
+    printf("gdoor_log on a %u-sector image, %u-byte batches:\n", 16, BATCH);
+    bool ok = test_record();
+    ok = test_rotate() && ok;
+    ok = test_torn() && ok;
+    ok = test_failed_write() && ok;
+    return ok ? 0 : 1;
+}
+
+static double seconds_since(const struct timespec &t0) {
+    struct timespec t1;
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    return (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+}
+
+static int cmd_bench(int argc, char **argv) {
+    uint32_t records = argc >= 1 ? (uint32_t)strtoul(argv[0], nullptr, 10) : 1000000;
+    if (records == 0) {
+        fprintf(stderr, "bench needs a record count above 0\n");
+        return 2;
+    }
+    // The default partition from the component README: 64 KB
+    GDoorLogFileStorage storage(new_image(), 16 * SECTOR);
+    GDoorFrameLog log(&storage, BATCH);
+    if (!log.begin()) {
+        fprintf(stderr, "cannot open the image in %s\n", g_dir.c_str());
+        return 1;
+    }
+    struct timespec t0;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    append_range(log, 0, records);
+    log.flush();
+    double append_s = seconds_since(t0);
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    std::vector<uint32_t> seen = collect(log);
+    double scan_s = seconds_since(t0);
+    if (seen.empty() || run_from(seen, seen.front()) != seen.size() || seen.back() != records - 1) {
+        fprintf(stderr, "log does not end in the newest records\n");
+        return 1;
+    }
+    printf("%" PRIu32 " records of 9-12 bytes, 64 KB image, %u-byte batches:\n", records, BATCH);
+    printf("  %-16s %12.0f records/s (%" PRIu32 " sector erases, %" PRIu32 " write errors)\n", "append",
+           records / append_s, log.sector_erases(), log.write_errors());
+    printf("  %-16s %12.0f records/s (%zu records kept)\n", "for_each", seen.size() / scan_s, seen.size());
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    bool test = argc >= 2 && strcmp(argv[1], "test") == 0;
+    bool bench = argc >= 2 && strcmp(argv[1], "bench") == 0;
+    if (!test && !bench) {
+        fprintf(stderr,
+                "usage: gdoor_log_host test\n"
+                "       gdoor_log_host bench [RECORDS]\n");
+        return 2;
+    }
+    const char *tmp = getenv("TMPDIR");
+    std::string pattern = std::string(tmp != nullptr && *tmp ? tmp : "/tmp") + "/gdoor_log.XXXXXX";
+    std::vector<char> dir(pattern.begin(), pattern.end());
+    dir.push_back('\0');
+    if (mkdtemp(dir.data()) == nullptr) {
+        perror(pattern.c_str());
+        return 1;
+    }
+    g_dir = dir.data();
+    int ret = test ? cmd_test() : cmd_bench(argc - 2, argv + 2);
+    for (int i = 0; i < g_image; i++) unlink((g_dir + "/image" + std::to_string(i) + ".bin").c_str());
+    rmdir(g_dir.c_str());
+    return ret;
+}
@@ -0,0 +1,3 @@
+#pragma once
+// Host build of gdoor_log for tools/gdoor_log_host: no USE_ESP32, so only
+// GDoorLogFileStorage is usable
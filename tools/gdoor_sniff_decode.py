@@ -0,0 +1,180 @@
+#!/usr/bin/env python3
+"""
+Decoder for the gdoor_sniffer binary record stream.
+
+Reads from a serial port (needs pyserial) or from a file / stdin, prints every
+record and reports gaps: lost records (seq jumps), pulse trains that never made
+it into a record (train number jumps) and bytes skipped to find the next sync:
+
+    gdoor_sniff_decode.py /dev/ttyACM0                  # USB Serial/JTAG
+    gdoor_sniff_decode.py /dev/ttyUSB0 --baud 921600    # UART
+    gdoor_sniff_decode.py capture.bin --gaps-only       # saved with --save
+
+Record layout (big-endian): A5 5A | u16 len | u8 type | u8 flags | u32 seq |
+u32 timestamp_us | payload | u8 sum, with len counting everything after the
+length field and sum the 8-bit sum of len through payload.
+"""
+import argparse
+import os
+import struct
+import sys
+
+SYNC = b"\xA5\x5A"
+HEADER = struct.Struct(">2sHBBII")
+TRAIN = struct.Struct(">IIBBHHH")
+STATUS = struct.Struct(">IIII")
+MAX_WORDS = 128  # largest max_words the gdoor bus accepts
+MIN_LEN = HEADER.size - 4 + 1  # type .. timestamp, sum
+# Full-length TRAIN: the start bit count, 9 counts and one data byte per word
+MAX_LEN = MIN_LEN + TRAIN.size + 1 + 10 * MAX_WORDS
+
+RECORD_TRAIN = 0x01
+RECORD_STATUS = 0x02
+
+FLAG_PARSED = 0x01
+FLAG_VALID = 0x02
+FLAG_CRC_ERROR = 0x04
+FLAG_PARITY_ERROR = 0x08
+
+
+class GapTracker:
+    """Follows seq and train numbers across records, counts what went missing."""
+
+    def __init__(self):
+        self.seq = None
+        self.train = None
+        self.records = 0
+        self.lost_records = 0
+        self.lost_trains = 0
+        self.skipped_bytes = 0
+        self.bad_sums = 0
+
+    def record(self, seq):
+        self.records += 1
+        gap = 0 if self.seq is None else (seq - self.seq - 1) & 0xFFFFFFFF
+        self.seq = seq
+        self.lost_records += gap
+        return gap
+
+    def train_seen(self, train):
+        gap = 0 if self.train is None else (train - self.train - 1) & 0xFFFFFFFF
+        self.train = train
+        self.lost_trains += gap
+        return gap
+
+    def summary(self):
+        return (f"{self.records} records, {self.lost_records} lost records, {self.lost_trains} trains not "
+                f"recorded, {self.bad_sums} bad sums, {self.skipped_bytes} bytes skipped")
+
+
+def parse_records(buf, gaps):
+    """Yield (type, flags, seq, timestamp, payload) for every complete record,
+    return the unconsumed tail through StopIteration.value."""
+    pos = 0
+    while True:
+        start = buf.find(SYNC, pos)
+        if start < 0:
+            keep = len(buf) - 1 if buf.endswith(SYNC[:1]) else len(buf)
+            gaps.skipped_bytes += keep - pos
+            return buf[keep:]
+        gaps.skipped_bytes += start - pos
+        pos = start
+        if len(buf) - pos < 4:
+            return buf[pos:]
+        (length,) = struct.unpack_from(">H", buf, pos + 2)
+        if not MIN_LEN <= length <= MAX_LEN:
+            gaps.skipped_bytes += 1
+            pos += 1  # not a record start, look for the next sync
+            continue
+        if len(buf) - pos < 4 + length:
+            return buf[pos:]
+        record = buf[pos:pos + 4 + length]
+        if sum(record[2:-1]) & 0xFF != record[-1]:
+            gaps.bad_sums += 1
+            gaps.skipped_bytes += 1
+            pos += 1
+            continue
+        _, _, rtype, flags, seq, timestamp = HEADER.unpack_from(record)
+        yield rtype, flags, seq, timestamp, bytes(record[HEADER.size:-1])
+        pos += 4 + length
+
+
+def format_train(flags, timestamp, payload):
+    start, train, margin, parity_errors, filtered, rejected, count_len = TRAIN.unpack_from(payload)
+    counts = payload[TRAIN.size:TRAIN.size + count_len]
+    data = payload[TRAIN.size + count_len:]
+    if not flags & FLAG_PARSED:
+        state = "undecoded"
+    else:
+        state = ",".join(name for bit, name in ((FLAG_VALID, "valid"), (FLAG_CRC_ERROR, "crc"),
+                                                (FLAG_PARITY_ERROR, "parity")) if flags & bit) or "invalid"
+    duration = (timestamp - start) & 0xFFFFFFFF
+    line = (f"{timestamp:10d} TRAIN #{train} {data.hex().upper() or '-'} {state} {duration}us "
+            f"margin={margin}% parity_errors={parity_errors} filtered={filtered} rejected={rejected}")
+    return train, line + f"\n{'':10s} counts {' '.join(str(c) for c in counts)}"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("source", nargs="?", default="-", help="serial port, file, or - for stdin")
+    parser.add_argument("--baud", type=int, default=921600, help="UART baud rate (ignored for USB)")
+    parser.add_argument("--save", metavar="FILE", help="also append the raw stream to FILE")
+    parser.add_argument("--gaps-only", action="store_true", help="only print gaps and status records")
+    args = parser.parse_args()
+
+    if args.source == "-":
+        stream = sys.stdin.buffer
+    elif args.source.startswith("/dev/") or args.source.upper().startswith("COM"):
+        import serial  # pyserial, only needed for live capture
+
+        stream = serial.Serial(args.source, args.baud, timeout=1)
+    else:
+        stream = open(args.source, "rb")
+    save = open(args.save, "ab") if args.save else None
+
+    gaps = GapTracker()
+    buf = b""
+    try:
+        while True:
+            chunk = stream.read(4096) if hasattr(stream, "in_waiting") else os.read(stream.fileno(), 4096)
+            if not chunk:
+                if hasattr(stream, "in_waiting"):
+                    continue  # serial read timed out, keep waiting
+                break
+            if save:
+                save.write(chunk)
+            records = parse_records(buf + chunk, gaps)
+            while True:
+                try:
+                    rtype, flags, seq, timestamp, payload = next(records)
+                except StopIteration as done:
+                    buf = done.value
+                    break
+                lost = gaps.record(seq)
+                if lost:
+                    print(f"{timestamp:10d} GAP   {lost} record(s) lost before seq {seq}", flush=True)
+                if rtype == RECORD_TRAIN:
+                    train, line = format_train(flags, timestamp, payload)
+                    missed = gaps.train_seen(train)
+                    if missed:
+                        print(f"{timestamp:10d} GAP   {missed} train(s) not recorded before #{train}", flush=True)
+                    if not args.gaps_only:
+                        print(line, flush=True)
+                elif rtype == RECORD_STATUS:
+                    trains, frames, overruns, dropped = STATUS.unpack_from(payload)
+                    print(f"{timestamp:10d} STATUS trains={trains} frames={frames} overruns={overruns} "
+                          f"dropped={dropped}", flush=True)
+                elif not args.gaps_only:
+                    print(f"{timestamp:10d} type 0x{rtype:02X} {payload.hex().upper()}", flush=True)
+    finally:
+        if save:
+            save.close()
+        print(gaps.summary(), file=sys.stderr)
+    return 1 if gaps.lost_records or gaps.lost_trains or gaps.bad_sums else 0
+
+
+if __name__ == "__main__":
+    try:
+        sys.exit(main())
+    except KeyboardInterrupt:
+        pass
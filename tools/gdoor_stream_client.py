@@ -0,0 +1,106 @@
+#!/usr/bin/env python3
+"""
+Minimal client for the gdoor_stream binary frame server.
+
+Prints every received record, one per line, and optionally sends a TX frame:
+
+    gdoor_stream_client.py 192.168.1.50                  # TCP, port 5555
+    gdoor_stream_client.py 192.168.1.50 --tx 011041A1B14A0000A18F1E
+    gdoor_stream_client.py --udp --listen 5555           # receive UDP batches
+
+Record layout (big-endian): u16 len | u8 type | u8 flags | u32 timestamp_us |
+payload, with len counting everything after the length field.
+"""
+import argparse
+import socket
+import struct
+import sys
+
+HEADER = struct.Struct(">HBBI")
+
+RECORD_FRAME = 0x01
+RECORD_RAW = 0x02
+RECORD_TX_RESULT = 0x03
+RECORD_TX = 0x10
+
+FLAG_VALID = 0x01
+FLAG_CRC_ERROR = 0x02
+FLAG_PARITY_ERROR = 0x04
+
+
+def tx_record(frame):
+    return HEADER.pack(HEADER.size - 2 + len(frame), RECORD_TX, 0, 0) + frame
+
+
+def parse_records(buf):
+    """Yield (type, flags, timestamp, payload) for every complete record,
+    return the unconsumed tail through StopIteration.value."""
+    pos = 0
+    while len(buf) - pos >= 2:
+        (length,) = struct.unpack_from(">H", buf, pos)
+        if len(buf) - pos < 2 + length:
+            break
+        _, rtype, flags, timestamp = HEADER.unpack_from(buf, pos)
+        yield rtype, flags, timestamp, bytes(buf[pos + HEADER.size:pos + 2 + length])
+        pos += 2 + length
+    return buf[pos:]
+
+
+def format_record(rtype, flags, timestamp, payload):
+    if rtype == RECORD_FRAME:
+        state = [name for bit, name in ((FLAG_VALID, "valid"), (FLAG_CRC_ERROR, "crc"),
+                                        (FLAG_PARITY_ERROR, "parity")) if flags & bit]
+        (start,) = struct.unpack_from(">I", payload)
+        duration = (timestamp - start) & 0xFFFFFFFF
+        return f"{timestamp:10d} FRAME {payload[4:].hex().upper()} {','.join(state) or 'invalid'} {duration}us"
+    if rtype == RECORD_RAW:
+        return f"{timestamp:10d} RAW   {' '.join(str(c) for c in payload)}"
+    if rtype == RECORD_TX_RESULT:
+        result = "sent" if flags & 0x01 else "rejected"
+        return f"{timestamp:10d} TX    {payload.hex().upper()} {result}"
+    return f"{timestamp:10d} type 0x{rtype:02X} {payload.hex().upper()}"
+
+
+def handle(buf):
+    records = parse_records(buf)
+    while True:
+        try:
+            print(format_record(*next(records)), flush=True)
+        except StopIteration as done:
+            return done.value
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("host", nargs="?", default="127.0.0.1")
+    parser.add_argument("--port", type=int, default=5555)
+    parser.add_argument("--udp", action="store_true", help="UDP instead of TCP")
+    parser.add_argument("--listen", type=int, metavar="PORT", help="UDP: local port the device sends batches to")
+    parser.add_argument("--tx", metavar="HEX", help="send this frame (incl. CRC) after connecting")
+    args = parser.parse_args()
+
+    if args.udp:
+        sock = socket.socket(socket.AF_INET, socket.SOCK_DGRAM)
+        sock.bind(("", args.listen if args.listen is not None else 0))
+        if args.tx:
+            sock.sendto(tx_record(bytes.fromhex(args.tx)), (args.host, args.port))
+        while True:
+            datagram, _ = sock.recvfrom(65535)
+            handle(datagram)  # datagrams hold whole records
+
+    sock = socket.create_connection((args.host, args.port))
+    if args.tx:
+        sock.sendall(tx_record(bytes.fromhex(args.tx)))
+    buf = b""
+    while True:
+        chunk = sock.recv(4096)
+        if not chunk:
+            return 0
+        buf = handle(buf + chunk)
+
+
+if __name__ == "__main__":
+    try:
+        sys.exit(main())
+    except KeyboardInterrupt:
+        pass